@@ -0,0 +1,106 @@
+#version 450
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoord;
+in vec4 finalColor;
+
+out vec4 fragColor;
+
+uniform sampler2D texture1;
+uniform vec3 lightPos;
+uniform vec3 viewPos;
+
+// Materiais no uniform buffer (MAX_MATERIALS igual a MaterialBuffer::MAX_MATERIALS)
+#define MAX_MATERIALS 256
+struct Material {
+    vec4 ka;
+    vec4 kd;
+    vec4 ksShininess;
+};
+layout(std140, binding = 0) uniform Materials {
+    Material materials[MAX_MATERIALS];
+};
+uniform int materialIndex;
+uniform bool useMaterialBlock;
+
+// Caminho antigo, um uniforme por componente
+uniform vec3 ka, kd, ks;
+uniform float shininess;
+
+// Cross-fade entre LODs por pontilhado ordenado 4x4: > 0 desenha essa fração dos pixels, < 0 o
+// complemento (o nível que está saindo); 0 desenha tudo
+uniform float lodFade;
+const float bayer[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0, 3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+
+// Luzes pontuais em clusters (CLUSTER_X/Y/Z iguais a LightClusters::GRID_X/Y/Z): o cluster do fragmento
+// sai do ladrilho de tela e da fatia exponencial de profundidade, e só as luzes da lista dele são somadas
+#define CLUSTER_X 16
+#define CLUSTER_Y 9
+#define CLUSTER_Z 24
+struct PointLight {
+    vec4 positionRadius;
+    vec4 color;
+};
+layout(std430, binding = 2) readonly buffer PointLights { PointLight pointLights[]; };
+layout(std430, binding = 3) readonly buffer ClusterRanges { uvec2 clusterRanges[]; };
+layout(std430, binding = 4) readonly buffer ClusterLightIndices { uint clusterLightIndices[]; };
+uniform mat4 view;
+uniform vec2 clusterTileSize;   // pixels por ladrilho
+uniform vec2 clusterDepth;      // near e GRID_Z / log(far / near)
+
+vec3 pointLighting(vec3 norm, vec3 viewDir, vec3 albedo, vec3 matKd, vec3 matKs, float matShininess) {
+    float depth = -(view * vec4(FragPos, 1.0)).z;
+    ivec3 cell = ivec3(ivec2(gl_FragCoord.xy / clusterTileSize), int(log(max(depth, clusterDepth.x) / clusterDepth.x) * clusterDepth.y));
+    cell = clamp(cell, ivec3(0), ivec3(CLUSTER_X - 1, CLUSTER_Y - 1, CLUSTER_Z - 1));
+    uvec2 range = clusterRanges[(cell.z * CLUSTER_Y + cell.y) * CLUSTER_X + cell.x];
+
+    vec3 result = vec3(0.0);
+    for (uint k = 0u; k < range.y; ++k) {
+        PointLight light = pointLights[clusterLightIndices[range.x + k]];
+        vec3 toLight = light.positionRadius.xyz - FragPos;
+        float dist = length(toLight);
+        float radius = light.positionRadius.w;
+        if (dist >= radius) continue;
+        // Inverso do quadrado com janela suave que zera no raio (sem corte visível na borda do alcance)
+        float window = clamp(1.0 - pow(dist / radius, 4.0), 0.0, 1.0);
+        float attenuation = window * window / (1.0 + dist * dist);
+        vec3 lightDir = toLight / dist;
+        float diff = max(dot(norm, lightDir), 0.0);
+        float spec = pow(max(dot(viewDir, reflect(-lightDir, norm)), 0.0), matShininess);
+        result += light.color.rgb * attenuation * (matKd * diff * albedo + matKs * spec);
+    }
+    return result;
+}
+
+void main() {
+    if (lodFade != 0.0) {
+        ivec2 cell = ivec2(gl_FragCoord.xy) & 3;
+        float threshold = (bayer[cell.y * 4 + cell.x] + 0.5) / 16.0;
+        if ((lodFade > 0.0) == (threshold > abs(lodFade))) discard;
+    }
+
+    vec3 matKa = ka, matKd = kd, matKs = ks;
+    float matShininess = shininess;
+    if (useMaterialBlock) {
+        Material m = materials[materialIndex];
+        matKa = m.ka.xyz;
+        matKd = m.kd.xyz;
+        matKs = m.ksShininess.xyz;
+        matShininess = m.ksShininess.w;
+    }
+
+    vec3 norm = normalize(Normal);
+    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+
+    vec3 albedo = vec3(texture(texture1, TexCoord));
+    vec3 ambient = matKa * albedo;
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = matKd * diff * albedo;
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), matShininess);
+    vec3 specular = matKs * spec;
+
+    vec3 result = ambient + diffuse + specular + pointLighting(norm, viewDir, albedo, matKd, matKs, matShininess);
+    fragColor = vec4(result, 1.0) * finalColor;
+}
@@ -0,0 +1,41 @@
+#version 450
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 color;
+layout(location = 2) in vec2 texCoord;
+layout(location = 3) in vec3 normal;
+layout(location = 4) in mat4 instanceModel;   // grupos instanciados (divisor 1)
+layout(location = 8) in mat3 instanceNormal;
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec4 finalColor;
+out vec2 TexCoord;
+
+uniform mat4 model;
+uniform mat4 view;
+uniform mat4 projection;
+uniform mat3 normalMatrix;
+uniform bool useInstancing;
+
+// Vértices compactados: posição desquantizada por malha, normal no octaedro e sem o atributo de cor
+uniform bool packedVertices;
+uniform vec3 positionOffset;
+uniform vec3 positionScale;
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * vec2(e.x >= 0.0 ? 1.0 : -1.0, e.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
+void main() {
+    mat4 modelMatrix = useInstancing ? instanceModel : model;
+    mat3 normalMat = useInstancing ? instanceNormal : normalMatrix;
+    vec3 localPos = positionOffset + positionScale * position;
+    vec3 localNormal = packedVertices ? octDecode(normal.xy) : normal;
+    FragPos = vec3(modelMatrix * vec4(localPos, 1.0));
+    Normal = normalize(normalMat * localNormal);
+    TexCoord = texCoord;
+    finalColor = packedVertices ? vec4(1.0) : vec4(color, 1.0);
+    gl_Position = projection * view * modelMatrix * vec4(localPos, 1.0);
+}
@@ -0,0 +1,83 @@
+#version 450
+in vec3 FragPos;
+in vec3 Normal;
+in vec2 TexCoord;
+in vec4 finalColor;
+flat in int MaterialIndex;
+flat in int TextureLayer;
+
+out vec4 fragColor;
+
+uniform sampler2DArray textures;
+uniform vec3 lightPos;
+uniform vec3 viewPos;
+uniform int overrideMaterial;   // >= 0 substitui o material do registro (destaque da seleção)
+
+#define MAX_MATERIALS 256
+struct Material {
+    vec4 ka;
+    vec4 kd;
+    vec4 ksShininess;
+};
+layout(std140, binding = 0) uniform Materials {
+    Material materials[MAX_MATERIALS];
+};
+
+// Luzes pontuais em clusters (CLUSTER_X/Y/Z iguais a LightClusters::GRID_X/Y/Z): o cluster do fragmento
+// sai do ladrilho de tela e da fatia exponencial de profundidade, e só as luzes da lista dele são somadas
+#define CLUSTER_X 16
+#define CLUSTER_Y 9
+#define CLUSTER_Z 24
+struct PointLight {
+    vec4 positionRadius;
+    vec4 color;
+};
+layout(std430, binding = 2) readonly buffer PointLights { PointLight pointLights[]; };
+layout(std430, binding = 3) readonly buffer ClusterRanges { uvec2 clusterRanges[]; };
+layout(std430, binding = 4) readonly buffer ClusterLightIndices { uint clusterLightIndices[]; };
+uniform mat4 view;
+uniform vec2 clusterTileSize;   // pixels por ladrilho
+uniform vec2 clusterDepth;      // near e GRID_Z / log(far / near)
+
+vec3 pointLighting(vec3 norm, vec3 viewDir, vec3 albedo, vec3 matKd, vec3 matKs, float matShininess) {
+    float depth = -(view * vec4(FragPos, 1.0)).z;
+    ivec3 cell = ivec3(ivec2(gl_FragCoord.xy / clusterTileSize), int(log(max(depth, clusterDepth.x) / clusterDepth.x) * clusterDepth.y));
+    cell = clamp(cell, ivec3(0), ivec3(CLUSTER_X - 1, CLUSTER_Y - 1, CLUSTER_Z - 1));
+    uvec2 range = clusterRanges[(cell.z * CLUSTER_Y + cell.y) * CLUSTER_X + cell.x];
+
+    vec3 result = vec3(0.0);
+    for (uint k = 0u; k < range.y; ++k) {
+        PointLight light = pointLights[clusterLightIndices[range.x + k]];
+        vec3 toLight = light.positionRadius.xyz - FragPos;
+        float dist = length(toLight);
+        float radius = light.positionRadius.w;
+        if (dist >= radius) continue;
+        // Inverso do quadrado com janela suave que zera no raio (sem corte visível na borda do alcance)
+        float window = clamp(1.0 - pow(dist / radius, 4.0), 0.0, 1.0);
+        float attenuation = window * window / (1.0 + dist * dist);
+        vec3 lightDir = toLight / dist;
+        float diff = max(dot(norm, lightDir), 0.0);
+        float spec = pow(max(dot(viewDir, reflect(-lightDir, norm)), 0.0), matShininess);
+        result += light.color.rgb * attenuation * (matKd * diff * albedo + matKs * spec);
+    }
+    return result;
+}
+
+void main() {
+    Material m = materials[overrideMaterial >= 0 ? overrideMaterial : MaterialIndex];
+    vec3 texColor = vec3(texture(textures, vec3(TexCoord, float(TextureLayer))));
+
+    vec3 norm = normalize(Normal);
+    vec3 lightDir = normalize(lightPos - FragPos);
+    vec3 viewDir = normalize(viewPos - FragPos);
+    vec3 reflectDir = reflect(-lightDir, norm);
+
+    vec3 ambient = m.ka.xyz * texColor;
+    float diff = max(dot(norm, lightDir), 0.0);
+    vec3 diffuse = m.kd.xyz * diff * texColor;
+    float spec = pow(max(dot(viewDir, reflectDir), 0.0), m.ksShininess.w);
+    vec3 specular = m.ksShininess.xyz * spec;
+
+    vec3 result = ambient + diffuse + specular + pointLighting(norm, viewDir, texColor, m.kd.xyz, m.ksShininess.xyz, m.ksShininess.w);
+    fragColor = vec4(result, 1.0) * finalColor;
+}
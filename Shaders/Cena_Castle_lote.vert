@@ -0,0 +1,45 @@
+#version 450
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 color;
+layout(location = 2) in vec2 texCoord;
+layout(location = 3) in vec3 normal;
+layout(location = 4) in uint drawId;      // registro da cópia (baseInstance + instância)
+
+struct DrawRecord {
+    mat4 model;
+    mat3 normalMatrix;
+    int materialIndex;
+    int textureLayer;
+};
+layout(std430, binding = 1) readonly buffer DrawRecords {
+    DrawRecord records[];
+};
+
+out vec3 FragPos;
+out vec3 Normal;
+out vec4 finalColor;
+out vec2 TexCoord;
+flat out int MaterialIndex;
+flat out int TextureLayer;
+
+uniform mat4 view;
+uniform mat4 projection;
+uniform bool packedVertices;   // a desquantização da posição já vem em record.model
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    if (n.z < 0.0) n.xy = (1.0 - abs(n.yx)) * vec2(e.x >= 0.0 ? 1.0 : -1.0, e.y >= 0.0 ? 1.0 : -1.0);
+    return normalize(n);
+}
+
+void main() {
+    DrawRecord record = records[drawId];
+    vec3 localNormal = packedVertices ? octDecode(normal.xy) : normal;
+    FragPos = vec3(record.model * vec4(position, 1.0));
+    Normal = normalize(record.normalMatrix * localNormal);
+    TexCoord = texCoord;
+    finalColor = packedVertices ? vec4(1.0) : vec4(color, 1.0);
+    MaterialIndex = record.materialIndex;
+    TextureLayer = record.textureLayer;
+    gl_Position = projection * view * record.model * vec4(position, 1.0);
+}
@@ -0,0 +1,254 @@
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+// Carregamento paralelo de modelos: as threads de trabalho leem o .obj (ou o cache .meshbin, com os
+// LODs da malha já na ordem de meshopt.h) e carregam a textura (o .ktx2 comprimido); os dois caches são
+// gerados na primeira carga. A thread do OpenGL só recebe os buffers prontos e faz o upload.
+
+#include "mesh.h"
+#include "objparser.h"
+#include "meshcache.h"
+#include "meshbvh.h"
+#include "meshopt.h"
+#include "packedvertex.h"
+#include "profiler.h"
+#include "texturebake.h"
+
+// Mesma guarda usada para o TinyObjLoader: a implementação da stb_image não tem proteção própria
+#ifndef STBI_INCLUDE_STB_IMAGE_H
+#include "stb_image.h"
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Textura de um arquivo de imagem compartilhada entre todos os modelos que a usam: o .ktx2 mapeado
+// (BC1/BC3/BC7 com mipmaps prontos) ou, na primeira carga, o resultado do bake feito na thread de trabalho
+struct DecodedImage {
+    std::string path;
+    std::unique_ptr<TextureAsset> texture;   // nulo se a imagem não pôde ser lida ou se já foi para o TextureCache
+    double decodeMs = 0.0;
+    std::once_flag once;
+
+    DecodedImage() = default;
+    DecodedImage(const DecodedImage&) = delete;
+    DecodedImage& operator=(const DecodedImage&) = delete;
+};
+
+// Tabela de imagens de uma carga: cada caminho é decodificado uma única vez, mesmo com várias threads
+class ImageTable {
+public:
+    std::shared_ptr<DecodedImage> get(const std::string& path) {
+        std::shared_ptr<DecodedImage> image;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto& slot = images[path];
+            if (!slot) {
+                slot = std::make_shared<DecodedImage>();
+                slot->path = path;
+            }
+            image = slot;
+        }
+        // Quem chegar primeiro carrega (ou gera) o .ktx2; as demais threads esperam o resultado.
+        // As imagens saem invertidas: o AssetLoader liga stbi_set_flip_vertically_on_load.
+        std::call_once(image->once, [&image] {
+            auto start = std::chrono::steady_clock::now();
+            auto texture = std::make_unique<TextureAsset>();
+            if (loadTextureAsset(image->path, true, *texture)) image->texture = std::move(texture);
+            image->decodeMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        });
+        return image;
+    }
+
+private:
+    std::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<DecodedImage>> images;
+};
+
+// Resultado do estágio de CPU de um modelo, pronto para ser enviado à GPU
+struct PendingAsset {
+    size_t index = 0;                       // posição do objeto no arquivo de configuração
+    std::string objPath;
+    std::string error;                      // vazio quando o carregamento deu certo
+
+    std::unique_ptr<MeshCacheView> cache;   // malha mapeada do .meshbin (quando válido)
+    MeshData mesh;                          // malha processada do .obj (quando sem cache)
+    MeshMaterial material;
+    MeshLodChain lods;                      // cadeia de LODs (do cache ou gerada junto com ele)
+    PackedVertices packed;                  // vértices no formato compacto (vazio no formato completo; no
+                                            // Packed16 com cache, aponta para o .meshbin)
+    MeshOptReport optimize;                 // ACMR/ATVR antes e depois (do cache: só o atual, em after)
+
+    std::string texPath;                    // vazio quando o material não tem textura difusa
+    std::shared_ptr<DecodedImage> image;
+
+    std::shared_ptr<MeshBVH> pickBvh;       // BVH de triângulos para o ray picking (quando pedida)
+
+    double parseMs = 0.0, optimizeMs = 0.0, lodMs = 0.0, packMs = 0.0, decodeMs = 0.0, bvhMs = 0.0;
+};
+
+inline double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Estágio de CPU: malha (cache ou .obj), vértices compactados, BVH de picking e decodificação da textura;
+// não toca no OpenGL
+inline PendingAsset loadAssetData(size_t index, const std::string& objPath, ImageTable& images, bool pickable = true,
+                                  VertexFormat format = VertexFormat::Full) {
+    PROFILE_SCOPE("loadAssetData");
+    PendingAsset asset;
+    asset.index = index;
+    asset.objPath = objPath;
+
+    auto start = std::chrono::steady_clock::now();
+    std::string cachePath = meshCachePath(objPath);
+    auto cache = std::make_unique<MeshCacheView>();
+    if (cache->open(cachePath, objPath)) {
+        asset.material = cache->material();
+        asset.lods.levels = cache->lods();
+        if (cache->indexType() == GL_UNSIGNED_SHORT)
+            asset.optimize.after = analyzeVertexCache(static_cast<const uint16_t*>(cache->indices()), cache->indexCount(), cache->vertexCount());
+        else
+            asset.optimize.after = analyzeVertexCache(static_cast<const uint32_t*>(cache->indices()), cache->indexCount(), cache->vertexCount());
+        asset.cache = std::move(cache);
+        asset.parseMs = elapsedMs(start);
+    } else {
+        if (!loadObjMesh(objPath, asset.mesh, asset.material, asset.error)) {
+            if (asset.error.empty()) asset.error = "Erro ao carregar " + objPath;
+            return asset;
+        }
+        asset.parseMs = elapsedMs(start);
+
+        // Primeira carga: a ordem dos triângulos e os LODs são gerados aqui e vão para o .meshbin
+        // com a malha (o overdraw só é medido no meshbake, o rasterizador de CPU é caro para a carga)
+        {
+            PROFILE_SCOPE("optimizeMeshOrder");
+            start = std::chrono::steady_clock::now();
+            asset.optimize = optimizeMeshOrder(asset.mesh);
+            asset.optimizeMs = elapsedMs(start);
+        }
+        {
+            PROFILE_SCOPE("buildLodChain");
+            start = std::chrono::steady_clock::now();
+            asset.lods = buildLodChain(asset.mesh);
+            asset.lodMs = elapsedMs(start);
+        }
+        {
+            PROFILE_SCOPE("optimizeMeshLayout");
+            start = std::chrono::steady_clock::now();
+            optimizeMeshLayout(asset.mesh, asset.lods, asset.optimize);
+            asset.optimizeMs += elapsedMs(start);
+        }
+        writeMeshCache(cachePath, objPath, asset.mesh, asset.material, asset.lods);
+    }
+
+    // O .meshbin guarda os vértices completos (a BVH de picking usa as posições exatas) e os de 16 bytes,
+    // que sobem direto do arquivo mapeado. Os outros casos são uma passada linear, feita aqui para não
+    // pesar na thread do OpenGL (no formato completo só conta)
+    {
+        PROFILE_SCOPE("packVertices");
+        start = std::chrono::steady_clock::now();
+        if (asset.cache && format == VertexFormat::Packed16) asset.packed = asset.cache->packedVertices();
+        else if (asset.cache) asset.packed = packVertices(asset.cache->vertices(), asset.cache->vertexCount(), format);
+        else asset.packed = packVertices(asset.mesh.vertices.data(), asset.mesh.vertices.size(), format);
+        asset.packMs = elapsedMs(start);
+    }
+
+    if (pickable) {
+        PROFILE_SCOPE("pickBvh");
+        start = std::chrono::steady_clock::now();
+        asset.pickBvh = std::make_shared<MeshBVH>();
+        if (asset.cache) {
+            asset.pickBvh->build(&asset.cache->vertices()->pos, sizeof(Vertex), asset.cache->indices(),
+                                 asset.cache->indexType() == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t),
+                                 asset.cache->indexCount());
+        } else if (!asset.mesh.vertices.empty()) {
+            asset.pickBvh->build(&asset.mesh.vertices[0].pos, sizeof(Vertex), asset.mesh.indices.data(), sizeof(uint32_t),
+                                 asset.mesh.indices.size());
+        }
+        asset.bvhMs = elapsedMs(start);
+    }
+
+    if (asset.material.present && !asset.material.diffuseTexname.empty()) {
+        PROFILE_SCOPE("decodeTexture");
+        start = std::chrono::steady_clock::now();
+        asset.texPath = (std::filesystem::path(objPath).parent_path() / asset.material.diffuseTexname).lexically_normal().string();
+        asset.image = images.get(asset.texPath);
+        asset.decodeMs = elapsedMs(start);
+    }
+    return asset;
+}
+
+// Pool de threads que processa uma lista de modelos e entrega os resultados em ordem de término
+class AssetLoader {
+public:
+    // pickable[i] pede a BVH de picking do modelo i (vazio: todos); format é o formato dos vértices enviados à GPU
+    explicit AssetLoader(std::vector<std::string> objPaths, std::vector<bool> pickable = {},
+                         VertexFormat format = VertexFormat::Full, unsigned threadCount = 0)
+        : paths(std::move(objPaths)), pickable(std::move(pickable)), format(format) {
+        if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+        threadCount = std::min<unsigned>(threadCount, static_cast<unsigned>(std::max<size_t>(paths.size(), 1)));
+
+        // A flag de inversão da stb_image é global: define antes de iniciar as threads
+        stbi_set_flip_vertically_on_load(true);
+        for (unsigned i = 0; i < threadCount; ++i)
+            workers.emplace_back(&AssetLoader::worker, this);
+    }
+
+    ~AssetLoader() {
+        for (auto& t : workers) t.join();
+    }
+
+    AssetLoader(const AssetLoader&) = delete;
+    AssetLoader& operator=(const AssetLoader&) = delete;
+
+    // Bloqueia até o próximo modelo ficar pronto; false quando todos já foram entregues
+    bool next(PendingAsset& out) {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (delivered == paths.size()) return false;
+        ready.wait(lock, [this] { return !done.empty(); });
+        out = std::move(done.front());
+        done.pop_front();
+        ++delivered;
+        return true;
+    }
+
+    size_t threadCount() const { return workers.size(); }
+
+private:
+    void worker() {
+        for (;;) {
+            size_t job = nextJob.fetch_add(1);
+            if (job >= paths.size()) return;
+            PendingAsset asset = loadAssetData(job, paths[job], images, pickable.empty() || pickable[job], format);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                done.push_back(std::move(asset));
+            }
+            ready.notify_one();
+        }
+    }
+
+    std::vector<std::string> paths;
+    std::vector<bool> pickable;
+    VertexFormat format;
+    std::atomic<size_t> nextJob{ 0 };
+    size_t delivered = 0;
+    std::mutex mutex;
+    std::condition_variable ready;
+    std::deque<PendingAsset> done;
+    ImageTable images;
+    std::vector<std::thread> workers;
+};
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+// Volumes envolventes (AABB e esfera) e teste contra o frustum da câmera.
+// Só depende da GLM: também é usado pelas ferramentas sem janela (cullbench).
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+
+struct AABB {
+    glm::vec3 min = glm::vec3(FLT_MAX);
+    glm::vec3 max = glm::vec3(-FLT_MAX);
+
+    bool valid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+
+    void expand(const glm::vec3& p) {
+        min = glm::min(min, p);
+        max = glm::max(max, p);
+    }
+
+    void expand(const AABB& box) {
+        min = glm::min(min, box.min);
+        max = glm::max(max, box.max);
+    }
+
+    glm::vec3 center() const { return (min + max) * 0.5f; }
+    glm::vec3 halfExtent() const { return (max - min) * 0.5f; }
+
+    float surfaceArea() const {
+        if (!valid()) return 0.0f;
+        glm::vec3 d = max - min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+};
+
+struct BoundingSphere {
+    glm::vec3 center = glm::vec3(0.0f);
+    float radius = 0.0f;
+};
+
+// AABB de um conjunto de posições; stride em bytes permite ler direto de um array de Vertex
+inline AABB computeBounds(const glm::vec3* positions, size_t count, size_t stride = sizeof(glm::vec3)) {
+    AABB box;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(positions);
+    for (size_t i = 0; i < count; ++i, p += stride)
+        box.expand(*reinterpret_cast<const glm::vec3*>(p));
+    return box;
+}
+
+// Esfera centrada na AABB com o raio até o vértice mais distante (mais justa que a esfera da caixa)
+inline BoundingSphere computeSphere(const AABB& box, const glm::vec3* positions, size_t count, size_t stride = sizeof(glm::vec3)) {
+    BoundingSphere sphere;
+    if (!box.valid()) return sphere;
+    sphere.center = box.center();
+    float radius2 = 0.0f;
+    const unsigned char* p = reinterpret_cast<const unsigned char*>(positions);
+    for (size_t i = 0; i < count; ++i, p += stride) {
+        glm::vec3 d = *reinterpret_cast<const glm::vec3*>(p) - sphere.center;
+        radius2 = std::max(radius2, glm::dot(d, d));
+    }
+    sphere.radius = std::sqrt(radius2);
+    return sphere;
+}
+
+// AABB em coordenadas de mundo da caixa transformada (método de Arvo: centro + extensão absoluta)
+inline AABB transformBounds(const AABB& box, const glm::mat4& m) {
+    if (!box.valid()) return box;
+    glm::vec3 center = glm::vec3(m * glm::vec4(box.center(), 1.0f));
+    glm::vec3 half = box.halfExtent();
+    glm::vec3 extent(
+        std::abs(m[0][0]) * half.x + std::abs(m[1][0]) * half.y + std::abs(m[2][0]) * half.z,
+        std::abs(m[0][1]) * half.x + std::abs(m[1][1]) * half.y + std::abs(m[2][1]) * half.z,
+        std::abs(m[0][2]) * half.x + std::abs(m[1][2]) * half.y + std::abs(m[2][2]) * half.z);
+    AABB out;
+    out.min = center - extent;
+    out.max = center + extent;
+    return out;
+}
+
+// Esfera transformada; o raio usa a maior escala entre os eixos
+inline BoundingSphere transformSphere(const BoundingSphere& sphere, const glm::mat4& m) {
+    BoundingSphere out;
+    out.center = glm::vec3(m * glm::vec4(sphere.center, 1.0f));
+    float sx = glm::dot(glm::vec3(m[0]), glm::vec3(m[0]));
+    float sy = glm::dot(glm::vec3(m[1]), glm::vec3(m[1]));
+    float sz = glm::dot(glm::vec3(m[2]), glm::vec3(m[2]));
+    out.radius = sphere.radius * std::sqrt(std::max(sx, std::max(sy, sz)));
+    return out;
+}
+
+enum class CullResult { Outside, Intersecting, Inside };
+
+// Seis planos (ax + by + cz + d >= 0 do lado de dentro) extraídos de projection * view
+struct Frustum {
+    glm::vec4 planes[6];
+
+    static Frustum fromMatrix(const glm::mat4& viewProjection) {
+        Frustum f;
+        const glm::mat4& m = viewProjection;
+        for (int i = 0; i < 3; ++i) {
+            glm::vec4 row(m[0][i], m[1][i], m[2][i], m[3][i]);
+            glm::vec4 w(m[0][3], m[1][3], m[2][3], m[3][3]);
+            f.planes[2 * i] = w + row;
+            f.planes[2 * i + 1] = w - row;
+        }
+        for (auto& plane : f.planes) plane /= glm::length(glm::vec3(plane));
+        return f;
+    }
+
+    // Vértices p/n de cada plano: uma única comparação decide "fora"; a outra, "dentro"
+    CullResult classify(const AABB& box) const {
+        CullResult result = CullResult::Inside;
+        glm::vec3 center = box.center(), half = box.halfExtent();
+        for (const auto& plane : planes) {
+            glm::vec3 n(plane);
+            float distance = glm::dot(n, center) + plane.w;
+            float radius = glm::dot(glm::abs(n), half);
+            if (distance < -radius) return CullResult::Outside;
+            if (distance < radius) result = CullResult::Intersecting;
+        }
+        return result;
+    }
+
+    bool intersects(const AABB& box) const { return classify(box) != CullResult::Outside; }
+
+    bool intersects(const BoundingSphere& sphere) const {
+        for (const auto& plane : planes) {
+            if (glm::dot(glm::vec3(plane), sphere.center) + plane.w < -sphere.radius) return false;
+        }
+        return true;
+    }
+};
+
+#endif
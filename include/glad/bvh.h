@@ -0,0 +1,162 @@
+#ifndef OBJECT_BVH_H
+#define OBJECT_BVH_H
+
+// BVH sobre as AABBs de mundo dos objetos da cena, usada no frustum culling.
+// Objetos que se movem só reajustam as caixas (refit); quando a árvore degrada demais
+// (soma das áreas dos nós muito maior que a do último build) ela é reconstruída.
+
+#include "bounds.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Contadores de uma passada de culling
+struct CullStats {
+    size_t visible = 0;
+    size_t culled = 0;
+    size_t nodesVisited = 0;
+    size_t boundsTests = 0;
+};
+
+class ObjectBVH {
+public:
+    static const uint32_t MAX_LEAF_SIZE = 4;
+
+    // Constrói a árvore dividindo pelo centroide mediano no eixo mais longo
+    void build(const std::vector<AABB>& bounds) {
+        nodes.clear();
+        objects.resize(bounds.size());
+        for (uint32_t i = 0; i < objects.size(); ++i) objects[i] = i;
+        objectCount = bounds.size();
+        if (bounds.empty()) return;
+
+        centroids.resize(bounds.size());
+        for (size_t i = 0; i < bounds.size(); ++i) centroids[i] = bounds[i].center();
+
+        nodes.reserve(2 * bounds.size());
+        nodes.emplace_back();
+        subdivide(0, 0, (uint32_t)bounds.size(), bounds);
+        builtArea = totalArea();
+        ++rebuilds;
+    }
+
+    // Reajusta as caixas de baixo para cima sem mudar a topologia (filhos sempre após o pai)
+    void refit(const std::vector<AABB>& bounds) {
+        for (size_t i = nodes.size(); i-- > 0;) {
+            Node& node = nodes[i];
+            node.bounds = AABB();
+            if (node.count > 0) {
+                for (uint32_t k = 0; k < node.count; ++k) node.bounds.expand(bounds[objects[node.first + k]]);
+            } else {
+                node.bounds.expand(nodes[node.first].bounds);
+                node.bounds.expand(nodes[node.first + 1].bounds);
+            }
+        }
+    }
+
+    // Reajusta e, se a árvore ficou ruim ou o número de objetos mudou, reconstrói
+    void update(const std::vector<AABB>& bounds, float rebuildRatio = 2.0f) {
+        if (bounds.size() != objectCount || nodes.empty()) {
+            build(bounds);
+            return;
+        }
+        refit(bounds);
+        if (totalArea() > rebuildRatio * builtArea) build(bounds);
+    }
+
+    // Índices dos objetos que tocam o frustum; nós inteiramente dentro dispensam testes nos filhos.
+    // A esfera de cada objeto (opcional) descarta antes da AABB nas folhas.
+    void cull(const Frustum& frustum, const std::vector<AABB>& bounds, const std::vector<BoundingSphere>* spheres,
+              std::vector<uint32_t>& visible, CullStats& stats) const {
+        visible.clear();
+        stats = CullStats();
+        if (!nodes.empty()) cullNode(0, frustum, bounds, spheres, visible, stats, false);
+        stats.visible = visible.size();
+        stats.culled = objectCount - visible.size();
+    }
+
+    size_t size() const { return objectCount; }
+    size_t nodeCount() const { return nodes.size(); }
+    size_t rebuildCount() const { return rebuilds; }
+
+private:
+    struct Node {
+        AABB bounds;
+        uint32_t first = 0;   // folha: primeiro objeto em `objects`; interno: filho esquerdo (direito = first + 1)
+        uint32_t count = 0;   // > 0 nas folhas
+    };
+
+    void subdivide(uint32_t nodeIndex, uint32_t first, uint32_t count, const std::vector<AABB>& bounds) {
+        AABB box, centroidBox;
+        for (uint32_t i = first; i < first + count; ++i) {
+            box.expand(bounds[objects[i]]);
+            centroidBox.expand(centroids[objects[i]]);
+        }
+        nodes[nodeIndex].bounds = box;
+
+        glm::vec3 extent = centroidBox.max - centroidBox.min;
+        int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+        if (count <= MAX_LEAF_SIZE || extent[axis] <= 0.0f) {
+            nodes[nodeIndex].first = first;
+            nodes[nodeIndex].count = count;
+            return;
+        }
+
+        uint32_t half = count / 2;
+        std::nth_element(objects.begin() + first, objects.begin() + first + half, objects.begin() + first + count,
+            [&](uint32_t a, uint32_t b) { return centroids[a][axis] < centroids[b][axis]; });
+
+        uint32_t left = (uint32_t)nodes.size();
+        nodes.emplace_back();
+        nodes.emplace_back();
+        nodes[nodeIndex].first = left;
+        nodes[nodeIndex].count = 0;
+        subdivide(left, first, half, bounds);
+        subdivide(left + 1, first + half, count - half, bounds);
+    }
+
+    void cullNode(uint32_t nodeIndex, const Frustum& frustum, const std::vector<AABB>& bounds,
+                  const std::vector<BoundingSphere>* spheres, std::vector<uint32_t>& visible,
+                  CullStats& stats, bool inside) const {
+        const Node& node = nodes[nodeIndex];
+        ++stats.nodesVisited;
+        if (!inside) {
+            ++stats.boundsTests;
+            CullResult result = frustum.classify(node.bounds);
+            if (result == CullResult::Outside) return;
+            inside = result == CullResult::Inside;
+        }
+
+        if (node.count == 0) {
+            cullNode(node.first, frustum, bounds, spheres, visible, stats, inside);
+            cullNode(node.first + 1, frustum, bounds, spheres, visible, stats, inside);
+            return;
+        }
+
+        for (uint32_t k = 0; k < node.count; ++k) {
+            uint32_t object = objects[node.first + k];
+            if (!inside) {
+                ++stats.boundsTests;
+                if (spheres && !frustum.intersects((*spheres)[object])) continue;
+                if (!frustum.intersects(bounds[object])) continue;
+            }
+            visible.push_back(object);
+        }
+    }
+
+    float totalArea() const {
+        float area = 0.0f;
+        for (const auto& node : nodes) area += node.bounds.surfaceArea();
+        return area;
+    }
+
+    std::vector<Node> nodes;
+    std::vector<uint32_t> objects;
+    std::vector<glm::vec3> centroids;   // só usado durante o build
+    size_t objectCount = 0;
+    float builtArea = 0.0f;
+    size_t rebuilds = 0;
+};
+
+#endif
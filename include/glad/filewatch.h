@@ -0,0 +1,139 @@
+#ifndef FILE_WATCH_H
+#define FILE_WATCH_H
+
+// Observa arquivos para a recarga a quente (configuração da cena, trajetórias, shaders, modelos).
+// No Linux usa inotify sobre as pastas dos arquivos: editores que salvam num temporário e renomeiam
+// (vim, VS Code) trocam o inode, e a pasta continua vendo o IN_MOVED_TO. Nos outros sistemas compara
+// a data de modificação e o tamanho de cada arquivo, no máximo a cada POLL_INTERVAL.
+// changes() nunca bloqueia: o laço de renderização chama uma vez por frame.
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <set>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#define FILE_WATCH_INOTIFY 1
+#endif
+
+class FileWatcher {
+public:
+    // Intervalo da varredura sem inotify
+    static constexpr double POLL_INTERVAL = 0.25;
+
+    FileWatcher() {
+#ifdef FILE_WATCH_INOTIFY
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+#endif
+    }
+
+    ~FileWatcher() {
+#ifdef FILE_WATCH_INOTIFY
+        if (fd >= 0) close(fd);
+#endif
+    }
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Passa a observar o arquivo (o caminho é devolvido por changes() exatamente como foi passado aqui);
+    // o arquivo não precisa existir ainda, só a pasta
+    bool watch(const std::string& path) {
+        std::string key = normalize(path);
+        if (files.count(key)) return true;
+        std::string dir = std::filesystem::path(key).parent_path().string();
+#ifdef FILE_WATCH_INOTIFY
+        if (fd >= 0) {
+            int wd = inotify_add_watch(fd, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+            if (wd < 0) return false;
+            directories[wd] = dir;
+        }
+#endif
+        Entry entry;
+        entry.path = path;
+        stamp(key, entry);
+        files.emplace(key, entry);
+        return true;
+    }
+
+    // Arquivos observados que mudaram desde a última chamada, cada um uma única vez
+    std::vector<std::string> changes() {
+        std::set<std::string> changed;
+#ifdef FILE_WATCH_INOTIFY
+        if (fd >= 0) {
+            alignas(inotify_event) char buffer[4096];
+            for (;;) {
+                ssize_t length = read(fd, buffer, sizeof(buffer));
+                if (length <= 0) break;   // EAGAIN: fila vazia
+                for (char* p = buffer; p < buffer + length;) {
+                    const inotify_event* event = reinterpret_cast<const inotify_event*>(p);
+                    p += sizeof(inotify_event) + event->len;
+                    auto dir = directories.find(event->wd);
+                    if (dir == directories.end() || event->len == 0) continue;
+                    auto it = files.find((std::filesystem::path(dir->second) / event->name).string());
+                    if (it != files.end()) changed.insert(it->second.path);
+                }
+            }
+            return std::vector<std::string>(changed.begin(), changed.end());
+        }
+#endif
+        auto now = std::chrono::steady_clock::now();
+        if (std::chrono::duration<double>(now - lastPoll).count() < POLL_INTERVAL) return {};
+        lastPoll = now;
+        for (auto& [key, entry] : files) {
+            Entry current = entry;
+            stamp(key, current);
+            if (current.time != entry.time || current.size != entry.size) {
+                entry = current;
+                if (current.exists) changed.insert(entry.path);
+            }
+        }
+        return std::vector<std::string>(changed.begin(), changed.end());
+    }
+
+    const char* backend() const {
+#ifdef FILE_WATCH_INOTIFY
+        if (fd >= 0) return "inotify";
+#endif
+        return "varredura da data de modificação";
+    }
+
+    size_t size() const { return files.size(); }
+
+private:
+    struct Entry {
+        std::string path;     // como o chamador registrou
+        std::filesystem::file_time_type time;
+        uintmax_t size = 0;
+        bool exists = false;
+    };
+
+    static std::string normalize(const std::string& path) {
+        std::error_code ec;
+        std::filesystem::path absolute = std::filesystem::absolute(path, ec);
+        return (ec ? std::filesystem::path(path) : absolute).lexically_normal().string();
+    }
+
+    static void stamp(const std::string& key, Entry& entry) {
+        std::error_code ec;
+        entry.time = std::filesystem::last_write_time(key, ec);
+        entry.exists = !ec;
+        entry.size = entry.exists ? std::filesystem::file_size(key, ec) : 0;
+    }
+
+    std::unordered_map<std::string, Entry> files;   // chave: caminho absoluto normalizado
+    std::chrono::steady_clock::time_point lastPoll = std::chrono::steady_clock::now();
+#ifdef FILE_WATCH_INOTIFY
+    int fd = -1;
+    std::unordered_map<int, std::string> directories;
+#endif
+};
+
+#endif
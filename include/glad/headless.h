@@ -0,0 +1,289 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+
+// Modo sem janela para benchmarks e testes de imagem em máquinas sem GPU nem display:
+// contexto OpenGL por software (EGL surfaceless ou OSMesa pela plataforma "null" da GLFW 3.4,
+// ou uma janela oculta, que funciona sob Xvfb), desenho em FBO, câmera guiada por arquivo,
+// tempos de CPU/GPU por frame e gravação opcional dos frames em PNG.
+
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+#include <glm/glm.hpp>
+
+#include "mesh.h"
+#include "stb_image_write.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct HeadlessOptions {
+    bool enabled = false;
+    std::string configPath = "../Cenas/config.txt";
+    std::string cameraPath;    // vazio: câmera fixa da configuração
+    std::string outputDir;     // vazio: não grava PNG
+    std::string timingsPath;   // vazio: só o resumo no console
+    std::string context = "egl";
+    std::string tracePrefix = "trace";   // sessões do profiler: <prefixo>_1.json, <prefixo>_2.json...
+    int frames = 300;
+    bool streamTextures = true;   // --no-stream: texturas inteiras na GPU antes do primeiro frame
+    int lodMode = 0;              // --lod: 0 = com cross-fade, 1 = troca direta, 2 = sempre o LOD 0
+    VertexFormat vertexFormat = VertexFormat::Packed16;   // --vertices
+};
+
+inline const char* headlessUsage() {
+    return "Uso: Cena_Castle [--config <arquivo>] [--headless [opções]]\n"
+           "  --headless                 desenha sem janela, em FBO\n"
+           "  --context egl|osmesa|hidden contexto do modo sem janela (padrão: egl)\n"
+           "  --frames <n>               número de frames (padrão: 300)\n"
+           "  --camera-path <arquivo>    pontos de câmera \"x y z yaw pitch\" percorridos ao longo dos frames\n"
+           "  --output <pasta>           grava cada frame como frame_NNNN.png\n"
+           "  --timings <arquivo.csv>    grava os tempos de CPU e GPU de cada frame\n"
+           "  --trace <prefixo>          nome dos traces do profiler (builds de depuração; padrão: trace)\n"
+           "  --no-stream                envia as texturas inteiras no carregamento, sem streaming de mipmaps\n"
+           "  --lod fade|direto|off      troca de nível de detalhe com cross-fade, direta ou desligada (padrão: fade)\n"
+           "  --vertices completo|float|quant16\n"
+           "                             formato dos vértices na GPU: 44 bytes, 20 bytes (posição float) ou\n"
+           "                             16 bytes (posição quantizada em 16 bits; padrão)\n";
+}
+
+// false (com a mensagem em error) quando a linha de comando é inválida
+inline bool parseHeadlessOptions(int argc, char** argv, HeadlessOptions& options, std::string& error) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto value = [&](std::string& out) {
+            if (i + 1 >= argc) {
+                error = "Falta o valor de " + arg;
+                return false;
+            }
+            out = argv[++i];
+            return true;
+        };
+        std::string text;
+        if (arg == "--headless") options.enabled = true;
+        else if (arg == "--no-stream") options.streamTextures = false;
+        else if (arg == "--config") { if (!value(options.configPath)) return false; }
+        else if (arg == "--camera-path") { if (!value(options.cameraPath)) return false; }
+        else if (arg == "--output") { if (!value(options.outputDir)) return false; }
+        else if (arg == "--timings") { if (!value(options.timingsPath)) return false; }
+        else if (arg == "--trace") { if (!value(options.tracePrefix)) return false; }
+        else if (arg == "--lod") {
+            if (!value(text)) return false;
+            if (text == "fade") options.lodMode = 0;
+            else if (text == "direto") options.lodMode = 1;
+            else if (text == "off") options.lodMode = 2;
+            else {
+                error = "Modo de LOD inválido: " + text;
+                return false;
+            }
+        }
+        else if (arg == "--vertices") {
+            if (!value(text)) return false;
+            if (text == "completo") options.vertexFormat = VertexFormat::Full;
+            else if (text == "float") options.vertexFormat = VertexFormat::PackedFloat;
+            else if (text == "quant16") options.vertexFormat = VertexFormat::Packed16;
+            else {
+                error = "Formato de vértice inválido: " + text;
+                return false;
+            }
+        }
+        else if (arg == "--context") {
+            if (!value(options.context)) return false;
+            if (options.context != "egl" && options.context != "osmesa" && options.context != "hidden") {
+                error = "Contexto desconhecido: " + options.context;
+                return false;
+            }
+        }
+        else if (arg == "--frames") {
+            if (!value(text)) return false;
+            options.frames = std::atoi(text.c_str());
+            if (options.frames <= 0) {
+                error = "Número de frames inválido: " + text;
+                return false;
+            }
+        }
+        else {
+            error = "Opção desconhecida: " + arg;
+            return false;
+        }
+    }
+    return true;
+}
+
+// Deve ser chamada antes de glfwInit: EGL e OSMesa usam a plataforma "null" (sem display)
+inline void initHeadlessPlatform(const HeadlessOptions& options) {
+    if (options.context != "hidden") glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+}
+
+// Contexto 4.5 core (o llvmpipe do Mesa suporta) com uma janela que nunca aparece
+inline GLFWwindow* createHeadlessWindow(const HeadlessOptions& options, int width, int height) {
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 5);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    if (options.context == "egl") glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_EGL_CONTEXT_API);
+    else if (options.context == "osmesa") glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+    return glfwCreateWindow(width, height, "Castle Scene (headless)", nullptr, nullptr);
+}
+
+// Framebuffer fora da tela: cor RGBA8 + profundidade, do tamanho da janela normal
+class OffscreenTarget {
+public:
+    bool create(int w, int h) {
+        width = w;
+        height = h;
+        glGenFramebuffers(1, &fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+        glGenRenderbuffers(2, renderbuffers);
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+        glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        glViewport(0, 0, width, height);
+        return complete;
+    }
+
+    // Lê o frame atual já na orientação de imagem (primeira linha em cima)
+    void readPixels(std::vector<unsigned char>& pixels) const {
+        size_t row = static_cast<size_t>(width) * 4;
+        pixels.resize(row * height);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbo);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+        for (int y = 0; y < height / 2; ++y)
+            std::swap_ranges(pixels.begin() + y * row, pixels.begin() + (y + 1) * row, pixels.begin() + (height - 1 - y) * row);
+    }
+
+    bool writePng(const std::string& path) const {
+        std::vector<unsigned char> pixels;
+        readPixels(pixels);
+        return stbi_write_png(path.c_str(), width, height, 4, pixels.data(), width * 4) != 0;
+    }
+
+    void release() {
+        if (fbo) glDeleteFramebuffers(1, &fbo);
+        if (renderbuffers[0]) glDeleteRenderbuffers(2, renderbuffers);
+        fbo = 0;
+        renderbuffers[0] = renderbuffers[1] = 0;
+    }
+
+    int width = 0, height = 0;
+
+private:
+    GLuint fbo = 0;
+    GLuint renderbuffers[2] = { 0, 0 };
+};
+
+// Pontos de câmera de um arquivo de texto (mesmo formato das trajetórias, com yaw e pitch)
+struct CameraKey {
+    glm::vec3 position;
+    float yaw, pitch;
+};
+
+inline bool loadCameraPath(const std::string& path, std::vector<CameraKey>& keys) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+    keys.clear();
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        CameraKey key;
+        std::istringstream in(line);
+        if (in >> key.position.x >> key.position.y >> key.position.z >> key.yaw >> key.pitch)
+            keys.push_back(key);
+    }
+    return !keys.empty();
+}
+
+// Interpolação linear entre os pontos, com t de 0 (primeiro) a 1 (último)
+inline CameraKey sampleCameraPath(const std::vector<CameraKey>& keys, float t) {
+    if (keys.size() == 1) return keys[0];
+    float f = std::min(std::max(t, 0.0f), 1.0f) * (keys.size() - 1);
+    size_t i = std::min(static_cast<size_t>(f), keys.size() - 2);
+    float a = f - i;
+    CameraKey key;
+    key.position = glm::mix(keys[i].position, keys[i + 1].position, a);
+    key.yaw = keys[i].yaw + (keys[i + 1].yaw - keys[i].yaw) * a;
+    key.pitch = keys[i].pitch + (keys[i + 1].pitch - keys[i].pitch) * a;
+    return key;
+}
+
+// Tempo de CPU (parede, com glFinish no fim do frame) e de GPU (GL_TIME_ELAPSED) de cada frame.
+// As consultas de GPU ficam em um anel para não esperar o resultado do próprio frame.
+class FrameTimings {
+public:
+    static const int QUERY_RING = 4;
+
+    void beginFrame() {
+        if (!queries[0]) glGenQueries(QUERY_RING, queries);
+        size_t frame = cpuMs.size();
+        if (frame >= QUERY_RING) collect(frame - QUERY_RING);
+        glBeginQuery(GL_TIME_ELAPSED, queries[frame % QUERY_RING]);
+        start = glfwGetTime();
+    }
+
+    void endFrame() {
+        glEndQuery(GL_TIME_ELAPSED);
+        glFinish();
+        cpuMs.push_back((glfwGetTime() - start) * 1000.0);
+        gpuMs.push_back(0.0);
+    }
+
+    // Recolhe as consultas pendentes; chamar depois do último frame
+    void finish() {
+        size_t frames = cpuMs.size();
+        for (size_t f = frames > QUERY_RING ? frames - QUERY_RING : 0; f < frames; ++f) collect(f);
+    }
+
+    void report(std::ostream& out) const {
+        out << "Frames: " << cpuMs.size() << "\n";
+        summary(out, "CPU", cpuMs);
+        summary(out, "GPU", gpuMs);
+    }
+
+    bool writeCsv(const std::string& path) const {
+        std::ofstream file(path);
+        if (!file.is_open()) return false;
+        file << "frame,cpu_ms,gpu_ms\n";
+        for (size_t i = 0; i < cpuMs.size(); ++i) file << i << "," << cpuMs[i] << "," << gpuMs[i] << "\n";
+        return true;
+    }
+
+    void release() {
+        if (queries[0]) glDeleteQueries(QUERY_RING, queries);
+        queries[0] = 0;
+    }
+
+private:
+    void collect(size_t frame) {
+        GLuint64 ns = 0;
+        glGetQueryObjectui64v(queries[frame % QUERY_RING], GL_QUERY_RESULT, &ns);
+        gpuMs[frame] = ns / 1.0e6;
+    }
+
+    static void summary(std::ostream& out, const char* name, std::vector<double> ms) {
+        if (ms.empty()) return;
+        double total = 0.0;
+        for (double v : ms) total += v;
+        std::sort(ms.begin(), ms.end());
+        auto percentile = [&ms](double p) { return ms[std::min(ms.size() - 1, static_cast<size_t>(p * ms.size()))]; };
+        out << "  " << name << ": média " << total / ms.size() << " ms, p50 " << percentile(0.50)
+            << " ms, p95 " << percentile(0.95) << " ms, p99 " << percentile(0.99) << " ms, máx " << ms.back() << " ms\n";
+    }
+
+    GLuint queries[QUERY_RING] = {};
+    double start = 0.0;
+    std::vector<double> cpuMs, gpuMs;
+};
+
+#endif
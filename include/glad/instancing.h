@@ -0,0 +1,139 @@
+#ifndef INSTANCING_H
+#define INSTANCING_H
+
+// Desenho instanciado: as transformações de todas as cópias de uma malha ficam em um VBO
+// de instâncias (divisor 1) e a malha é desenhada com uma única chamada glDraw*Instanced.
+//
+// Atributos correspondentes no vertex shader:
+//   layout(location = 4) in mat4 instanceModel;    // locations 4..7
+//   layout(location = 8) in mat3 instanceNormal;   // locations 8..10 (opcional)
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+const GLuint INSTANCE_MODEL_LOCATION = 4;
+const GLuint INSTANCE_NORMAL_LOCATION = 8;
+
+// Transformação de uma instância com a matriz normal já calculada (100 bytes)
+struct InstanceTransform {
+    glm::mat4 model;
+    glm::mat3 normal;
+};
+
+inline glm::mat3 normalMatrixOf(const glm::mat4& model) {
+    return glm::transpose(glm::inverse(glm::mat3(model)));
+}
+
+class InstanceBuffer {
+public:
+    InstanceBuffer() = default;
+    InstanceBuffer(const InstanceBuffer&) = delete;
+    InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+    InstanceBuffer(InstanceBuffer&& other) noexcept { *this = std::move(other); }
+    InstanceBuffer& operator=(InstanceBuffer&& other) noexcept {
+        if (this != &other) {
+            release();
+            vbo = other.vbo;
+            capacity = other.capacity;
+            instanceCount = other.instanceCount;
+            withNormals = other.withNormals;
+            staging = std::move(other.staging);
+            other.vbo = 0;
+            other.capacity = other.instanceCount = 0;
+        }
+        return *this;
+    }
+
+    ~InstanceBuffer() { release(); }
+
+    // Cria o VBO e liga os atributos de instância ao VAO da malha.
+    // normals = false para shaders sem iluminação (só a matriz modelo é enviada).
+    void attach(GLuint vao, bool normals = true) {
+        withNormals = normals;
+        if (vbo == 0) glGenBuffers(1, &vbo);
+        glBindVertexArray(vao);
+        pointAttributes(0);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    // Faz a instância 0 do próximo draw ler a cópia `first` do buffer (sem glDraw*BaseInstance, que é
+    // do OpenGL 4.2). O VAO da malha precisa estar ligado; o GL_ARRAY_BUFFER fica com o VBO de instâncias.
+    void setFirstInstance(size_t first) {
+        pointAttributes(first);
+    }
+
+    // Envia as matrizes modelo (e as normais, quando ligadas); só realoca quando a capacidade cresce
+    void update(const std::vector<glm::mat4>& models) {
+        instanceCount = models.size();
+        if (instanceCount == 0) return;
+
+        const void* data = models.data();
+        size_t bytes = sizeof(glm::mat4) * instanceCount;
+        if (withNormals) {
+            staging.resize(instanceCount);
+            for (size_t i = 0; i < instanceCount; ++i) {
+                staging[i].model = models[i];
+                staging[i].normal = normalMatrixOf(models[i]);
+            }
+            data = staging.data();
+            bytes = sizeof(InstanceTransform) * instanceCount;
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        if (bytes > capacity) {
+            glBufferData(GL_ARRAY_BUFFER, bytes, data, GL_DYNAMIC_DRAW);
+            capacity = bytes;
+        } else {
+            // Orfana o armazenamento anterior para não esperar o frame que ainda o lê
+            glBufferData(GL_ARRAY_BUFFER, capacity, nullptr, GL_DYNAMIC_DRAW);
+            glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, data);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    size_t count() const { return instanceCount; }
+
+    // Libera o VBO; chamar antes de destruir o contexto OpenGL
+    void release() {
+        if (vbo) glDeleteBuffers(1, &vbo);
+        vbo = 0;
+        capacity = instanceCount = 0;
+    }
+
+private:
+    void pointAttributes(size_t first) {
+        GLsizei stride = static_cast<GLsizei>(withNormals ? sizeof(InstanceTransform) : sizeof(glm::mat4));
+        size_t base = first * stride;
+        glBindBuffer(GL_ARRAY_BUFFER, vbo);
+        for (GLuint col = 0; col < 4; ++col) {
+            GLuint location = INSTANCE_MODEL_LOCATION + col;
+            glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, stride,
+                (void*)(base + offsetof(InstanceTransform, model) + sizeof(glm::vec4) * col));
+            glEnableVertexAttribArray(location);
+            glVertexAttribDivisor(location, 1);
+        }
+        if (withNormals) {
+            for (GLuint col = 0; col < 3; ++col) {
+                GLuint location = INSTANCE_NORMAL_LOCATION + col;
+                glVertexAttribPointer(location, 3, GL_FLOAT, GL_FALSE, stride,
+                    (void*)(base + offsetof(InstanceTransform, normal) + sizeof(glm::vec3) * col));
+                glEnableVertexAttribArray(location);
+                glVertexAttribDivisor(location, 1);
+            }
+        }
+    }
+
+    GLuint vbo = 0;
+    size_t capacity = 0;
+    size_t instanceCount = 0;
+    bool withNormals = true;
+    std::vector<InstanceTransform> staging;
+};
+
+#endif
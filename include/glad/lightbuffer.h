@@ -0,0 +1,92 @@
+#ifndef LIGHT_BUFFER_H
+#define LIGHT_BUFFER_H
+
+// SSBOs do clustered forward shading: as luzes pontuais (só mudam com a cena), e a cada frame o intervalo
+// de cada cluster e a lista concatenada de índices de luz que LightClusters montou.
+//
+// Blocos correspondentes nos fragment shaders:
+//   struct PointLight { vec4 positionRadius; vec4 color; };
+//   layout(std430, binding = 2) readonly buffer PointLights { PointLight pointLights[]; };
+//   layout(std430, binding = 3) readonly buffer ClusterRanges { uvec2 clusterRanges[]; };
+//   layout(std430, binding = 4) readonly buffer ClusterLightIndices { uint clusterLightIndices[]; };
+
+#include "lightclusters.h"
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <vector>
+
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+
+const GLuint POINT_LIGHT_BINDING = 2;
+const GLuint CLUSTER_RANGE_BINDING = 3;
+const GLuint CLUSTER_INDEX_BINDING = 4;
+
+class LightBuffer {
+public:
+    LightBuffer() = default;
+    LightBuffer(const LightBuffer&) = delete;
+    LightBuffer& operator=(const LightBuffer&) = delete;
+    ~LightBuffer() { release(); }
+
+    // Troca as luzes da cena; a próxima uploadClusters envia as listas mesmo que fiquem vazias
+    void setLights(const std::vector<PointLight>& lights) {
+        create();
+        lightCount = lights.size();
+        // Buffer vazio não pode ser ligado: sem luzes fica uma luz nula que nenhum cluster referencia
+        PointLight none = { glm::vec4(0.0f), glm::vec4(0.0f) };
+        upload(buffers[0], lights.empty() ? &none : lights.data(), sizeof(PointLight) * std::max<size_t>(lights.size(), 1));
+        clustersValid = false;
+    }
+
+    // Listas deste frame; com a cena sem luzes só a primeira chamada depois de setLights envia algo
+    void uploadClusters(const LightClusters& clusters) {
+        if (clustersValid && lightCount == 0) return;
+        const std::vector<glm::uvec2>& ranges = clusters.clusterRanges();
+        const std::vector<uint32_t>& indices = clusters.indices();
+        uint32_t none = 0;
+        upload(buffers[1], ranges.data(), sizeof(glm::uvec2) * ranges.size());
+        upload(buffers[2], indices.empty() ? &none : indices.data(), sizeof(uint32_t) * std::max<size_t>(indices.size(), 1));
+        indexCount = indices.size();
+        clustersValid = true;
+    }
+
+    size_t lights() const { return lightCount; }
+    size_t listEntries() const { return indexCount; }
+
+    void release() {
+        if (buffers[0] != 0) glDeleteBuffers(3, buffers);
+        buffers[0] = buffers[1] = buffers[2] = 0;
+        lightCount = indexCount = 0;
+        clustersValid = false;
+    }
+
+private:
+    void create() {
+        if (buffers[0] != 0) return;
+        glGenBuffers(3, buffers);
+        const GLuint bindings[3] = { POINT_LIGHT_BINDING, CLUSTER_RANGE_BINDING, CLUSTER_INDEX_BINDING };
+        for (int i = 0; i < 3; ++i) {
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffers[i]);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, 16, nullptr, GL_DYNAMIC_DRAW);
+            glBindBufferBase(GL_SHADER_STORAGE_BUFFER, bindings[i], buffers[i]);
+        }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    // Realoca a cada envio (orphaning): o driver entrega memória nova em vez de esperar os draws do frame anterior
+    static void upload(GLuint buffer, const void* data, size_t bytes) {
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, (GLsizeiptr)bytes, data, GL_STREAM_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    GLuint buffers[3] = { 0, 0, 0 };
+    size_t lightCount = 0, indexCount = 0;
+    bool clustersValid = false;
+};
+
+#endif
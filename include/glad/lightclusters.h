@@ -0,0 +1,289 @@
+#ifndef LIGHT_CLUSTERS_H
+#define LIGHT_CLUSTERS_H
+
+// Clustered forward shading: o frustum da câmera é dividido em GRID_X x GRID_Y ladrilhos de tela e GRID_Z
+// fatias de profundidade exponenciais (fatia k cobre near·(far/near)^(k/Z) até a seguinte), e cada cluster
+// recebe a lista das luzes pontuais cuja esfera de alcance toca sua caixa em espaço de visão. O fragment
+// shader acha o seu cluster por gl_FragCoord e pela profundidade e só percorre essa lista.
+//
+// A atribuição roda na CPU: as esferas vão para o espaço de visão e ganham um intervalo conservador de
+// ladrilhos e fatias na thread de quem chama; depois as fatias são divididas entre um pool de threads, e
+// cada uma testa esfera x caixa nos clusters das suas fatias. As listas saem contíguas, na ordem dos
+// clusters (índice (z·GRID_Y + y)·GRID_X + x) e, dentro de cada cluster, na ordem das luzes.
+// Não depende de OpenGL; lightbuffer.h envia o resultado em SSBOs.
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Luz pontual no layout std430 do shader: dois vec4
+struct PointLight {
+    glm::vec4 positionRadius;   // posição de mundo e alcance
+    glm::vec4 color;            // cor já multiplicada pela intensidade; w livre
+};
+
+class LightClusters {
+public:
+    // Devem coincidir com CLUSTER_X/Y/Z nos fragment shaders
+    static const int GRID_X = 16, GRID_Y = 9, GRID_Z = 24;
+    static const int CLUSTER_COUNT = GRID_X * GRID_Y * GRID_Z;
+
+    // threadCount: partes em que as fatias são divididas, contando a thread de quem chama (0: até 4)
+    explicit LightClusters(unsigned threadCount = 0) {
+        if (threadCount == 0) threadCount = std::min(4u, std::max(1u, std::thread::hardware_concurrency()));
+        parts.resize(std::min<unsigned>(threadCount, GRID_Z));
+        ranges.assign(CLUSTER_COUNT, glm::uvec2(0));
+        for (unsigned p = 1; p < parts.size(); ++p)
+            workers.emplace_back(&LightClusters::worker, this, p);
+    }
+
+    ~LightClusters() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            quit = true;
+        }
+        wake.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    LightClusters(const LightClusters&) = delete;
+    LightClusters& operator=(const LightClusters&) = delete;
+
+    // Fatia de profundidade: floor(log(d / near) · scale); o shader recebe (near, scale)
+    static glm::vec2 depthParams(float zNear, float zFar) {
+        return glm::vec2(zNear, GRID_Z / std::log(zFar / zNear));
+    }
+
+    // Caixas dos clusters em espaço de visão; só são refeitas quando a projeção muda
+    void setProjection(float fovY, float aspect, float zNear, float zFar) {
+        if (fovY == projFovY && aspect == projAspect && zNear == projNear && zFar == projFar) return;
+        projFovY = fovY;
+        projAspect = aspect;
+        projNear = zNear;
+        projFar = zFar;
+        tanY = std::tan(0.5f * fovY);
+        tanX = tanY * aspect;
+        sliceScale = depthParams(zNear, zFar).y;
+
+        for (int z = 0; z <= GRID_Z; ++z) sliceDepths[z] = projNear * std::pow(projFar / projNear, (float)z / GRID_Z);
+        boxMin.resize(CLUSTER_COUNT);
+        boxMax.resize(CLUSTER_COUNT);
+        for (int z = 0; z < GRID_Z; ++z) {
+            float d0 = sliceDepths[z], d1 = sliceDepths[z + 1];
+            for (int y = 0; y < GRID_Y; ++y) {
+                float y0 = -1.0f + 2.0f * y / GRID_Y, y1 = -1.0f + 2.0f * (y + 1) / GRID_Y;
+                for (int x = 0; x < GRID_X; ++x) {
+                    float x0 = -1.0f + 2.0f * x / GRID_X, x1 = -1.0f + 2.0f * (x + 1) / GRID_X;
+                    // Tronco de pirâmide do cluster: os extremos em x e y estão nas faces near e far da fatia
+                    int c = index(x, y, z);
+                    boxMin[c] = glm::vec3(std::min(x0 * d0, x0 * d1) * tanX, std::min(y0 * d0, y0 * d1) * tanY, -d1);
+                    boxMax[c] = glm::vec3(std::max(x1 * d0, x1 * d1) * tanX, std::max(y1 * d0, y1 * d1) * tanY, -d0);
+                }
+            }
+        }
+    }
+
+    // Refaz as listas para as luzes e a câmera deste frame (setProjection antes)
+    void assign(const std::vector<PointLight>& lights, const glm::mat4& view) {
+        bounds.clear();
+        for (uint32_t i = 0; i < lights.size(); ++i) {
+            LightBounds b;
+            if (lightBounds(lights[i], view, i, b)) bounds.push_back(b);
+        }
+
+        if (bounds.empty()) {
+            std::fill(ranges.begin(), ranges.end(), glm::uvec2(0));
+            lightIndices.clear();
+            return;
+        }
+
+        // Fatias repartidas entre as partes; a parte 0 roda aqui, as outras no pool
+        if (!workers.empty()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                ++generation;
+                pending = (unsigned)workers.size();
+            }
+            wake.notify_all();
+        }
+        assignPart(0);
+        if (!workers.empty()) {
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [this] { return pending == 0; });
+        }
+
+        // Junta as listas das partes, que cobrem faixas contíguas de clusters
+        lightIndices.clear();
+        for (const Part& part : parts) {
+            uint32_t base = (uint32_t)lightIndices.size();
+            for (int c = part.firstCluster; c < part.endCluster; ++c)
+                ranges[c] = glm::uvec2(base + part.offsets[c - part.firstCluster], part.counts[c - part.firstCluster]);
+            lightIndices.insert(lightIndices.end(), part.indices.begin(), part.indices.end());
+        }
+    }
+
+    // Por cluster: início em indices() e quantidade de luzes
+    const std::vector<glm::uvec2>& clusterRanges() const { return ranges; }
+    const std::vector<uint32_t>& indices() const { return lightIndices; }
+    size_t visibleLights() const { return bounds.size(); }
+    size_t threadCount() const { return parts.size(); }
+
+    size_t maxLightsPerCluster() const {
+        uint32_t most = 0;
+        for (const glm::uvec2& range : ranges) most = std::max(most, range.y);
+        return most;
+    }
+
+    // Cluster de um ponto em espaço de visão (mesma conta do shader); -1 fora do frustum
+    int clusterOf(const glm::vec3& viewPosition) const {
+        float d = -viewPosition.z;
+        if (d <= 0.0f) return -1;
+        float ndcX = viewPosition.x / (d * tanX), ndcY = viewPosition.y / (d * tanY);
+        if (std::abs(ndcX) > 1.0f || std::abs(ndcY) > 1.0f || d < projNear || d > projFar) return -1;
+        return index(tileX(ndcX), tileY(ndcY), slice(d));
+    }
+
+    static int index(int x, int y, int z) { return (z * GRID_Y + y) * GRID_X + x; }
+
+private:
+    // Esfera em espaço de visão com o intervalo de ladrilhos e fatias que ela pode tocar
+    struct LightBounds {
+        glm::vec3 center;
+        float radius;
+        uint32_t light;
+        int x0, x1, y0, y1, z0, z1;
+    };
+
+    // Clusters de uma faixa de fatias: pares (cluster, luz) ordenados por cluster com contagem
+    struct Part {
+        int firstCluster = 0, endCluster = 0;
+        std::vector<uint32_t> counts, offsets, fill, indices;
+        std::vector<std::pair<uint32_t, uint32_t>> pairs;
+    };
+
+    int slice(float d) const { return std::min(GRID_Z - 1, std::max(0, (int)(std::log(d / projNear) * sliceScale))); }
+    static int tileX(float ndc) { return std::min(GRID_X - 1, std::max(0, (int)((ndc + 1.0f) * 0.5f * GRID_X))); }
+    static int tileY(float ndc) { return std::min(GRID_Y - 1, std::max(0, (int)((ndc + 1.0f) * 0.5f * GRID_Y))); }
+
+    bool lightBounds(const PointLight& light, const glm::mat4& view, uint32_t i, LightBounds& b) const {
+        glm::vec3 c = glm::vec3(view * glm::vec4(glm::vec3(light.positionRadius), 1.0f));
+        float r = light.positionRadius.w;
+        float dMin = -c.z - r, dMax = -c.z + r;
+        if (r <= 0.0f || dMax < projNear || dMin > projFar) return false;
+        b.center = c;
+        b.radius = r;
+        b.light = i;
+        b.z0 = dMin <= projNear ? 0 : slice(dMin);
+        b.z1 = slice(std::min(dMax, projFar));
+        return tileRect(c, r, dMin, dMax, b);
+    }
+
+    // Ladrilhos que a parte da esfera com profundidade em [dLo, dHi] pode tocar: a caixa dessa parte
+    // (raio da seção transversal mais larga dentro do intervalo) projetada com o menor e o maior x/d e
+    // y/d tomados na profundidade que os torna extremos. Cruzando o plano do olho: todos os ladrilhos.
+    bool tileRect(const glm::vec3& c, float r, float dLo, float dHi, LightBounds& b) const {
+        float gap = std::max(0.0f, std::max(dLo - -c.z, -c.z - dHi));
+        float rr = std::sqrt(std::max(0.0f, r * r - gap * gap));
+        if (dLo <= 0.0f) {
+            b.x0 = b.y0 = 0;
+            b.x1 = GRID_X - 1;
+            b.y1 = GRID_Y - 1;
+            return true;
+        }
+        float left = c.x - rr, right = c.x + rr, bottom = c.y - rr, top = c.y + rr;
+        float minX = left / ((left < 0.0f ? dLo : dHi) * tanX), maxX = right / ((right > 0.0f ? dLo : dHi) * tanX);
+        float minY = bottom / ((bottom < 0.0f ? dLo : dHi) * tanY), maxY = top / ((top > 0.0f ? dLo : dHi) * tanY);
+        if (minX > 1.0f || maxX < -1.0f || minY > 1.0f || maxY < -1.0f) return false;
+        b.x0 = tileX(minX);
+        b.x1 = tileX(maxX);
+        b.y0 = tileY(minY);
+        b.y1 = tileY(maxY);
+        return true;
+    }
+
+    void assignPart(unsigned p) {
+        Part& part = parts[p];
+        int z0 = (int)(p * GRID_Z / parts.size()), z1 = (int)((p + 1) * GRID_Z / parts.size());
+        part.firstCluster = index(0, 0, z0);
+        part.endCluster = index(0, 0, z1);
+        part.pairs.clear();
+        for (const LightBounds& b : bounds) {
+            int zFrom = std::max(b.z0, z0), zTo = std::min(b.z1, z1 - 1);
+            float r2 = b.radius * b.radius;
+            for (int z = zFrom; z <= zTo; ++z) {
+                // Em cada fatia só a seção da esfera dentro dela conta: retângulo bem menor nas pontas
+                LightBounds rect = b;
+                float dLo = std::max(sliceDepths[z], -b.center.z - b.radius), dHi = std::min(sliceDepths[z + 1], -b.center.z + b.radius);
+                if (!tileRect(b.center, b.radius, dLo, dHi, rect)) continue;
+                rect.x0 = std::max(rect.x0, b.x0);
+                rect.x1 = std::min(rect.x1, b.x1);
+                rect.y0 = std::max(rect.y0, b.y0);
+                rect.y1 = std::min(rect.y1, b.y1);
+                for (int y = rect.y0; y <= rect.y1; ++y)
+                    for (int x = rect.x0; x <= rect.x1; ++x) {
+                        int c = index(x, y, z);
+                        glm::vec3 nearest = glm::clamp(b.center, boxMin[c], boxMax[c]);
+                        glm::vec3 delta = nearest - b.center;
+                        if (glm::dot(delta, delta) <= r2) part.pairs.emplace_back((uint32_t)(c - part.firstCluster), b.light);
+                    }
+            }
+        }
+
+        // Ordenação por contagem: as luzes de cada cluster continuam na ordem em que foram testadas
+        size_t clusterCount = part.endCluster - part.firstCluster;
+        part.counts.assign(clusterCount, 0);
+        part.offsets.resize(clusterCount);
+        for (const auto& pair : part.pairs) ++part.counts[pair.first];
+        uint32_t offset = 0;
+        for (size_t c = 0; c < clusterCount; ++c) {
+            part.offsets[c] = offset;
+            offset += part.counts[c];
+        }
+        part.indices.resize(part.pairs.size());
+        part.fill.assign(part.offsets.begin(), part.offsets.end());
+        for (const auto& pair : part.pairs) part.indices[part.fill[pair.first]++] = pair.second;
+    }
+
+    void worker(unsigned p) {
+        uint64_t seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [&] { return quit || generation != seen; });
+                if (quit) return;
+                seen = generation;
+            }
+            assignPart(p);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--pending == 0) finished.notify_one();
+            }
+        }
+    }
+
+    float projFovY = 0.0f, projAspect = 0.0f, projNear = 0.0f, projFar = 0.0f;
+    float tanX = 1.0f, tanY = 1.0f, sliceScale = 1.0f;
+    float sliceDepths[GRID_Z + 1] = {};
+    std::vector<glm::vec3> boxMin, boxMax;
+
+    std::vector<LightBounds> bounds;
+    std::vector<Part> parts;
+    std::vector<glm::uvec2> ranges;
+    std::vector<uint32_t> lightIndices;
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake, finished;
+    uint64_t generation = 0;
+    unsigned pending = 0;
+    bool quit = false;
+};
+
+#endif
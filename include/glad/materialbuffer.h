@@ -0,0 +1,96 @@
+#ifndef MATERIAL_BUFFER_H
+#define MATERIAL_BUFFER_H
+
+// Materiais Phong em um uniform buffer (layout std140). Cada draw escolhe seu material
+// por um único índice inteiro, em vez de reenviar ka/kd/ks/shininess.
+//
+// Bloco correspondente no shader:
+//   struct Material { vec4 ka; vec4 kd; vec4 ksShininess; };
+//   layout(std140, binding = 0) uniform Materials { Material materials[MAX_MATERIALS]; };
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include <iostream>
+#include <vector>
+
+// Um material no layout std140: três vec4 (48 bytes), shininess no w do especular
+struct MaterialStd140 {
+    glm::vec4 ka;
+    glm::vec4 kd;
+    glm::vec4 ksShininess;
+};
+
+class MaterialBuffer {
+public:
+    // Deve coincidir com MAX_MATERIALS no shader (256 * 48 bytes cabe no mínimo de 16 KB de um UBO)
+    static const int MAX_MATERIALS = 256;
+
+    // Índice 0: material neutro (os padrões dos exercícios), usado também quando a tabela enche
+    static const int DEFAULT_MATERIAL = 0;
+
+    MaterialBuffer() { clear(); }
+
+    // Esvazia a tabela, que volta a ter só o material padrão (recarga da cena: os índices são refeitos)
+    void clear() {
+        materials.clear();
+        dirty = true;
+        add(glm::vec3(0.2f), glm::vec3(0.8f), glm::vec3(1.0f), 32.0f);
+    }
+
+    // Registra um material e devolve seu índice; materiais idênticos compartilham o mesmo índice
+    int add(const glm::vec3& ka, const glm::vec3& kd, const glm::vec3& ks, float shininess) {
+        MaterialStd140 m;
+        m.ka = glm::vec4(ka, 0.0f);
+        m.kd = glm::vec4(kd, 0.0f);
+        m.ksShininess = glm::vec4(ks, shininess);
+        for (size_t i = 0; i < materials.size(); ++i) {
+            if (sameMaterial(materials[i], m)) return (int)i;
+        }
+        if ((int)materials.size() >= MAX_MATERIALS) {
+            std::cerr << "Aviso: limite de " << MAX_MATERIALS << " materiais atingido, usando o material padrão\n";
+            return DEFAULT_MATERIAL;
+        }
+        materials.push_back(m);
+        dirty = true;
+        return (int)materials.size() - 1;
+    }
+
+    // Cria/atualiza o UBO e o associa ao binding point do bloco
+    void upload(GLuint binding) {
+        if (ubo == 0) {
+            glGenBuffers(1, &ubo);
+            glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+            glBufferData(GL_UNIFORM_BUFFER, sizeof(MaterialStd140) * MAX_MATERIALS, nullptr, GL_DYNAMIC_DRAW);
+            dirty = true;
+        }
+        glBindBuffer(GL_UNIFORM_BUFFER, ubo);
+        if (dirty && !materials.empty())
+            glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(MaterialStd140) * materials.size(), materials.data());
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        glBindBufferBase(GL_UNIFORM_BUFFER, binding, ubo);
+        dirty = false;
+    }
+
+    size_t size() const { return materials.size(); }
+    const MaterialStd140& operator[](size_t i) const { return materials[i]; }
+
+    // Libera o UBO; chamar antes de destruir o contexto OpenGL
+    void release() {
+        if (ubo) glDeleteBuffers(1, &ubo);
+        ubo = 0;
+    }
+
+    ~MaterialBuffer() { release(); }
+
+private:
+    static bool sameMaterial(const MaterialStd140& a, const MaterialStd140& b) {
+        return a.ka == b.ka && a.kd == b.kd && a.ksShininess == b.ksShininess;
+    }
+
+    std::vector<MaterialStd140> materials;
+    GLuint ubo = 0;
+    bool dirty = false;
+};
+
+#endif
@@ -0,0 +1,272 @@
+#ifndef MESH_H
+#define MESH_H
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+// A seção de implementação do TinyObjLoader não tem guarda própria: só inclui o
+// cabeçalho se o .cpp ainda não o incluiu (com TINYOBJLOADER_IMPLEMENTATION)
+#ifndef TINY_OBJ_LOADER_H_
+#include "tiny_obj_loader.h"
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Vértice usado pelos exercícios que carregam .obj (44 bytes)
+struct Vertex {
+    glm::vec3 pos, color, normal;
+    glm::vec2 tex;
+};
+
+// Vértices compactados (packedvertex.h converte a partir de Vertex): normal octaédrica em snorm16,
+// uv em half float e sem a cor, que nos .obj é sempre branca
+struct PackedVertexFloat {
+    float pos[3];
+    int16_t normal[2];
+    uint16_t tex[2];
+};                              // 20 bytes
+
+struct PackedVertex16 {
+    uint16_t pos[4];            // unorm16 dentro da caixa da malha (o quarto é preenchimento)
+    int16_t normal[2];
+    uint16_t tex[2];
+};                              // 16 bytes
+
+// Formato dos vértices no VBO
+enum class VertexFormat { Full, PackedFloat, Packed16 };
+
+inline size_t vertexStride(VertexFormat format) {
+    switch (format) {
+    case VertexFormat::PackedFloat: return sizeof(PackedVertexFloat);
+    case VertexFormat::Packed16: return sizeof(PackedVertex16);
+    default: return sizeof(Vertex);
+    }
+}
+
+// Malha indexada: cada combinação única (posição, normal, uv) aparece uma única vez em vertices
+struct MeshData {
+    std::vector<Vertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+// Chave de deduplicação: a tripla de índices do OBJ identifica o vértice sem comparar floats
+struct ObjIndexKey {
+    int v, n, t;
+    bool operator==(const ObjIndexKey& o) const { return v == o.v && n == o.n && t == o.t; }
+};
+
+struct ObjIndexKeyHash {
+    size_t operator()(const ObjIndexKey& k) const {
+        size_t h = std::hash<int>()(k.v);
+        h ^= std::hash<int>()(k.n) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        h ^= std::hash<int>()(k.t) + 0x9e3779b9 + (h << 6) + (h >> 2);
+        return h;
+    }
+};
+
+// Monta o vértice completo a partir de um index_t do TinyObjLoader
+inline Vertex makeVertex(const tinyobj::attrib_t& attrib, const tinyobj::index_t& idx) {
+    Vertex v;
+    v.pos = {
+        attrib.vertices[3 * idx.vertex_index + 0],
+        attrib.vertices[3 * idx.vertex_index + 1],
+        attrib.vertices[3 * idx.vertex_index + 2]
+    };
+    v.color = { 1.0f, 1.0f, 1.0f };
+    v.tex = (idx.texcoord_index >= 0) ?
+        glm::vec2(
+            attrib.texcoords[2 * idx.texcoord_index + 0],
+            attrib.texcoords[2 * idx.texcoord_index + 1]
+        ) : glm::vec2(0.0f);
+
+    v.normal = (idx.normal_index >= 0) ?
+        glm::vec3(
+            attrib.normals[3 * idx.normal_index + 0],
+            attrib.normals[3 * idx.normal_index + 1],
+            attrib.normals[3 * idx.normal_index + 2]
+        ) : glm::vec3(0.0f, 0.0f, 1.0f);
+    return v;
+}
+
+// Converte os shapes do OBJ em uma malha indexada, reaproveitando vértices compartilhados
+inline MeshData buildIndexedMesh(const tinyobj::attrib_t& attrib, const std::vector<tinyobj::shape_t>& shapes) {
+    MeshData mesh;
+    std::unordered_map<ObjIndexKey, uint32_t, ObjIndexKeyHash> uniqueVertices;
+
+    size_t totalIndices = 0;
+    for (const auto& shape : shapes) totalIndices += shape.mesh.indices.size();
+    mesh.indices.reserve(totalIndices);
+    uniqueVertices.reserve(totalIndices / 2);
+
+    for (const auto& shape : shapes) {
+        for (const auto& idx : shape.mesh.indices) {
+            ObjIndexKey key{ idx.vertex_index, idx.normal_index, idx.texcoord_index };
+            auto it = uniqueVertices.find(key);
+            if (it == uniqueVertices.end()) {
+                uint32_t newIndex = static_cast<uint32_t>(mesh.vertices.size());
+                uniqueVertices.emplace(key, newIndex);
+                mesh.vertices.push_back(makeVertex(attrib, idx));
+                mesh.indices.push_back(newIndex);
+            } else {
+                mesh.indices.push_back(it->second);
+            }
+        }
+    }
+    return mesh;
+}
+
+// Material principal do .obj (o primeiro da lista, como nos exercícios)
+struct MeshMaterial {
+    bool present = false;
+    glm::vec3 ka = glm::vec3(0.2f), kd = glm::vec3(0.8f), ks = glm::vec3(1.0f);
+    float shininess = 32.0f;
+    std::string diffuseTexname;
+};
+
+// Lê o .obj/.mtl com TinyObjLoader e devolve a malha indexada e o material principal (referência do
+// ObjParser em objparser.h, que é o leitor usado pelos executáveis)
+inline bool loadObjMeshTinyObj(const std::string& objPath, MeshData& mesh, MeshMaterial& material, std::string& err) {
+    tinyobj::attrib_t attrib;
+    std::vector<tinyobj::shape_t> shapes;
+    std::vector<tinyobj::material_t> materials;
+    std::string warn;
+
+    std::string baseDir = std::filesystem::path(objPath).parent_path().string();
+    if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, objPath.c_str(), baseDir.c_str()))
+        return false;
+
+    mesh = buildIndexedMesh(attrib, shapes);
+    material = MeshMaterial();
+    if (!materials.empty()) {
+        const auto& mat = materials[0];
+        material.present = true;
+        material.ka = glm::vec3(mat.ambient[0], mat.ambient[1], mat.ambient[2]);
+        material.kd = glm::vec3(mat.diffuse[0], mat.diffuse[1], mat.diffuse[2]);
+        material.ks = glm::vec3(mat.specular[0], mat.specular[1], mat.specular[2]);
+        material.shininess = mat.shininess;
+        material.diffuseTexname = mat.diffuse_texname;
+    }
+    return true;
+}
+
+// Handles de GPU de uma malha indexada
+struct GpuMesh {
+    GLuint VAO = 0, VBO = 0, EBO = 0;
+    size_t vertexCount = 0;
+    size_t indexCount = 0;
+    GLenum indexType = GL_UNSIGNED_INT;
+    VertexFormat format = VertexFormat::Full;
+    // Posição no espaço do modelo = positionOffset + positionScale * posição lida do VBO
+    glm::vec3 positionOffset = glm::vec3(0.0f), positionScale = glm::vec3(1.0f);
+};
+
+// Atributos de Vertex (0 = posição, 1 = cor, 2 = uv, 3 = normal) lidos do VBO ligado em GL_ARRAY_BUFFER
+inline void setupVertexAttributes() {
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tex));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    glEnableVertexAttribArray(3);
+}
+
+// Atributos dos formatos compactados: a posição chega em float ou unorm16 (0..1 na caixa da malha),
+// a normal em dois snorm16 (o shader decodifica o octaedro) e o uv em half float; a cor fica desligada
+inline void setupVertexAttributes(VertexFormat format) {
+    if (format == VertexFormat::Full) {
+        setupVertexAttributes();
+        return;
+    }
+    GLsizei stride = static_cast<GLsizei>(vertexStride(format));
+    if (format == VertexFormat::Packed16) {
+        glVertexAttribPointer(0, 3, GL_UNSIGNED_SHORT, GL_TRUE, stride, (void*)offsetof(PackedVertex16, pos));
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(PackedVertex16, tex));
+        glVertexAttribPointer(3, 2, GL_SHORT, GL_TRUE, stride, (void*)offsetof(PackedVertex16, normal));
+    } else {
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(PackedVertexFloat, pos));
+        glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void*)offsetof(PackedVertexFloat, tex));
+        glVertexAttribPointer(3, 2, GL_SHORT, GL_TRUE, stride, (void*)offsetof(PackedVertexFloat, normal));
+    }
+    glEnableVertexAttribArray(0);
+    glDisableVertexAttribArray(1);
+    glEnableVertexAttribArray(2);
+    glEnableVertexAttribArray(3);
+}
+
+// Envia vértices (no formato indicado) e índices já prontos para a GPU; indexType é GL_UNSIGNED_SHORT
+// ou GL_UNSIGNED_INT. Os ponteiros podem apontar direto para um arquivo mapeado em memória.
+inline GpuMesh uploadVertexBuffers(const void* vertices, size_t vertexCount, VertexFormat format,
+                                   const void* indices, size_t indexCount, GLenum indexType) {
+    GpuMesh gpu;
+    gpu.vertexCount = vertexCount;
+    gpu.indexCount = indexCount;
+    gpu.indexType = indexType;
+    gpu.format = format;
+    size_t indexSize = (indexType == GL_UNSIGNED_SHORT) ? sizeof(uint16_t) : sizeof(uint32_t);
+
+    glGenVertexArrays(1, &gpu.VAO);
+    glGenBuffers(1, &gpu.VBO);
+    glGenBuffers(1, &gpu.EBO);
+    glBindVertexArray(gpu.VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, gpu.VBO);
+    glBufferData(GL_ARRAY_BUFFER, vertexStride(format) * vertexCount, vertices, GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, gpu.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexSize * indexCount, indices, GL_STATIC_DRAW);
+
+    setupVertexAttributes(format);
+
+    // O EBO fica associado ao VAO; desvincula o VAO antes de soltar o buffer
+    glBindVertexArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    return gpu;
+}
+
+inline GpuMesh uploadMeshBuffers(const Vertex* vertices, size_t vertexCount, const void* indices, size_t indexCount, GLenum indexType) {
+    return uploadVertexBuffers(vertices, vertexCount, VertexFormat::Full, indices, indexCount, indexType);
+}
+
+// Índices de 16 bits quando todos os vértices cabem, 32 bits caso contrário
+inline bool fitsShortIndices(const MeshData& mesh) {
+    return mesh.vertices.size() <= 0xFFFF;
+}
+
+inline std::vector<uint16_t> toShortIndices(const MeshData& mesh) {
+    return std::vector<uint16_t>(mesh.indices.begin(), mesh.indices.end());
+}
+
+// Envia a malha para a GPU escolhendo a menor largura de índice possível. extraIndices (os LODs da
+// malha, por exemplo) vão para o mesmo EBO logo depois dos índices da malha; indexCount continua
+// contando só mesh.indices. vertices/format substituem os vértices de mesh quando eles já foram
+// convertidos para um formato compacto (packedvertex.h).
+inline GpuMesh uploadMesh(const MeshData& mesh, const std::vector<uint32_t>& extraIndices = {},
+                          const void* vertices = nullptr, VertexFormat format = VertexFormat::Full) {
+    if (!vertices) {
+        vertices = mesh.vertices.data();
+        format = VertexFormat::Full;
+    }
+    size_t vertexCount = mesh.vertices.size();
+    GpuMesh gpu;
+    if (fitsShortIndices(mesh)) {
+        std::vector<uint16_t> shortIndices = toShortIndices(mesh);
+        shortIndices.insert(shortIndices.end(), extraIndices.begin(), extraIndices.end());
+        gpu = uploadVertexBuffers(vertices, vertexCount, format, shortIndices.data(), shortIndices.size(), GL_UNSIGNED_SHORT);
+    } else if (extraIndices.empty()) {
+        gpu = uploadVertexBuffers(vertices, vertexCount, format, mesh.indices.data(), mesh.indices.size(), GL_UNSIGNED_INT);
+    } else {
+        std::vector<uint32_t> indices = mesh.indices;
+        indices.insert(indices.end(), extraIndices.begin(), extraIndices.end());
+        gpu = uploadVertexBuffers(vertices, vertexCount, format, indices.data(), indices.size(), GL_UNSIGNED_INT);
+    }
+    gpu.indexCount = mesh.indices.size();
+    return gpu;
+}
+
+#endif
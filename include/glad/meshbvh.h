@@ -0,0 +1,274 @@
+#ifndef MESH_BVH_H
+#define MESH_BVH_H
+
+// BVH de triângulos de uma malha, usada no ray picking.
+// Construída por SAH com bins (em espaço de objeto, uma vez por malha) e guardada como um array
+// plano de nós; os triângulos são copiados na ordem das folhas para a travessia ler memória contígua.
+// Só depende da GLM: é montada nas threads de carregamento e também no pickbench.
+
+#include "bounds.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Triângulo mais próximo atingido pelo raio; u e v são as coordenadas baricêntricas de v1 e v2
+struct RayHit {
+    float t = FLT_MAX;
+    uint32_t triangle = UINT32_MAX;   // índice do triângulo na malha original (índices / 3)
+    float u = 0.0f, v = 0.0f;
+
+    bool valid() const { return triangle != UINT32_MAX; }
+};
+
+class MeshBVH {
+public:
+    static const uint32_t SAH_BINS = 16;
+    static const uint32_t MAX_LEAF_SIZE = 8;
+
+    // Posições lidas com stride (direto de um array de Vertex); índices de 16 ou 32 bits
+    void build(const glm::vec3* positions, size_t stride, const void* indices, size_t indexSize, size_t indexCount) {
+        nodes.clear();
+        triangles.clear();
+        triangleIds.clear();
+        size_t count = indexCount / 3;
+        if (count == 0) return;
+
+        const unsigned char* base = reinterpret_cast<const unsigned char*>(positions);
+        auto position = [&](size_t k) {
+            uint32_t index = indexSize == sizeof(uint16_t) ? static_cast<const uint16_t*>(indices)[k]
+                                                           : static_cast<const uint32_t*>(indices)[k];
+            return *reinterpret_cast<const glm::vec3*>(base + index * stride);
+        };
+
+        std::vector<Triangle> source(count);
+        std::vector<AABB> triBounds(count);
+        std::vector<glm::vec3> centroids(count);
+        triangleIds.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            glm::vec3 a = position(3 * i), b = position(3 * i + 1), c = position(3 * i + 2);
+            source[i] = { a, b - a, c - a };
+            triBounds[i].expand(a);
+            triBounds[i].expand(b);
+            triBounds[i].expand(c);
+            centroids[i] = triBounds[i].center();
+            triangleIds[i] = (uint32_t)i;
+        }
+
+        nodes.reserve(2 * count / MAX_LEAF_SIZE + 1);
+        nodes.emplace_back();
+        nodes[0].first = 0;
+        nodes[0].count = (uint32_t)count;
+
+        // Construção iterativa: cada nó pendente é dividido pelo melhor plano SAH entre os três eixos
+        std::vector<uint32_t> pending{ 0 };
+        while (!pending.empty()) {
+            uint32_t nodeIndex = pending.back();
+            pending.pop_back();
+            uint32_t first = nodes[nodeIndex].first, n = nodes[nodeIndex].count;
+
+            AABB box, centroidBox;
+            for (uint32_t i = first; i < first + n; ++i) {
+                box.expand(triBounds[triangleIds[i]]);
+                centroidBox.expand(centroids[triangleIds[i]]);
+            }
+            nodes[nodeIndex].min = box.min;
+            nodes[nodeIndex].max = box.max;
+            if (n <= 2) continue;
+
+            int axis = -1;
+            uint32_t splitBin = 0;
+            float bestCost = FLT_MAX;
+            for (int a = 0; a < 3; ++a) {
+                float lo = centroidBox.min[a], extent = centroidBox.max[a] - lo;
+                if (extent <= 0.0f) continue;
+                float binScale = SAH_BINS / extent;
+
+                AABB binBounds[SAH_BINS];
+                uint32_t binCount[SAH_BINS] = {};
+                for (uint32_t i = first; i < first + n; ++i) {
+                    uint32_t t = triangleIds[i];
+                    uint32_t bin = std::min(SAH_BINS - 1, (uint32_t)((centroids[t][a] - lo) * binScale));
+                    binBounds[bin].expand(triBounds[t]);
+                    ++binCount[bin];
+                }
+
+                // Varredura da esquerda acumulando área x contagem; depois a da direita avalia cada plano
+                float leftCost[SAH_BINS - 1];
+                AABB acc;
+                uint32_t accCount = 0;
+                for (uint32_t b = 0; b < SAH_BINS - 1; ++b) {
+                    acc.expand(binBounds[b]);
+                    accCount += binCount[b];
+                    leftCost[b] = accCount ? acc.surfaceArea() * accCount : 0.0f;
+                }
+                acc = AABB();
+                accCount = 0;
+                for (uint32_t b = SAH_BINS - 1; b > 0; --b) {
+                    acc.expand(binBounds[b]);
+                    accCount += binCount[b];
+                    float cost = leftCost[b - 1] + (accCount ? acc.surfaceArea() * accCount : 0.0f);
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        axis = a;
+                        splitBin = b;
+                    }
+                }
+            }
+
+            // Custo de folha x custo da divisão (travessia = 1 triângulo, normalizado pela área do nó)
+            float area = box.surfaceArea();
+            float splitCost = area > 0.0f ? 1.0f + bestCost / area : FLT_MAX;
+            if (axis < 0 || (splitCost >= (float)n && n <= MAX_LEAF_SIZE)) continue;
+
+            float lo = centroidBox.min[axis], binScale = SAH_BINS / (centroidBox.max[axis] - lo);
+            uint32_t* begin = triangleIds.data() + first;
+            uint32_t* middle = std::partition(begin, begin + n, [&](uint32_t t) {
+                return std::min(SAH_BINS - 1, (uint32_t)((centroids[t][axis] - lo) * binScale)) < splitBin;
+            });
+            uint32_t leftCount = (uint32_t)(middle - begin);
+            if (leftCount == 0 || leftCount == n) continue;
+
+            uint32_t left = (uint32_t)nodes.size();
+            nodes.emplace_back();
+            nodes.emplace_back();
+            nodes[left].first = first;
+            nodes[left].count = leftCount;
+            nodes[left + 1].first = first + leftCount;
+            nodes[left + 1].count = n - leftCount;
+            nodes[nodeIndex].first = left;
+            nodes[nodeIndex].count = 0;
+            pending.push_back(left + 1);
+            pending.push_back(left);
+        }
+
+        triangles.resize(count);
+        for (size_t i = 0; i < count; ++i) triangles[i] = source[triangleIds[i]];
+        nodes.shrink_to_fit();
+    }
+
+    // Triângulo mais próximo com t em [0, maxT). O raio não precisa estar normalizado:
+    // t é medido em unidades de `dir`, o que permite comparar acertos de malhas com transformações diferentes.
+    bool intersect(const glm::vec3& origin, const glm::vec3& dir, RayHit& hit, float maxT = FLT_MAX) const {
+        if (nodes.empty()) return false;
+        glm::vec3 invDir = 1.0f / dir;
+        bool found = false;
+        float closest = std::min(maxT, hit.t);
+
+        uint32_t stack[64];
+        uint32_t top = 0;
+        if (slab(nodes[0], origin, invDir, closest) == FLT_MAX) return false;
+        stack[top++] = 0;
+
+        while (top > 0) {
+            const Node& node = nodes[stack[--top]];
+            if (node.count > 0) {
+                for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                    float t, u, v;
+                    if (intersectTriangle(triangles[i], origin, dir, closest, t, u, v)) {
+                        closest = t;
+                        hit.t = t;
+                        hit.triangle = triangleIds[i];
+                        hit.u = u;
+                        hit.v = v;
+                        found = true;
+                    }
+                }
+                continue;
+            }
+
+            // Filho mais próximo por último na pilha, para ser visitado primeiro e encurtar o raio
+            uint32_t near = node.first, far = node.first + 1;
+            float tNear = slab(nodes[near], origin, invDir, closest);
+            float tFar = slab(nodes[far], origin, invDir, closest);
+            if (tFar < tNear) {
+                std::swap(near, far);
+                std::swap(tNear, tFar);
+            }
+            if (tFar != FLT_MAX && top < 64) stack[top++] = far;
+            if (tNear != FLT_MAX && top < 64) stack[top++] = near;
+        }
+        return found;
+    }
+
+    // Força bruta sobre todos os triângulos (referência para o pickbench)
+    bool intersectBruteForce(const glm::vec3& origin, const glm::vec3& dir, RayHit& hit) const {
+        bool found = false;
+        for (size_t i = 0; i < triangles.size(); ++i) {
+            float t, u, v;
+            if (intersectTriangle(triangles[i], origin, dir, hit.t, t, u, v)) {
+                hit.t = t;
+                hit.triangle = triangleIds[i];
+                hit.u = u;
+                hit.v = v;
+                found = true;
+            }
+        }
+        return found;
+    }
+
+    AABB bounds() const {
+        AABB box;
+        if (!nodes.empty()) {
+            box.min = nodes[0].min;
+            box.max = nodes[0].max;
+        }
+        return box;
+    }
+
+    size_t triangleCount() const { return triangles.size(); }
+    size_t nodeCount() const { return nodes.size(); }
+    size_t memoryBytes() const {
+        return nodes.size() * sizeof(Node) + triangles.size() * (sizeof(Triangle) + sizeof(uint32_t));
+    }
+
+private:
+    // 32 bytes: dois nós por linha de cache
+    struct Node {
+        glm::vec3 min;
+        uint32_t first = 0;   // folha: primeiro triângulo; interno: filho esquerdo (direito = first + 1)
+        glm::vec3 max;
+        uint32_t count = 0;   // > 0 nas folhas
+    };
+
+    // Vértice e arestas pré-calculadas para o teste de Möller-Trumbore
+    struct Triangle {
+        glm::vec3 v0, e1, e2;
+    };
+
+    // Distância de entrada no nó, ou FLT_MAX se o raio não o atinge antes de maxT
+    static float slab(const Node& node, const glm::vec3& origin, const glm::vec3& invDir, float maxT) {
+        glm::vec3 t0 = (node.min - origin) * invDir;
+        glm::vec3 t1 = (node.max - origin) * invDir;
+        glm::vec3 tmin = glm::min(t0, t1), tmax = glm::max(t0, t1);
+        float enter = std::max(std::max(tmin.x, tmin.y), std::max(tmin.z, 0.0f));
+        float exit = std::min(std::min(tmax.x, tmax.y), std::min(tmax.z, maxT));
+        return enter <= exit ? enter : FLT_MAX;
+    }
+
+    static bool intersectTriangle(const Triangle& tri, const glm::vec3& origin, const glm::vec3& dir, float maxT,
+                                  float& t, float& u, float& v) {
+        glm::vec3 p = glm::cross(dir, tri.e2);
+        float det = glm::dot(tri.e1, p);
+        if (std::abs(det) < 1e-12f) return false;
+        float invDet = 1.0f / det;
+        glm::vec3 s = origin - tri.v0;
+        u = glm::dot(s, p) * invDet;
+        if (u < 0.0f || u > 1.0f) return false;
+        glm::vec3 q = glm::cross(s, tri.e1);
+        v = glm::dot(dir, q) * invDet;
+        if (v < 0.0f || u + v > 1.0f) return false;
+        t = glm::dot(tri.e2, q) * invDet;
+        return t >= 0.0f && t < maxT;
+    }
+
+    std::vector<Node> nodes;
+    std::vector<Triangle> triangles;     // na ordem das folhas
+    std::vector<uint32_t> triangleIds;   // índice original de cada entrada de `triangles`
+};
+
+#endif
@@ -0,0 +1,272 @@
+#ifndef MESH_CACHE_H
+#define MESH_CACHE_H
+
+// Cache binário de malhas (.meshbin): evita reprocessar o texto do .obj/.mtl a cada execução.
+//
+// Layout do arquivo (little-endian nativo, sem compressão):
+//   MeshCacheHeader | MeshCacheMaterial | MeshCacheLod[lodCount] | vértices (Vertex[vertexCount]) |
+//   vértices compactos (PackedVertex16[vertexCount]) |
+//   índices (uint16/uint32: o LOD 0 com indexCount índices, depois os demais níveis da cadeia)
+// As seções de vértices e índices ficam alinhadas em 16 bytes para poderem ser enviadas
+// direto do arquivo mapeado em memória para glBufferData. Os vértices completos servem à BVH de picking
+// e ao formato completo; os compactos são os que vão para a GPU no formato padrão.
+
+#include "mesh.h"
+#include "meshlod.h"
+#include "mappedfile.h"
+#include "packedvertex.h"
+#include "sourcestamp.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <thread>
+
+const char MESH_CACHE_MAGIC[4] = { 'M', 'S', 'H', 'B' };
+const uint32_t MESH_CACHE_VERSION = 4;   // 2: tabela de LODs; 3: ordem de cache/overdraw (meshopt.h); 4: vértices compactos
+
+struct MeshCacheHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t vertexSize;     // sizeof(Vertex), detecta mudança de layout
+    uint32_t indexSize;      // 2 ou 4 bytes
+    uint64_t vertexCount;
+    uint64_t indexCount;     // só o LOD 0
+    uint64_t materialOffset;
+    uint64_t vertexOffset;
+    uint64_t indexOffset;
+    uint64_t lodOffset;
+    uint64_t packedOffset;   // PackedVertex16[vertexCount]
+    float packedPositionOffset[3], packedPositionScale[3];   // desquantização da posição compacta
+    float packedError[4];    // VertexPackError da conversão: posição, relativa à diagonal, normal (graus), uv
+    uint32_t lodCount;       // incluindo o LOD 0
+    uint32_t reserved;
+    SourceStamp objSource;
+    SourceStamp mtlSource;   // zerado quando o .obj não referencia um .mtl
+};
+
+struct MeshCacheMaterial {
+    uint32_t present;
+    float ka[3], kd[3], ks[3];
+    float shininess;
+    char diffuseTexname[256];
+};
+
+struct MeshCacheLod {
+    uint32_t firstIndex;
+    uint32_t indexCount;
+    float error;             // erro geométrico em unidades do modelo
+    uint32_t reserved;
+};
+
+inline uint64_t alignTo16(uint64_t offset) {
+    return (offset + 15) & ~uint64_t(15);
+}
+
+// Caminho do cache correspondente a um .obj (ao lado do arquivo original)
+inline std::string meshCachePath(const std::string& objPath) {
+    return std::filesystem::path(objPath).replace_extension(".meshbin").string();
+}
+
+// Procura a diretiva mtllib no .obj para validar também o arquivo de material
+inline std::string findMtlPath(const std::string& objPath) {
+    MappedFile file;
+    if (!file.open(objPath)) return "";
+    const char* text = reinterpret_cast<const char*>(file.data());
+    size_t size = file.size();
+    const char* key = "mtllib";
+    for (size_t i = 0; i + 6 < size; ++i) {
+        if ((i == 0 || text[i - 1] == '\n') && std::memcmp(text + i, key, 6) == 0 && (text[i + 6] == ' ' || text[i + 6] == '\t')) {
+            size_t start = i + 7;
+            while (start < size && (text[start] == ' ' || text[start] == '\t')) ++start;
+            size_t end = start;
+            while (end < size && text[end] != '\n' && text[end] != '\r') ++end;
+            while (end > start && (text[end - 1] == ' ' || text[end - 1] == '\t')) --end;
+            std::string name(text + start, end - start);
+            return (std::filesystem::path(objPath).parent_path() / name).string();
+        }
+    }
+    return "";
+}
+
+// Grava o cache binário de uma malha já indexada, com a cadeia de LODs de buildLodChain
+// (sem cadeia, só o LOD 0)
+inline bool writeMeshCache(const std::string& cachePath, const std::string& objPath, const MeshData& mesh, const MeshMaterial& material,
+                           const MeshLodChain& chain = MeshLodChain()) {
+    std::vector<MeshCacheLod> lods;
+    if (chain.levels.empty()) lods.push_back({ 0, static_cast<uint32_t>(mesh.indices.size()), 0.0f, 0 });
+    for (const MeshLod& lod : chain.levels) lods.push_back({ lod.firstIndex, lod.indexCount, lod.error, 0 });
+
+    MeshCacheHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, MESH_CACHE_MAGIC, sizeof(header.magic));
+    header.version = MESH_CACHE_VERSION;
+    header.vertexSize = sizeof(Vertex);
+    header.indexSize = fitsShortIndices(mesh) ? sizeof(uint16_t) : sizeof(uint32_t);
+    header.vertexCount = mesh.vertices.size();
+    header.indexCount = mesh.indices.size();
+    header.materialOffset = sizeof(MeshCacheHeader);
+    header.lodOffset = header.materialOffset + sizeof(MeshCacheMaterial);
+    header.lodCount = static_cast<uint32_t>(lods.size());
+    header.vertexOffset = alignTo16(header.lodOffset + sizeof(MeshCacheLod) * lods.size());
+    header.packedOffset = alignTo16(header.vertexOffset + sizeof(Vertex) * header.vertexCount);
+    header.indexOffset = alignTo16(header.packedOffset + sizeof(PackedVertex16) * header.vertexCount);
+
+    PackedVertices packed = packVertices(mesh.vertices.data(), mesh.vertices.size(), VertexFormat::Packed16);
+    for (int i = 0; i < 3; ++i) {
+        header.packedPositionOffset[i] = packed.positionOffset[i];
+        header.packedPositionScale[i] = packed.positionScale[i];
+    }
+    header.packedError[0] = packed.error.position;
+    header.packedError[1] = packed.error.positionRelative;
+    header.packedError[2] = packed.error.normalDegrees;
+    header.packedError[3] = packed.error.tex;
+
+    if (!statSource(objPath, header.objSource) || !hashSource(objPath, header.objSource)) return false;
+    std::string mtlPath = findMtlPath(objPath);
+    if (!mtlPath.empty() && statSource(mtlPath, header.mtlSource)) hashSource(mtlPath, header.mtlSource);
+
+    MeshCacheMaterial mat;
+    std::memset(&mat, 0, sizeof(mat));
+    mat.present = material.present ? 1 : 0;
+    for (int i = 0; i < 3; ++i) {
+        mat.ka[i] = material.ka[i];
+        mat.kd[i] = material.kd[i];
+        mat.ks[i] = material.ks[i];
+    }
+    mat.shininess = material.shininess;
+    if (material.diffuseTexname.size() >= sizeof(mat.diffuseTexname)) return false;
+    std::memcpy(mat.diffuseTexname, material.diffuseTexname.c_str(), material.diffuseTexname.size());
+
+    // Grava em arquivo temporário e renomeia, para nunca deixar um cache pela metade; o nome
+    // inclui a thread para que cargas paralelas do mesmo .obj não escrevam no mesmo arquivo
+    std::string tmpPath = cachePath + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+
+        const char padding[16] = {};
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(&mat), sizeof(mat));
+        out.write(reinterpret_cast<const char*>(lods.data()), sizeof(MeshCacheLod) * lods.size());
+        out.write(padding, header.vertexOffset - (header.lodOffset + sizeof(MeshCacheLod) * lods.size()));
+        out.write(reinterpret_cast<const char*>(mesh.vertices.data()), sizeof(Vertex) * mesh.vertices.size());
+        out.write(padding, header.packedOffset - (header.vertexOffset + sizeof(Vertex) * header.vertexCount));
+        out.write(reinterpret_cast<const char*>(packed.data.data()), packed.data.size());
+        out.write(padding, header.indexOffset - (header.packedOffset + sizeof(PackedVertex16) * header.vertexCount));
+        if (header.indexSize == sizeof(uint16_t)) {
+            std::vector<uint16_t> shortIndices = toShortIndices(mesh);
+            shortIndices.insert(shortIndices.end(), chain.indices.begin(), chain.indices.end());
+            out.write(reinterpret_cast<const char*>(shortIndices.data()), sizeof(uint16_t) * shortIndices.size());
+        } else {
+            out.write(reinterpret_cast<const char*>(mesh.indices.data()), sizeof(uint32_t) * mesh.indices.size());
+            out.write(reinterpret_cast<const char*>(chain.indices.data()), sizeof(uint32_t) * chain.indices.size());
+        }
+        if (!out.good()) return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, cachePath, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+// Visão somente leitura de um .meshbin mapeado em memória
+class MeshCacheView {
+public:
+    // Abre e valida o cache contra o .obj (e o .mtl) de origem; false se ausente, corrompido ou desatualizado
+    bool open(const std::string& cachePath, const std::string& objPath) {
+        if (!file.open(cachePath)) return false;
+        if (file.size() < sizeof(MeshCacheHeader) || !validate(objPath)) {
+            file.close();
+            return false;
+        }
+        return true;
+    }
+
+    const MeshCacheHeader& header() const { return *reinterpret_cast<const MeshCacheHeader*>(file.data()); }
+    const Vertex* vertices() const { return reinterpret_cast<const Vertex*>(file.data() + header().vertexOffset); }
+    const void* indices() const { return file.data() + header().indexOffset; }
+    size_t vertexCount() const { return static_cast<size_t>(header().vertexCount); }
+    size_t indexCount() const { return static_cast<size_t>(header().indexCount); }
+    // Índices do LOD 0 mais os da cadeia, na ordem em que estão no arquivo
+    size_t totalIndexCount() const {
+        const MeshCacheLod& last = lodTable()[header().lodCount - 1];
+        return std::max<size_t>(indexCount(), size_t(last.firstIndex) + last.indexCount);
+    }
+    size_t lodCount() const { return header().lodCount; }
+
+    std::vector<MeshLod> lods() const {
+        std::vector<MeshLod> result(lodCount());
+        for (size_t i = 0; i < result.size(); ++i) {
+            const MeshCacheLod& lod = lodTable()[i];
+            result[i].firstIndex = lod.firstIndex;
+            result[i].indexCount = lod.indexCount;
+            result[i].error = lod.error;
+        }
+        return result;
+    }
+    // Vértices já no formato Packed16, apontando para o arquivo mapeado (válidos enquanto a visão existir)
+    PackedVertices packedVertices() const {
+        const MeshCacheHeader& h = header();
+        PackedVertices packed;
+        packed.format = VertexFormat::Packed16;
+        packed.count = vertexCount();
+        packed.mapped = file.data() + h.packedOffset;
+        packed.positionOffset = glm::vec3(h.packedPositionOffset[0], h.packedPositionOffset[1], h.packedPositionOffset[2]);
+        packed.positionScale = glm::vec3(h.packedPositionScale[0], h.packedPositionScale[1], h.packedPositionScale[2]);
+        packed.error = { h.packedError[0], h.packedError[1], h.packedError[2], h.packedError[3] };
+        return packed;
+    }
+
+    GLenum indexType() const { return header().indexSize == sizeof(uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT; }
+
+    MeshMaterial material() const {
+        const MeshCacheMaterial& mat = *reinterpret_cast<const MeshCacheMaterial*>(file.data() + header().materialOffset);
+        MeshMaterial material;
+        material.present = mat.present != 0;
+        material.ka = glm::vec3(mat.ka[0], mat.ka[1], mat.ka[2]);
+        material.kd = glm::vec3(mat.kd[0], mat.kd[1], mat.kd[2]);
+        material.ks = glm::vec3(mat.ks[0], mat.ks[1], mat.ks[2]);
+        material.shininess = mat.shininess;
+        material.diffuseTexname.assign(mat.diffuseTexname, strnlen(mat.diffuseTexname, sizeof(mat.diffuseTexname)));
+        return material;
+    }
+
+private:
+    const MeshCacheLod* lodTable() const { return reinterpret_cast<const MeshCacheLod*>(file.data() + header().lodOffset); }
+
+    bool validate(const std::string& objPath) const {
+        const MeshCacheHeader& h = header();
+        if (std::memcmp(h.magic, MESH_CACHE_MAGIC, sizeof(h.magic)) != 0) return false;
+        if (h.version != MESH_CACHE_VERSION || h.vertexSize != sizeof(Vertex)) return false;
+        if (h.indexSize != sizeof(uint16_t) && h.indexSize != sizeof(uint32_t)) return false;
+        if (h.materialOffset + sizeof(MeshCacheMaterial) > file.size()) return false;
+        if (h.vertexOffset + h.vertexCount * sizeof(Vertex) > file.size()) return false;
+        if (h.packedOffset + h.vertexCount * sizeof(PackedVertex16) > file.size()) return false;
+        if (h.indexOffset + h.indexCount * h.indexSize > file.size()) return false;
+        if (h.lodCount == 0 || h.lodOffset + uint64_t(h.lodCount) * sizeof(MeshCacheLod) > h.vertexOffset) return false;
+        for (uint32_t i = 0; i < h.lodCount; ++i) {
+            const MeshCacheLod& lod = lodTable()[i];
+            if (h.indexOffset + (uint64_t(lod.firstIndex) + lod.indexCount) * h.indexSize > file.size()) return false;
+        }
+
+        if (!sourceMatches(objPath, h.objSource)) return false;
+        if (h.mtlSource.size != 0 || h.mtlSource.mtime != 0) {
+            std::string mtlPath = findMtlPath(objPath);
+            if (mtlPath.empty() || !sourceMatches(mtlPath, h.mtlSource)) return false;
+        }
+        return true;
+    }
+
+    MappedFile file;
+};
+
+#endif
@@ -0,0 +1,525 @@
+#ifndef MESH_LOD_H
+#define MESH_LOD_H
+
+// Níveis de detalhe (LOD) gerados no bake: simplificação por métrica de erro quádrico (Garland & Heckbert)
+// com colapsos de meia-aresta, e escolha do nível em tempo de execução pelo erro projetado na tela.
+//
+// Cada colapso move um vértice para a posição de um vizinho que já existe, então todos os níveis
+// reaproveitam o mesmo vetor de vértices: só os índices mudam, e a cadeia inteira cabe em um único
+// VBO + EBO (o LOD 0 primeiro, os demais em seguida).
+
+#include "mesh.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+// Um nível da cadeia: faixa do buffer de índices e erro geométrico em unidades do modelo
+struct MeshLod {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    float error = 0.0f;
+};
+
+// Cadeia de LODs de uma malha: levels[0] é a própria malha (mesh.indices); indices guarda os níveis
+// seguintes em sequência, e o firstIndex de cada nível conta a partir do início do LOD 0
+struct MeshLodChain {
+    std::vector<MeshLod> levels;
+    std::vector<uint32_t> indices;
+};
+
+// Quádrica de erro: soma dos quadrados das distâncias a um conjunto de planos, guardada como os
+// 10 coeficientes da matriz simétrica 4x4
+struct Quadric {
+    double a2 = 0, ab = 0, ac = 0, ad = 0, b2 = 0, bc = 0, bd = 0, c2 = 0, cd = 0, d2 = 0;
+
+    // Plano ax + by + cz + d = 0 com normal unitária, multiplicado pelo peso
+    static Quadric plane(double a, double b, double c, double d, double weight) {
+        Quadric q;
+        q.a2 = weight * a * a; q.ab = weight * a * b; q.ac = weight * a * c; q.ad = weight * a * d;
+        q.b2 = weight * b * b; q.bc = weight * b * c; q.bd = weight * b * d;
+        q.c2 = weight * c * c; q.cd = weight * c * d;
+        q.d2 = weight * d * d;
+        return q;
+    }
+
+    void add(const Quadric& q) {
+        a2 += q.a2; ab += q.ab; ac += q.ac; ad += q.ad;
+        b2 += q.b2; bc += q.bc; bd += q.bd;
+        c2 += q.c2; cd += q.cd;
+        d2 += q.d2;
+    }
+
+    double error(const glm::vec3& p) const {
+        double x = p.x, y = p.y, z = p.z;
+        double e = a2 * x * x + 2 * ab * x * y + 2 * ac * x * z + 2 * ad * x
+                 + b2 * y * y + 2 * bc * y * z + 2 * bd * y
+                 + c2 * z * z + 2 * cd * z
+                 + d2;
+        return e > 0.0 ? e : 0.0;
+    }
+};
+
+// Peso dos planos perpendiculares às bordas abertas: segura o contorno da malha no lugar
+const double LOD_BORDER_WEIGHT = 10.0;
+// Colapso rejeitado se algum triângulo vizinho girar mais que ~75 graus (cosseno mínimo entre as normais)
+const float LOD_MIN_NORMAL_DOT = 0.25f;
+// Peso do comprimento da aresta na ordem dos colapsos (não entra no erro medido)
+const double LOD_EDGE_LENGTH_WEIGHT = 1e-3;
+
+// Simplificador de uma malha indexada. Vértices com a mesma posição (costuras de uv/normal) são soldados
+// para a topologia; o índice de renderização de cada canto continua sendo o original.
+class MeshSimplifier {
+public:
+    MeshSimplifier(const Vertex* vertices, size_t vertexCount) : vertices(vertices), vertexCount(vertexCount) {
+        weld();
+    }
+
+    // Reduz indices até targetIndexCount (ou até o erro passar de maxError, em unidades do modelo).
+    // Devolve os índices simplificados; error recebe o maior erro dos colapsos feitos.
+    std::vector<uint32_t> simplify(const std::vector<uint32_t>& indices, size_t targetIndexCount, float maxError, float* error) {
+        setup(indices);
+
+        double limit = double(maxError) * double(maxError);
+        double worst = 0.0;
+        size_t target = targetIndexCount / 3;
+        while (liveTriangles > target && !heap.empty()) {
+            Collapse c = heap.top();
+            heap.pop();
+            if (dead[c.from] || dead[c.to] || stamp[c.from] != c.stampFrom || stamp[c.to] != c.stampTo) continue;
+            if (c.cost > limit) continue;
+            if (!canCollapse(c.from, c.to)) continue;
+            collapse(c.from, c.to);
+            worst = std::max(worst, c.cost);
+        }
+
+        std::vector<uint32_t> result;
+        result.reserve(liveTriangles * 3);
+        for (size_t t = 0; t < triangles.size(); ++t) {
+            if (!alive[t]) continue;
+            for (int k = 0; k < 3; ++k) result.push_back(triangles[t].render[k]);
+        }
+        if (error) *error = static_cast<float>(std::sqrt(worst));
+        return result;
+    }
+
+private:
+    enum VertexKind : uint8_t { Interior, Border, Seam, Locked };
+
+    struct Triangle {
+        uint32_t render[3];   // índices no vetor de vértices original
+        uint32_t corner[3];   // posições soldadas correspondentes
+    };
+
+    struct Collapse {
+        double priority;   // custo + desempate pelo comprimento da aresta
+        double cost;
+        uint32_t from, to;
+        uint32_t stampFrom, stampTo;
+        bool operator>(const Collapse& o) const { return priority > o.priority; }
+    };
+
+    // Aresta vista a partir de um vértice: quantos triângulos a usam e se os cantos de renderização diferem
+    struct EdgeUse {
+        uint32_t other;
+        int count;
+        uint32_t renderSelf, renderOther;
+        bool seam;
+    };
+
+    struct PositionKey {
+        float x, y, z;
+        bool operator==(const PositionKey& o) const { return std::memcmp(this, &o, sizeof(o)) == 0; }
+    };
+
+    struct PositionKeyHash {
+        size_t operator()(const PositionKey& k) const {
+            uint32_t b[3];
+            std::memcpy(b, &k, sizeof(b));
+            size_t h = b[0];
+            h ^= b[1] + 0x9e3779b9 + (h << 6) + (h >> 2);
+            h ^= b[2] + 0x9e3779b9 + (h << 6) + (h >> 2);
+            return h;
+        }
+    };
+
+    // Agrupa os vértices de renderização por posição; wedgeStart/wedges listam os vértices de cada posição
+    void weld() {
+        std::unordered_map<PositionKey, uint32_t, PositionKeyHash> unique;
+        unique.reserve(vertexCount);
+        welded.resize(vertexCount);
+        for (size_t i = 0; i < vertexCount; ++i) {
+            PositionKey key{ vertices[i].pos.x, vertices[i].pos.y, vertices[i].pos.z };
+            auto it = unique.emplace(key, static_cast<uint32_t>(positions.size()));
+            if (it.second) positions.push_back(vertices[i].pos);
+            welded[i] = it.first->second;
+        }
+        wedgeStart.assign(positions.size() + 1, 0);
+        for (size_t i = 0; i < vertexCount; ++i) ++wedgeStart[welded[i] + 1];
+        for (size_t p = 0; p < positions.size(); ++p) wedgeStart[p + 1] += wedgeStart[p];
+        wedges.resize(vertexCount);
+        std::vector<uint32_t> fill(wedgeStart.begin(), wedgeStart.end() - 1);
+        for (size_t i = 0; i < vertexCount; ++i) wedges[fill[welded[i]]++] = static_cast<uint32_t>(i);
+    }
+
+    void setup(const std::vector<uint32_t>& indices) {
+        size_t positionCount = positions.size();
+        triangles.clear();
+        triangles.reserve(indices.size() / 3);
+        for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+            Triangle t;
+            for (int k = 0; k < 3; ++k) {
+                t.render[k] = indices[i + k];
+                t.corner[k] = welded[indices[i + k]];
+            }
+            // Triângulos já degenerados depois da solda não contribuem e atrapalham a topologia
+            if (t.corner[0] == t.corner[1] || t.corner[1] == t.corner[2] || t.corner[0] == t.corner[2]) continue;
+            triangles.push_back(t);
+        }
+        alive.assign(triangles.size(), 1);
+        liveTriangles = triangles.size();
+
+        incident.assign(positionCount, {});
+        for (size_t t = 0; t < triangles.size(); ++t)
+            for (int k = 0; k < 3; ++k) incident[triangles[t].corner[k]].push_back(static_cast<uint32_t>(t));
+
+        dead.assign(positionCount, 0);
+        stamp.assign(positionCount, 0);
+        quadrics.assign(positionCount, Quadric());
+
+        for (const Triangle& t : triangles) {
+            glm::vec3 p0 = positions[t.corner[0]], p1 = positions[t.corner[1]], p2 = positions[t.corner[2]];
+            glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+            float len = glm::length(n);
+            if (len <= 0.0f) continue;
+            n /= len;
+            Quadric q = Quadric::plane(n.x, n.y, n.z, -glm::dot(n, p0), 1.0);
+            for (int k = 0; k < 3; ++k) quadrics[t.corner[k]].add(q);
+        }
+
+        // Bordas abertas: plano perpendicular ao triângulo passando pela aresta
+        for (size_t t = 0; t < triangles.size(); ++t) {
+            const Triangle& tri = triangles[t];
+            glm::vec3 p0 = positions[tri.corner[0]], p1 = positions[tri.corner[1]], p2 = positions[tri.corner[2]];
+            glm::vec3 n = glm::cross(p1 - p0, p2 - p0);
+            for (int k = 0; k < 3; ++k) {
+                uint32_t a = tri.corner[k], b = tri.corner[(k + 1) % 3];
+                if (edgeTriangleCount(a, b) != 1) continue;
+                glm::vec3 e = positions[b] - positions[a];
+                glm::vec3 side = glm::cross(e, n);
+                float len = glm::length(side);
+                if (len <= 0.0f) continue;
+                side /= len;
+                double weight = LOD_BORDER_WEIGHT * glm::dot(e, e);
+                Quadric q = Quadric::plane(side.x, side.y, side.z, -glm::dot(side, positions[a]), weight);
+                quadrics[a].add(q);
+                quadrics[b].add(q);
+            }
+        }
+
+        heap = decltype(heap)();
+        for (uint32_t p = 0; p < positionCount; ++p) pushCollapses(p);
+    }
+
+    int edgeTriangleCount(uint32_t a, uint32_t b) const {
+        int count = 0;
+        for (uint32_t t : incident[a]) {
+            if (!alive[t]) continue;
+            const Triangle& tri = triangles[t];
+            if (tri.corner[0] == b || tri.corner[1] == b || tri.corner[2] == b) ++count;
+        }
+        return count;
+    }
+
+    // Arestas de p a partir dos triângulos vivos que o usam
+    void gatherEdges(uint32_t p, std::vector<EdgeUse>& edges) const {
+        edges.clear();
+        for (uint32_t t : incident[p]) {
+            if (!alive[t]) continue;
+            const Triangle& tri = triangles[t];
+            int self = tri.corner[0] == p ? 0 : (tri.corner[1] == p ? 1 : 2);
+            for (int k = 1; k <= 2; ++k) {
+                int o = (self + k) % 3;
+                uint32_t other = tri.corner[o];
+                auto it = std::find_if(edges.begin(), edges.end(), [other](const EdgeUse& e) { return e.other == other; });
+                if (it == edges.end()) {
+                    edges.push_back({ other, 1, tri.render[self], tri.render[o], false });
+                } else {
+                    ++it->count;
+                    if (it->renderSelf != tri.render[self] || it->renderOther != tri.render[o]) it->seam = true;
+                }
+            }
+        }
+    }
+
+    // Interior: livre; borda/costura: só desliza ao longo das próprias arestas de borda/costura;
+    // cantos, bifurcações e arestas não-manifold ficam travados
+    VertexKind classify(const std::vector<EdgeUse>& edges) const {
+        int border = 0, seam = 0;
+        for (const EdgeUse& e : edges) {
+            if (e.count > 2) return Locked;
+            if (e.count == 1) ++border;
+            else if (e.seam) ++seam;
+        }
+        if (border == 0 && seam == 0) return Interior;
+        if (border == 2 && seam == 0) return Border;
+        if (seam == 2 && border == 0) return Seam;
+        return Locked;
+    }
+
+    bool edgeAllowed(VertexKind kind, const EdgeUse& edge) const {
+        switch (kind) {
+        case Interior: return true;
+        case Border: return edge.count == 1;
+        case Seam: return edge.count == 2 && edge.seam;
+        default: return false;
+        }
+    }
+
+    // Em regiões planas todos os custos empatam em zero; sem o desempate os colapsos se acumulam
+    // no mesmo vértice e a valência dele explode. Arestas curtas primeiro mantêm a malha uniforme.
+    void pushCollapse(uint32_t from, uint32_t to) {
+        Quadric sum = quadrics[from];
+        sum.add(quadrics[to]);
+        glm::vec3 e = positions[to] - positions[from];
+        double cost = sum.error(positions[to]);
+        heap.push({ cost + LOD_EDGE_LENGTH_WEIGHT * glm::dot(e, e), cost, from, to, stamp[from], stamp[to] });
+    }
+
+    void pushCollapses(uint32_t p) {
+        gatherEdges(p, scratch);
+        VertexKind kind = classify(scratch);
+        for (const EdgeUse& e : scratch) {
+            uint32_t q = e.other;
+            // p -> q: p some e os triângulos dele passam a usar q
+            if (edgeAllowed(kind, e)) {
+                pushCollapse(p, q);
+            }
+        }
+    }
+
+    bool canCollapse(uint32_t from, uint32_t to) {
+        gatherEdges(from, scratch);
+        auto edge = std::find_if(scratch.begin(), scratch.end(), [to](const EdgeUse& e) { return e.other == to; });
+        if (edge == scratch.end() || !edgeAllowed(classify(scratch), *edge)) return false;
+
+        // Condição do elo: os vizinhos comuns são só os terceiros vértices dos triângulos da aresta;
+        // mais que isso fecharia um túnel e criaria geometria não-manifold
+        int shared = 0;
+        gatherEdges(to, scratchOther);
+        for (const EdgeUse& e : scratch) {
+            if (e.other == to) continue;
+            if (std::any_of(scratchOther.begin(), scratchOther.end(), [&e](const EdgeUse& o) { return o.other == e.other; }))
+                ++shared;
+        }
+        if (shared != edge->count) return false;
+
+        // Triângulos que sobrevivem não podem virar nem degenerar
+        glm::vec3 target = positions[to];
+        for (uint32_t t : incident[from]) {
+            if (!alive[t]) continue;
+            const Triangle& tri = triangles[t];
+            if (tri.corner[0] == to || tri.corner[1] == to || tri.corner[2] == to) continue;
+            glm::vec3 p[3], q[3];
+            for (int k = 0; k < 3; ++k) {
+                p[k] = positions[tri.corner[k]];
+                q[k] = tri.corner[k] == from ? target : p[k];
+            }
+            glm::vec3 before = glm::cross(p[1] - p[0], p[2] - p[0]);
+            glm::vec3 after = glm::cross(q[1] - q[0], q[2] - q[0]);
+            float lenBefore = glm::length(before), lenAfter = glm::length(after);
+            if (lenAfter <= 1e-12f * std::max(lenBefore, 1e-12f)) return false;
+            if (glm::dot(before, after) < LOD_MIN_NORMAL_DOT * lenBefore * lenAfter) return false;
+        }
+        return true;
+    }
+
+    // Vértice de renderização na posição to com os atributos mais próximos de source
+    uint32_t nearestWedge(uint32_t source, uint32_t to) const {
+        const Vertex& s = vertices[source];
+        uint32_t best = wedges[wedgeStart[to]];
+        float bestDist = -1.0f;
+        for (uint32_t i = wedgeStart[to]; i < wedgeStart[to + 1]; ++i) {
+            const Vertex& v = vertices[wedges[i]];
+            glm::vec3 dn = v.normal - s.normal, dc = v.color - s.color;
+            glm::vec2 dt = v.tex - s.tex;
+            float dist = glm::dot(dn, dn) + glm::dot(dc, dc) + glm::dot(dt, dt);
+            if (bestDist < 0.0f || dist < bestDist) {
+                bestDist = dist;
+                best = wedges[i];
+            }
+        }
+        return best;
+    }
+
+    void collapse(uint32_t from, uint32_t to) {
+        // Os triângulos da aresta dizem qual vértice de renderização em to substitui cada um em from
+        std::vector<std::pair<uint32_t, uint32_t>> remap;
+        for (uint32_t t : incident[from]) {
+            if (!alive[t]) continue;
+            const Triangle& tri = triangles[t];
+            int a = -1, b = -1;
+            for (int k = 0; k < 3; ++k) {
+                if (tri.corner[k] == from) a = k;
+                if (tri.corner[k] == to) b = k;
+            }
+            if (b < 0) continue;
+            if (std::none_of(remap.begin(), remap.end(), [&](const std::pair<uint32_t, uint32_t>& r) { return r.first == tri.render[a]; }))
+                remap.emplace_back(tri.render[a], tri.render[b]);
+            alive[t] = 0;
+            --liveTriangles;
+        }
+
+        std::vector<uint32_t>& target = incident[to];
+        target.erase(std::remove_if(target.begin(), target.end(), [this](uint32_t t) { return !alive[t]; }), target.end());
+        for (uint32_t t : incident[from]) {
+            if (!alive[t]) continue;
+            Triangle& tri = triangles[t];
+            for (int k = 0; k < 3; ++k) {
+                if (tri.corner[k] != from) continue;
+                auto it = std::find_if(remap.begin(), remap.end(), [&](const std::pair<uint32_t, uint32_t>& r) { return r.first == tri.render[k]; });
+                tri.render[k] = it != remap.end() ? it->second : nearestWedge(tri.render[k], to);
+                tri.corner[k] = to;
+            }
+            target.push_back(t);
+        }
+        incident[from].clear();
+        incident[from].shrink_to_fit();
+
+        dead[from] = 1;
+        quadrics[to].add(quadrics[from]);
+        ++stamp[to];
+
+        // O custo dos colapsos que envolvem to mudou; os vizinhos que colapsariam em to também
+        pushCollapses(to);
+        gatherEdges(to, scratchOther);
+        std::vector<uint32_t> neighbors;
+        for (const EdgeUse& e : scratchOther) neighbors.push_back(e.other);
+        for (uint32_t n : neighbors) {
+            gatherEdges(n, scratch);
+            VertexKind kind = classify(scratch);
+            for (const EdgeUse& e : scratch) {
+                if (e.other != to || !edgeAllowed(kind, e)) continue;
+                pushCollapse(n, to);
+            }
+        }
+    }
+
+    const Vertex* vertices;
+    size_t vertexCount;
+
+    std::vector<glm::vec3> positions;      // uma por posição soldada
+    std::vector<uint32_t> welded;          // vértice de renderização -> posição soldada
+    std::vector<uint32_t> wedgeStart, wedges;
+
+    std::vector<Triangle> triangles;
+    std::vector<uint8_t> alive;
+    size_t liveTriangles = 0;
+    std::vector<std::vector<uint32_t>> incident;
+    std::vector<uint8_t> dead;
+    std::vector<uint32_t> stamp;
+    std::vector<Quadric> quadrics;
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> heap;
+    std::vector<EdgeUse> scratch, scratchOther;
+};
+
+// Parâmetros da cadeia: cada nível tenta ficar com ratio dos triângulos do anterior
+struct LodChainSettings {
+    int maxLevels = 5;               // incluindo o LOD 0
+    float ratio = 0.5f;
+    size_t minTriangles = 32;        // não gera níveis menores que isso
+    float minReduction = 0.15f;      // para quando um nível não reduz pelo menos essa fração
+    float maxRelativeError = 0.25f;  // erro máximo de um nível, relativo à meia diagonal da malha
+};
+
+// Gera a cadeia em cascata (cada nível parte do anterior, o erro acumula)
+inline MeshLodChain buildLodChain(const MeshData& mesh, const LodChainSettings& settings = LodChainSettings()) {
+    MeshLodChain chain;
+    MeshLod base;
+    base.indexCount = static_cast<uint32_t>(mesh.indices.size());
+    chain.levels.push_back(base);
+    if (mesh.vertices.empty() || mesh.indices.size() / 3 < settings.minTriangles * 2) return chain;
+
+    glm::vec3 lo = mesh.vertices[0].pos, hi = lo;
+    for (const Vertex& v : mesh.vertices) {
+        lo = glm::min(lo, v.pos);
+        hi = glm::max(hi, v.pos);
+    }
+    float maxError = settings.maxRelativeError * 0.5f * glm::length(hi - lo);
+
+    MeshSimplifier simplifier(mesh.vertices.data(), mesh.vertices.size());
+    std::vector<uint32_t> current = mesh.indices;
+    float error = 0.0f;
+    while (static_cast<int>(chain.levels.size()) < settings.maxLevels) {
+        size_t target = static_cast<size_t>(current.size() / 3 * settings.ratio) * 3;
+        if (target / 3 < settings.minTriangles || error >= maxError) break;
+        float levelError = 0.0f;
+        std::vector<uint32_t> next = simplifier.simplify(current, target, maxError - error, &levelError);
+        if (next.empty() || next.size() > current.size() * (1.0f - settings.minReduction)) break;
+
+        error += levelError;
+        MeshLod lod;
+        lod.firstIndex = static_cast<uint32_t>(mesh.indices.size() + chain.indices.size());
+        lod.indexCount = static_cast<uint32_t>(next.size());
+        lod.error = error;
+        chain.levels.push_back(lod);
+        chain.indices.insert(chain.indices.end(), next.begin(), next.end());
+        current = std::move(next);
+    }
+    return chain;
+}
+
+// Limite padrão de erro na tela para trocar de nível, em pixels
+const float LOD_ERROR_PIXELS = 1.0f;
+// Histerese: só passa para um nível mais grosso quando o erro dele fica abaixo dessa fração do limite,
+// para um objeto parado na fronteira não alternar de nível a cada frame
+const float LOD_HYSTERESIS = 0.7f;
+
+// Nível mais grosso cujo erro projetado (error * pixelsPerUnit) fica dentro do limite. Refinar é imediato;
+// engrossar exige a folga da histerese. Os erros da cadeia crescem com o nível.
+inline int selectLod(const std::vector<MeshLod>& lods, int current, float pixelsPerUnit, float thresholdPixels = LOD_ERROR_PIXELS) {
+    int target = 0, relaxed = 0;
+    for (size_t i = 1; i < lods.size(); ++i) {
+        float pixels = lods[i].error * pixelsPerUnit;
+        if (pixels <= thresholdPixels) target = static_cast<int>(i);
+        if (pixels <= thresholdPixels * LOD_HYSTERESIS) relaxed = static_cast<int>(i);
+    }
+    if (target <= current) return target;
+    return std::max(current, relaxed);
+}
+
+// Duração do cross-fade entre níveis, em frames (um passo do pontilhado 4x4 por frame)
+const int LOD_FADE_FRAMES = 16;
+
+// Nível de um objeto e a transição em curso: durante o cross-fade o nível anterior continua sendo
+// desenhado, com o padrão de pontilhado complementar ao do nível novo
+struct LodState {
+    int current = 0;
+    int previous = -1;     // -1: sem transição
+    float fade = 1.0f;     // fração dos pixels que já mostram o nível atual
+};
+
+// Avança a transição e aplica a escolha do frame; fadeFrames = 0 troca de nível direto.
+// Uma troca nova só começa quando a anterior termina.
+inline void updateLod(LodState& state, int selected, int fadeFrames) {
+    if (state.previous >= 0) {
+        state.fade = fadeFrames > 0 ? state.fade + 1.0f / fadeFrames : 1.0f;
+        if (state.fade < 1.0f) return;
+        state.previous = -1;
+        state.fade = 1.0f;
+    }
+    if (selected == state.current) return;
+    if (fadeFrames > 0) {
+        state.previous = state.current;
+        state.fade = 1.0f / fadeFrames;
+    }
+    state.current = selected;
+}
+
+#endif
@@ -0,0 +1,379 @@
+#ifndef MESH_OPT_H
+#define MESH_OPT_H
+
+// Otimização da ordem dos triângulos e dos vértices no bake, antes da cadeia de LODs:
+//   1. ordem de cache (Tipsify, Sander, Nehab e Barczak 2007): triângulos em leque em torno do vértice
+//      que ainda está no cache de pós-transformação;
+//   2. overdraw: a sequência é cortada em clusters que quase não pioram o cache, e os clusters voltados
+//      para fora da malha vão primeiro, para o early-z descartar mais fragmentos dos de trás;
+//   3. busca de vértices: os vértices são renumerados na ordem do primeiro uso (LOD 0 e depois os LODs).
+//
+// ACMR = vértices transformados por triângulo (0.5 é o ideal numa grade regular, 3 é o pior caso);
+// ATVR = vértices transformados por vértice único (1 é o ideal).
+
+#include "mesh.h"
+#include "meshlod.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Tamanho do cache FIFO simulado: o das GPUs antigas; as atuais têm mais espaço e só ganham com a ordem
+const size_t VERTEX_CACHE_SIZE = 16;
+// Um cluster é cortado quando o ACMR local volta a ficar abaixo dessa fração do ACMR do trecho inteiro
+const float OVERDRAW_CACHE_THRESHOLD = 1.05f;
+// Resolução de cada vista do rasterizador que mede o overdraw
+const int OVERDRAW_VIEWPORT = 256;
+
+struct VertexCacheStats {
+    float acmr = 0.0f;
+    float atvr = 0.0f;
+};
+
+// Simula o cache FIFO sobre uma lista de índices (uint16_t ou uint32_t)
+template <typename Index>
+VertexCacheStats analyzeVertexCache(const Index* indices, size_t indexCount, size_t vertexCount,
+                                    size_t cacheSize = VERTEX_CACHE_SIZE) {
+    VertexCacheStats stats;
+    if (indexCount < 3 || vertexCount == 0) return stats;
+
+    // Carimbo de quando cada vértice entrou no cache: está lá se entrou há no máximo cacheSize entradas
+    std::vector<size_t> entered(vertexCount, 0);
+    std::vector<uint8_t> used(vertexCount, 0);
+    size_t timestamp = cacheSize + 1, misses = 0, unique = 0;
+    for (size_t i = 0; i < indexCount; ++i) {
+        size_t v = indices[i];
+        if (timestamp - entered[v] > cacheSize) {
+            entered[v] = timestamp++;
+            ++misses;
+        }
+        if (!used[v]) {
+            used[v] = 1;
+            ++unique;
+        }
+    }
+    stats.acmr = static_cast<float>(misses) / static_cast<float>(indexCount / 3);
+    stats.atvr = static_cast<float>(misses) / static_cast<float>(unique);
+    return stats;
+}
+
+inline VertexCacheStats analyzeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount) {
+    return analyzeVertexCache(indices.data(), indices.size(), vertexCount);
+}
+
+// Reordena os triângulos para o cache. clusterStarts (opcional) recebe o primeiro triângulo de cada
+// trecho contínuo: um novo trecho começa quando o leque chega a um beco sem saída e a busca salta
+inline std::vector<uint32_t> optimizeVertexCache(const std::vector<uint32_t>& indices, size_t vertexCount,
+                                                 std::vector<uint32_t>* clusterStarts = nullptr,
+                                                 size_t cacheSize = VERTEX_CACHE_SIZE) {
+    size_t triangleCount = indices.size() / 3;
+    std::vector<uint32_t> result;
+    result.reserve(triangleCount * 3);
+    if (clusterStarts) clusterStarts->clear();
+    if (triangleCount == 0) return result;
+
+    // Triângulos de cada vértice (CSR) e quantos deles ainda não saíram
+    std::vector<uint32_t> live(vertexCount, 0), offsets(vertexCount + 1, 0);
+    for (size_t i = 0; i < triangleCount * 3; ++i) ++live[indices[i]];
+    for (size_t v = 0; v < vertexCount; ++v) offsets[v + 1] = offsets[v] + live[v];
+    std::vector<uint32_t> adjacency(offsets[vertexCount]), fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t)
+        for (int c = 0; c < 3; ++c) adjacency[fill[indices[t * 3 + c]]++] = static_cast<uint32_t>(t);
+
+    std::vector<size_t> entered(vertexCount, 0);
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> deadEnd, candidates;
+    size_t timestamp = cacheSize + 1, cursor = 0;
+    const uint32_t none = std::numeric_limits<uint32_t>::max();
+
+    uint32_t fan = 0;
+    while (cursor < vertexCount && live[cursor] == 0) ++cursor;
+    fan = static_cast<uint32_t>(cursor);
+    bool jumped = true;
+    while (fan != none) {
+        if (jumped && clusterStarts) clusterStarts->push_back(static_cast<uint32_t>(result.size() / 3));
+
+        // Emite todos os triângulos pendentes em torno do vértice do leque
+        candidates.clear();
+        for (uint32_t k = offsets[fan]; k < offsets[fan + 1]; ++k) {
+            uint32_t t = adjacency[k];
+            if (emitted[t]) continue;
+            emitted[t] = 1;
+            for (int c = 0; c < 3; ++c) {
+                uint32_t v = indices[t * 3 + c];
+                result.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+                if (timestamp - entered[v] > cacheSize) entered[v] = timestamp++;
+            }
+        }
+
+        // Próximo leque: o candidato com triângulos pendentes que ainda estará no cache depois de
+        // emiti-los, preferindo o que entrou há mais tempo (sairia primeiro)
+        uint32_t next = none;
+        size_t best = 0;
+        for (uint32_t v : candidates) {
+            if (live[v] == 0) continue;
+            size_t priority = 0;
+            size_t age = timestamp - entered[v];
+            if (age + 2 * live[v] <= cacheSize) priority = age;
+            if (next == none || priority > best) {
+                best = priority;
+                next = v;
+            }
+        }
+        jumped = next == none;
+        if (jumped) {
+            // Beco sem saída: volta pelos vértices emitidos mais recentes e, se nenhum tiver
+            // triângulos pendentes, segue a varredura em ordem de índice
+            while (!deadEnd.empty() && next == none) {
+                uint32_t v = deadEnd.back();
+                deadEnd.pop_back();
+                if (live[v] > 0) next = v;
+            }
+            while (next == none && cursor < vertexCount) {
+                if (live[cursor] > 0) next = static_cast<uint32_t>(cursor);
+                else ++cursor;
+            }
+        }
+        fan = next;
+    }
+    return result;
+}
+
+// Corta cada trecho de optimizeVertexCache em clusters menores, sempre que o ACMR acumulado do cluster
+// atual fica dentro de threshold vezes o ACMR do trecho (com o cache esvaziado em cada corte)
+inline std::vector<uint32_t> splitCacheClusters(const std::vector<uint32_t>& indices, size_t vertexCount,
+                                                const std::vector<uint32_t>& hardStarts,
+                                                float threshold = OVERDRAW_CACHE_THRESHOLD,
+                                                size_t cacheSize = VERTEX_CACHE_SIZE) {
+    size_t triangleCount = indices.size() / 3;
+    std::vector<uint32_t> starts;
+    std::vector<size_t> entered(vertexCount, 0);
+    size_t timestamp = cacheSize + 1;
+
+    auto misses = [&](size_t t) {
+        size_t count = 0;
+        for (int c = 0; c < 3; ++c) {
+            uint32_t v = indices[t * 3 + c];
+            if (timestamp - entered[v] > cacheSize) {
+                entered[v] = timestamp++;
+                ++count;
+            }
+        }
+        return count;
+    };
+
+    for (size_t h = 0; h < hardStarts.size(); ++h) {
+        size_t begin = hardStarts[h];
+        size_t end = h + 1 < hardStarts.size() ? hardStarts[h + 1] : triangleCount;
+        if (begin >= end) continue;
+
+        timestamp += cacheSize + 1;
+        size_t total = 0;
+        for (size_t t = begin; t < end; ++t) total += misses(t);
+        float limit = threshold * static_cast<float>(total) / static_cast<float>(end - begin);
+
+        timestamp += cacheSize + 1;
+        starts.push_back(static_cast<uint32_t>(begin));
+        size_t clusterBegin = begin, clusterMisses = 0;
+        for (size_t t = begin; t < end; ++t) {
+            clusterMisses += misses(t);
+            float acmr = static_cast<float>(clusterMisses) / static_cast<float>(t - clusterBegin + 1);
+            if (acmr <= limit && t + 1 < end) {
+                starts.push_back(static_cast<uint32_t>(t + 1));
+                clusterBegin = t + 1;
+                clusterMisses = 0;
+                timestamp += cacheSize + 1;
+            }
+        }
+    }
+    return starts;
+}
+
+// Ordena os clusters pela orientação em relação ao centro da malha: os que olham para fora são desenhados
+// primeiro. A chave é a média, ponderada pela área, de dot(centro do triângulo - centro da malha, normal);
+// com a média por triângulo, uma faixa que dá a volta na malha não perde a chave por ter normais opostas.
+inline std::vector<uint32_t> sortClustersForOverdraw(const std::vector<uint32_t>& indices, const Vertex* vertices,
+                                                     const std::vector<uint32_t>& clusterStarts) {
+    size_t triangleCount = indices.size() / 3;
+    size_t clusterCount = clusterStarts.size();
+
+    // Por cluster: soma de dot(centro, n), soma de n e soma de |n|, com n = produto vetorial (2x a área);
+    // o centro da malha só entra no fim, porque dot(centro - M, n) = dot(centro, n) - dot(M, n)
+    glm::dvec3 meshCenter(0.0);
+    double meshArea = 0.0;
+    std::vector<glm::dvec3> normals(clusterCount, glm::dvec3(0.0));
+    std::vector<double> reach(clusterCount, 0.0), areas(clusterCount, 0.0);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        size_t end = c + 1 < clusterCount ? clusterStarts[c + 1] : triangleCount;
+        for (size_t t = clusterStarts[c]; t < end; ++t) {
+            glm::dvec3 p0(vertices[indices[t * 3 + 0]].pos);
+            glm::dvec3 p1(vertices[indices[t * 3 + 1]].pos);
+            glm::dvec3 p2(vertices[indices[t * 3 + 2]].pos);
+            glm::dvec3 n = glm::cross(p1 - p0, p2 - p0);
+            glm::dvec3 center = (p0 + p1 + p2) / 3.0;
+            double area = glm::length(n);
+            reach[c] += glm::dot(center, n);
+            normals[c] += n;
+            areas[c] += area;
+            meshCenter += center * area;
+        }
+        meshArea += areas[c];
+    }
+    if (meshArea > 0.0) meshCenter /= meshArea;
+
+    std::vector<double> key(clusterCount, 0.0);
+    for (size_t c = 0; c < clusterCount; ++c)
+        if (areas[c] > 0.0) key[c] = (reach[c] - glm::dot(meshCenter, normals[c])) / areas[c];
+
+    std::vector<uint32_t> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; ++c) order[c] = static_cast<uint32_t>(c);
+    std::stable_sort(order.begin(), order.end(), [&key](uint32_t a, uint32_t b) { return key[a] > key[b]; });
+
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    for (uint32_t c : order) {
+        size_t end = c + 1 < clusterCount ? clusterStarts[c + 1] : triangleCount;
+        result.insert(result.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + end * 3);
+    }
+    return result;
+}
+
+// Renumera os vértices na ordem do primeiro uso pelo LOD 0 e depois pelos LODs, para a busca de
+// atributos andar para frente no VBO. Vértices sem uso vão para o fim.
+inline void optimizeVertexFetch(MeshData& mesh, MeshLodChain& chain) {
+    const uint32_t none = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> remap(mesh.vertices.size(), none);
+    std::vector<Vertex> vertices;
+    vertices.reserve(mesh.vertices.size());
+    auto visit = [&](std::vector<uint32_t>& indices) {
+        for (uint32_t& index : indices) {
+            if (remap[index] == none) {
+                remap[index] = static_cast<uint32_t>(vertices.size());
+                vertices.push_back(mesh.vertices[index]);
+            }
+            index = remap[index];
+        }
+    };
+    visit(mesh.indices);
+    visit(chain.indices);
+    for (size_t v = 0; v < mesh.vertices.size(); ++v)
+        if (remap[v] == none) vertices.push_back(mesh.vertices[v]);
+    mesh.vertices = std::move(vertices);
+}
+
+// Overdraw medido por um rasterizador de CPU: a malha é desenhada com teste de profundidade nas seis
+// vistas ortográficas dos eixos, sem descarte de faces (o Cena_Castle não liga o GL_CULL_FACE).
+// overdraw = fragmentos que passaram no teste / pixels cobertos (1 é o ideal).
+struct OverdrawStats {
+    size_t covered = 0;
+    size_t shaded = 0;
+    float overdraw = 0.0f;
+};
+
+template <typename Index>
+OverdrawStats analyzeOverdraw(const Index* indices, size_t indexCount, const Vertex* vertices, size_t vertexCount,
+                              int viewport = OVERDRAW_VIEWPORT) {
+    OverdrawStats stats;
+    if (indexCount < 3 || vertexCount == 0) return stats;
+
+    glm::vec3 lo = vertices[0].pos, hi = lo;
+    for (size_t v = 1; v < vertexCount; ++v) {
+        lo = glm::min(lo, vertices[v].pos);
+        hi = glm::max(hi, vertices[v].pos);
+    }
+    float extent = std::max(std::max(hi.x - lo.x, hi.y - lo.y), std::max(hi.z - lo.z, 1e-20f));
+
+    std::vector<float> depth(static_cast<size_t>(viewport) * viewport);
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int side = 0; side < 2; ++side) {
+            std::fill(depth.begin(), depth.end(), std::numeric_limits<float>::max());
+            int ax = (axis + 1) % 3, ay = (axis + 2) % 3;
+            for (size_t i = 0; i + 2 < indexCount; i += 3) {
+                glm::vec3 p[3];
+                for (int c = 0; c < 3; ++c) {
+                    const glm::vec3& pos = vertices[indices[i + c]].pos;
+                    p[c].x = (pos[ax] - lo[ax]) / extent * viewport;
+                    p[c].y = (pos[ay] - lo[ay]) / extent * viewport;
+                    float z = (pos[axis] - lo[axis]) / extent;
+                    p[c].z = side == 0 ? z : 1.0f - z;
+                }
+                float area = (p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[2].x - p[0].x) * (p[1].y - p[0].y);
+                if (area == 0.0f) continue;
+
+                int minX = std::max(0, static_cast<int>(std::floor(std::min(std::min(p[0].x, p[1].x), p[2].x))));
+                int maxX = std::min(viewport - 1, static_cast<int>(std::ceil(std::max(std::max(p[0].x, p[1].x), p[2].x))));
+                int minY = std::max(0, static_cast<int>(std::floor(std::min(std::min(p[0].y, p[1].y), p[2].y))));
+                int maxY = std::min(viewport - 1, static_cast<int>(std::ceil(std::max(std::max(p[0].y, p[1].y), p[2].y))));
+                for (int y = minY; y <= maxY; ++y) {
+                    for (int x = minX; x <= maxX; ++x) {
+                        // Funções de aresta no centro do pixel (as duas orientações valem, sem culling)
+                        float px = x + 0.5f, py = y + 0.5f;
+                        float w0 = ((p[2].x - p[1].x) * (py - p[1].y) - (p[2].y - p[1].y) * (px - p[1].x)) / area;
+                        float w1 = ((p[0].x - p[2].x) * (py - p[2].y) - (p[0].y - p[2].y) * (px - p[2].x)) / area;
+                        float w2 = 1.0f - w0 - w1;
+                        if (w0 < 0.0f || w1 < 0.0f || w2 < 0.0f) continue;
+                        float z = w0 * p[0].z + w1 * p[1].z + w2 * p[2].z;
+                        float& stored = depth[static_cast<size_t>(y) * viewport + x];
+                        if (z < stored) {
+                            stored = z;
+                            ++stats.shaded;
+                        }
+                    }
+                }
+            }
+            for (float z : depth)
+                if (z != std::numeric_limits<float>::max()) ++stats.covered;
+        }
+    }
+    stats.overdraw = stats.covered ? static_cast<float>(stats.shaded) / static_cast<float>(stats.covered) : 0.0f;
+    return stats;
+}
+
+// Resultado da otimização de uma malha, para os relatórios do bake e da carga
+struct MeshOptReport {
+    bool optimized = false;              // false quando a malha veio pronta do .meshbin
+    VertexCacheStats before, after;      // do LOD 0
+    OverdrawStats overdrawBefore, overdrawAfter;   // só com measureOverdraw
+};
+
+// Estágio 1 e 2 sobre o LOD 0 (antes de buildLodChain, para os LODs herdarem a ordem)
+inline MeshOptReport optimizeMeshOrder(MeshData& mesh, bool measureOverdraw = false) {
+    MeshOptReport report;
+    report.optimized = true;
+    size_t vertexCount = mesh.vertices.size();
+    report.before = analyzeVertexCache(mesh.indices, vertexCount);
+    if (measureOverdraw)
+        report.overdrawBefore = analyzeOverdraw(mesh.indices.data(), mesh.indices.size(), mesh.vertices.data(), vertexCount);
+
+    std::vector<uint32_t> hardStarts;
+    std::vector<uint32_t> cacheOrder = optimizeVertexCache(mesh.indices, vertexCount, &hardStarts);
+    std::vector<uint32_t> clusters = splitCacheClusters(cacheOrder, vertexCount, hardStarts);
+    mesh.indices = sortClustersForOverdraw(cacheOrder, mesh.vertices.data(), clusters);
+    return report;
+}
+
+// Estágio 1 em cada LOD gerado e estágio 3 na malha inteira; completa o relatório de optimizeMeshOrder
+inline void optimizeMeshLayout(MeshData& mesh, MeshLodChain& chain, MeshOptReport& report, bool measureOverdraw = false) {
+    size_t vertexCount = mesh.vertices.size();
+    for (size_t i = 1; i < chain.levels.size(); ++i) {
+        const MeshLod& lod = chain.levels[i];
+        auto first = chain.indices.begin() + (lod.firstIndex - mesh.indices.size());
+        std::vector<uint32_t> level(first, first + lod.indexCount);
+        level = optimizeVertexCache(level, vertexCount);
+        std::copy(level.begin(), level.end(), first);
+    }
+    optimizeVertexFetch(mesh, chain);
+
+    report.after = analyzeVertexCache(mesh.indices, vertexCount);
+    if (measureOverdraw)
+        report.overdrawAfter = analyzeOverdraw(mesh.indices.data(), mesh.indices.size(), mesh.vertices.data(), vertexCount);
+}
+
+#endif
@@ -0,0 +1,627 @@
+#ifndef OBJ_PARSER_H
+#define OBJ_PARSER_H
+
+// Leitor rápido de .obj/.mtl para malhas grandes (scans de centenas de MB). Mesma saída do
+// loadObjMeshTinyObj (MeshData indexada e material principal), em três etapas:
+//   1. o arquivo é mapeado em memória e dividido em blocos terminados em fim de linha, um por thread;
+//      cada thread acha as quebras de linha com SSE2 (16 bytes por comparação) e lê os números com
+//      std::from_chars, guardando posições, normais, uvs e cantos de face do seu bloco;
+//   2. as contagens de cada bloco viram deslocamentos: índices negativos (relativos) são corrigidos
+//      e todos os índices são validados;
+//   3. as faces são trianguladas na ordem do arquivo, com a mesma regra do TinyObjLoader para
+//      quadriláteros, e os vértices únicos saem de uma tabela hash de endereçamento aberto.
+// Faces com mais de 4 vértices são trianguladas em leque (o TinyObjLoader usa ear clipping); o
+// loadObjMesh volta ao TinyObjLoader quando o arquivo tem alguma, para a saída ser sempre a mesma.
+
+#include "mesh.h"
+#include "mappedfile.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OBJ_PARSER_SSE2 1
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+struct ObjParseStats {
+    size_t bytes = 0;
+    unsigned threads = 0;
+    size_t positions = 0, normals = 0, texcoords = 0, faces = 0, triangles = 0;
+    size_t largePolygons = 0;   // faces com mais de 4 vértices (triangulação diferente do TinyObjLoader)
+    double parseMs = 0.0, mergeMs = 0.0, indexMs = 0.0;
+};
+
+class ObjParser {
+public:
+    static const size_t MIN_CHUNK_BYTES = 1 << 20;   // abaixo disso uma thread só é mais rápida
+
+    explicit ObjParser(unsigned threadCount = 0) : threadCount(threadCount) {}
+
+    bool parse(const std::string& objPath, MeshData& mesh, MeshMaterial& material, std::string& err) {
+        stats = ObjParseStats();
+        mesh = MeshData();
+        material = MeshMaterial();
+
+        MappedFile file;
+        if (!file.open(objPath)) {
+            err = "Erro ao abrir " + objPath;
+            return false;
+        }
+        const char* data = reinterpret_cast<const char*>(file.data());
+        size_t size = file.size();
+        stats.bytes = size;
+
+        // Etapa 1: blocos terminados em '\n', lidos em paralelo
+        auto start = std::chrono::steady_clock::now();
+        unsigned threads = threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+        threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, size / MIN_CHUNK_BYTES)));
+        std::vector<const char*> bounds{ data };
+        for (unsigned i = 1; i < threads; ++i) {
+            const char* split = std::max(bounds.back(), data + size * i / threads);
+            const char* newline = findNewline(split, data + size);
+            bounds.push_back(newline < data + size ? newline + 1 : data + size);
+        }
+        bounds.push_back(data + size);
+        std::vector<Chunk> chunks(bounds.size() - 1);
+        runParallel(chunks.size(), [&](size_t c) { parseChunk(bounds[c], bounds[c + 1], chunks[c]); });
+        stats.threads = static_cast<unsigned>(chunks.size());
+        stats.parseMs = elapsedSince(start);
+
+        // Etapa 2: junta os atributos e corrige os índices de cada bloco
+        start = std::chrono::steady_clock::now();
+        size_t line = 0;
+        for (const Chunk& chunk : chunks) {
+            if (!chunk.error.empty()) {
+                err = objPath + ":" + std::to_string(line + chunk.errorLine) + ": " + chunk.error;
+                return false;
+            }
+            line += chunk.lines;
+        }
+        if (!merge(chunks, err)) {
+            err = objPath + ": " + err;
+            return false;
+        }
+        stats.mergeMs = elapsedSince(start);
+
+        // Etapa 3: triangulação na ordem do arquivo e vértices únicos
+        start = std::chrono::steady_clock::now();
+        buildMesh(chunks, mesh);
+        stats.indexMs = elapsedSince(start);
+
+        std::string baseDir = std::filesystem::path(objPath).parent_path().string();
+        for (const Chunk& chunk : chunks) {
+            for (const std::string& mtllib : chunk.mtllibs)
+                if (loadFirstMaterial(baseDir, mtllib, material)) return true;
+        }
+        return true;
+    }
+
+    const ObjParseStats& lastStats() const { return stats; }
+
+private:
+    // Índices de um canto de face; relative marca os que vieram negativos (relativos ao bloco)
+    struct Corner {
+        int32_t v, t, n;
+    };
+
+    enum : uint8_t { RELATIVE_V = 1, RELATIVE_T = 2, RELATIVE_N = 4 };
+
+    struct Chunk {
+        std::vector<float> positions, normals, texcoords;
+        std::vector<Corner> corners;
+        std::vector<uint8_t> relative;       // uma máscara por canto
+        std::vector<uint32_t> faceSizes;
+        std::vector<std::string> mtllibs;    // linhas "mtllib", na ordem do arquivo
+        size_t lines = 0;
+        size_t errorLine = 0;
+        std::string error;
+    };
+
+    static bool isSpace(char c) { return c == ' ' || c == '\t'; }
+
+    static int ctz(unsigned bits) {
+#ifdef _MSC_VER
+        unsigned long index;
+        _BitScanForward(&index, bits);
+        return static_cast<int>(index);
+#else
+        return __builtin_ctz(bits);
+#endif
+    }
+
+    // Primeiro '\n' em [p, end) (ou end)
+    static const char* findNewline(const char* p, const char* end) {
+#ifdef OBJ_PARSER_SSE2
+        const __m128i newline = _mm_set1_epi8('\n');
+        for (; p + 16 <= end; p += 16) {
+            unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), newline)));
+            if (mask) return p + ctz(mask);
+        }
+#endif
+        while (p < end && *p != '\n') ++p;
+        return p;
+    }
+
+    static const char* skipSpaces(const char* p, const char* end) {
+        while (p < end && isSpace(*p)) ++p;
+        return p;
+    }
+
+    static const char* skipToken(const char* p, const char* end) {
+        while (p < end && !isSpace(*p) && *p != '\r') ++p;
+        return p;
+    }
+
+    // Como o parseReal do TinyObjLoader: consome o próximo token e devolve `fallback` se não for número
+    static float parseFloat(const char*& p, const char* end, float fallback = 0.0f) {
+        p = skipSpaces(p, end);
+        const char* tokenEnd = skipToken(p, end);
+        const char* first = p < tokenEnd && *p == '+' ? p + 1 : p;   // from_chars não aceita '+'
+        float value = fallback;
+        auto result = std::from_chars(first, tokenEnd, value);
+        if (result.ec == std::errc::result_out_of_range) {
+            value = std::strtof(std::string(first, tokenEnd).c_str(), nullptr);
+        } else if (result.ec != std::errc()) {
+            value = fallback;
+        }
+        p = tokenEnd;
+        return value;
+    }
+
+    // atoi: sinal e dígitos, para no primeiro caractere que não é dígito
+    static int parseInt(const char*& p, const char* end) {
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+        int value = 0;
+        while (p < end && static_cast<unsigned>(*p - '0') < 10u) value = value * 10 + (*p++ - '0');
+        return negative ? -value : value;
+    }
+
+    // Índice do OBJ (1-based, negativo = relativo) para 0-based. allowZero: uv e normal com 0 viram -1.
+    static bool fixIndex(int index, size_t count, int32_t& out, uint8_t& relative, uint8_t bit, bool allowZero) {
+        if (index > 0) {
+            out = index - 1;
+            return true;
+        }
+        if (index == 0) {
+            out = -1;
+            return allowZero;
+        }
+        out = static_cast<int32_t>(count) + index;   // relativo ao início do bloco; corrigido na etapa 2
+        relative |= bit;
+        return true;
+    }
+
+    static void parseChunk(const char* p, const char* end, Chunk& chunk) {
+        size_t estimate = static_cast<size_t>(end - p) / 32;
+        chunk.positions.reserve(estimate);
+        chunk.corners.reserve(estimate);
+        chunk.relative.reserve(estimate);
+        while (p < end) {
+            const char* eol = findNewline(p, end);
+            ++chunk.lines;
+            const char* s = skipSpaces(p, eol);
+            p = eol + 1;
+            if (s == eol) continue;
+            auto at = [s, eol](size_t k) { return s + k < eol ? s[k] : '\n'; };
+
+            if (s[0] == 'v') {
+                if (isSpace(at(1))) {
+                    s += 2;
+                    for (int k = 0; k < 3; ++k) chunk.positions.push_back(parseFloat(s, eol));
+                } else if (at(1) == 'n' && isSpace(at(2))) {
+                    s += 3;
+                    for (int k = 0; k < 3; ++k) chunk.normals.push_back(parseFloat(s, eol));
+                } else if (at(1) == 't' && isSpace(at(2))) {
+                    s += 3;
+                    for (int k = 0; k < 2; ++k) chunk.texcoords.push_back(parseFloat(s, eol));
+                }
+            } else if (s[0] == 'f' && isSpace(at(1))) {
+                s = skipSpaces(s + 2, eol);
+                size_t vertexCount = chunk.positions.size() / 3, normalCount = chunk.normals.size() / 3;
+                size_t texcoordCount = chunk.texcoords.size() / 2;
+                uint32_t size = 0;
+                while (s < eol && *s != '#' && *s != '\r') {
+                    Corner corner{ -1, -1, -1 };
+                    uint8_t relative = 0;
+                    bool ok = fixIndex(parseInt(s, eol), vertexCount, corner.v, relative, RELATIVE_V, false);
+                    while (s < eol && *s != '/' && !isSpace(*s) && *s != '\r') ++s;
+                    if (ok && s < eol && *s == '/') {
+                        ++s;
+                        if (s < eol && *s == '/') {
+                            ++s;
+                            ok = fixIndex(parseInt(s, eol), normalCount, corner.n, relative, RELATIVE_N, true);
+                        } else {
+                            ok = fixIndex(parseInt(s, eol), texcoordCount, corner.t, relative, RELATIVE_T, true);
+                            while (s < eol && *s != '/' && !isSpace(*s) && *s != '\r') ++s;
+                            if (ok && s < eol && *s == '/') {
+                                ++s;
+                                ok = fixIndex(parseInt(s, eol), normalCount, corner.n, relative, RELATIVE_N, true);
+                            }
+                        }
+                        while (s < eol && !isSpace(*s) && *s != '\r') ++s;
+                    }
+                    if (!ok) {
+                        chunk.error = "linha 'f' inválida (índice de vértice zero)";
+                        chunk.errorLine = chunk.lines;
+                        return;
+                    }
+                    chunk.corners.push_back(corner);
+                    chunk.relative.push_back(relative);
+                    ++size;
+                    while (s < eol && (isSpace(*s) || *s == '\r')) ++s;
+                }
+                chunk.faceSizes.push_back(size);
+            } else if (eol - s > 6 && std::memcmp(s, "mtllib", 6) == 0 && isSpace(s[6])) {
+                const char* nameEnd = eol;
+                while (nameEnd > s && (nameEnd[-1] == '\r' || isSpace(nameEnd[-1]))) --nameEnd;
+                chunk.mtllibs.emplace_back(s + 7, nameEnd);
+            }
+        }
+    }
+
+    // Deslocamento de cada bloco nos arrays globais, correção dos índices relativos e checagem de limites
+    bool merge(std::vector<Chunk>& chunks, std::string& err) {
+        size_t positionCount = 0, normalCount = 0, texcoordCount = 0;
+        std::vector<size_t> positionBase, normalBase, texcoordBase;
+        for (const Chunk& chunk : chunks) {
+            positionBase.push_back(positionCount);
+            normalBase.push_back(normalCount);
+            texcoordBase.push_back(texcoordCount);
+            positionCount += chunk.positions.size() / 3;
+            normalCount += chunk.normals.size() / 3;
+            texcoordCount += chunk.texcoords.size() / 2;
+            stats.faces += chunk.faceSizes.size();
+        }
+        stats.positions = positionCount;
+        stats.normals = normalCount;
+        stats.texcoords = texcoordCount;
+
+        positions.resize(positionCount * 3);
+        normals.resize(normalCount * 3);
+        texcoords.resize(texcoordCount * 2);
+        std::vector<std::string> errors(chunks.size());
+        runParallel(chunks.size(), [&](size_t c) {
+            Chunk& chunk = chunks[c];
+            std::copy(chunk.positions.begin(), chunk.positions.end(), positions.begin() + positionBase[c] * 3);
+            std::copy(chunk.normals.begin(), chunk.normals.end(), normals.begin() + normalBase[c] * 3);
+            std::copy(chunk.texcoords.begin(), chunk.texcoords.end(), texcoords.begin() + texcoordBase[c] * 2);
+            std::vector<float>().swap(chunk.positions);
+            std::vector<float>().swap(chunk.normals);
+            std::vector<float>().swap(chunk.texcoords);
+
+            for (size_t i = 0; i < chunk.corners.size(); ++i) {
+                Corner& corner = chunk.corners[i];
+                uint8_t relative = chunk.relative[i];
+                if (relative & RELATIVE_V) corner.v += static_cast<int32_t>(positionBase[c]);
+                if (relative & RELATIVE_T) corner.t += static_cast<int32_t>(texcoordBase[c]);
+                if (relative & RELATIVE_N) corner.n += static_cast<int32_t>(normalBase[c]);
+                if (corner.v < 0 || corner.v >= static_cast<int64_t>(positionCount) ||
+                    corner.t < -1 || corner.t >= static_cast<int64_t>(texcoordCount) ||
+                    corner.n < -1 || corner.n >= static_cast<int64_t>(normalCount)) {
+                    errors[c] = "índice de face fora do intervalo";
+                    return;
+                }
+            }
+            std::vector<uint8_t>().swap(chunk.relative);
+        });
+        for (const std::string& e : errors) {
+            if (!e.empty()) {
+                err = e;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Tabela hash (v, n, t) -> vértice com endereçamento aberto: bem mais rápida que unordered_map
+    // para dezenas de milhões de cantos. Dobra de tamanho quando passa de metade cheia, porque malhas com
+    // normal por face têm bem mais cantos únicos que posições e a estimativa inicial não é um limite
+    class VertexTable {
+    public:
+        explicit VertexTable(size_t expected) { allocate(capacityFor(expected)); }
+
+        // Devolve o índice do vértice; `created` indica que o canto ainda não existia
+        uint32_t insert(const Corner& key, uint32_t next, bool& created) {
+            if ((used + 1) * 2 > slots.size()) grow();
+            for (size_t index = home(key);; index = (index + 1) & mask) {
+                Slot& slot = slots[index];
+                if (slot.key.v < 0) {
+                    slot.key = key;
+                    slot.value = next;
+                    ++used;
+                    created = true;
+                    return next;
+                }
+                if (slot.key.v == key.v && slot.key.n == key.n && slot.key.t == key.t) {
+                    created = false;
+                    return slot.value;
+                }
+            }
+        }
+
+    private:
+        // Chave e valor juntos (16 bytes): cada busca toca uma linha de cache só
+        struct Slot {
+            Corner key;
+            uint32_t value;
+        };
+
+        static size_t capacityFor(size_t expected) {
+            size_t capacity = 16;
+            while (capacity < expected * 2) capacity <<= 1;
+            return capacity;
+        }
+
+        size_t home(const Corner& key) const {
+            uint64_t h = static_cast<uint32_t>(key.v) * 0x9E3779B97F4A7C15ull ^ static_cast<uint32_t>(key.n) * 0xC2B2AE3D27D4EB4Full ^
+                         static_cast<uint32_t>(key.t) * 0x165667B19E3779F9ull;
+            return static_cast<size_t>(h ^ (h >> 29)) & mask;
+        }
+
+        void allocate(size_t capacity) {
+            slots.assign(capacity, Slot{ { -1, -1, -1 }, 0 });
+            mask = capacity - 1;
+        }
+
+        void grow() {
+            std::vector<Slot> old;
+            old.swap(slots);
+            allocate(old.size() * 2);
+            for (const Slot& slot : old) {
+                if (slot.key.v < 0) continue;
+                size_t index = home(slot.key);
+                while (slots[index].key.v >= 0) index = (index + 1) & mask;
+                slots[index] = slot;
+            }
+        }
+
+        std::vector<Slot> slots;
+        size_t mask = 0, used = 0;
+    };
+
+    void buildMesh(const std::vector<Chunk>& chunks, MeshData& mesh) {
+        size_t cornerCount = 0;
+        bool positionsOnly = true;   // sem uv nem normal: o próprio índice de posição identifica o vértice
+        for (const Chunk& chunk : chunks) {
+            cornerCount += chunk.corners.size();
+            for (const Corner& corner : chunk.corners) positionsOnly = positionsOnly && corner.t < 0 && corner.n < 0;
+        }
+        mesh.indices.reserve(cornerCount + cornerCount / 2);
+
+        std::vector<Corner> unique;
+        std::vector<uint32_t> byPosition;
+        VertexTable table(positionsOnly ? 0 : std::min(cornerCount, positions.size() / 3 * 2 + 16));
+        if (positionsOnly) byPosition.assign(positions.size() / 3, UINT32_MAX);
+        else unique.reserve(positions.size() / 3);
+
+        auto emit = [&](const Corner& corner) {
+            uint32_t next = static_cast<uint32_t>(unique.size());
+            if (positionsOnly) {
+                uint32_t& slot = byPosition[corner.v];
+                if (slot == UINT32_MAX) {
+                    slot = next;
+                    unique.push_back(corner);
+                }
+                mesh.indices.push_back(slot);
+            } else {
+                bool created;
+                mesh.indices.push_back(table.insert(corner, next, created));
+                if (created) unique.push_back(corner);
+            }
+        };
+
+        for (const Chunk& chunk : chunks) {
+            const Corner* corner = chunk.corners.data();
+            for (uint32_t size : chunk.faceSizes) {
+                const Corner* face = corner;
+                corner += size;
+                if (size < 3) continue;   // face degenerada, ignorada como no TinyObjLoader
+                if (size == 3) {
+                    emit(face[0]);
+                    emit(face[1]);
+                    emit(face[2]);
+                    stats.triangles += 1;
+                } else if (size == 4) {
+                    // Quadrilátero: corta pela diagonal mais curta, com as mesmas contas em float do TinyObjLoader
+                    const float* p0 = &positions[face[0].v * 3];
+                    const float* p1 = &positions[face[1].v * 3];
+                    const float* p2 = &positions[face[2].v * 3];
+                    const float* p3 = &positions[face[3].v * 3];
+                    float e02x = p2[0] - p0[0], e02y = p2[1] - p0[1], e02z = p2[2] - p0[2];
+                    float e13x = p3[0] - p1[0], e13y = p3[1] - p1[1], e13z = p3[2] - p1[2];
+                    float sqr02 = e02x * e02x + e02y * e02y + e02z * e02z;
+                    float sqr13 = e13x * e13x + e13y * e13y + e13z * e13z;
+                    static const int split02[6] = { 0, 1, 2, 0, 2, 3 }, split13[6] = { 0, 1, 3, 1, 2, 3 };
+                    const int* order = sqr02 < sqr13 ? split02 : split13;
+                    for (int k = 0; k < 6; ++k) emit(face[order[k]]);
+                    stats.triangles += 2;
+                } else {
+                    for (uint32_t k = 1; k + 1 < size; ++k) {
+                        emit(face[0]);
+                        emit(face[k]);
+                        emit(face[k + 1]);
+                    }
+                    stats.triangles += size - 2;
+                    ++stats.largePolygons;
+                }
+            }
+        }
+
+        // Vértices completos em paralelo (mesmo makeVertex: cor branca, uv 0 e normal +Z quando faltam)
+        mesh.vertices.resize(unique.size());
+        size_t parts = std::max<size_t>(1, std::min<size_t>(stats.threads, unique.size() / 65536));
+        runParallel(parts, [&](size_t part) {
+            size_t first = unique.size() * part / parts, last = unique.size() * (part + 1) / parts;
+            for (size_t i = first; i < last; ++i) {
+                const Corner& c = unique[i];
+                Vertex& v = mesh.vertices[i];
+                v.pos = glm::vec3(positions[3 * c.v], positions[3 * c.v + 1], positions[3 * c.v + 2]);
+                v.color = glm::vec3(1.0f);
+                v.tex = c.t >= 0 ? glm::vec2(texcoords[2 * c.t], texcoords[2 * c.t + 1]) : glm::vec2(0.0f);
+                v.normal = c.n >= 0 ? glm::vec3(normals[3 * c.n], normals[3 * c.n + 1], normals[3 * c.n + 2]) : glm::vec3(0.0f, 0.0f, 1.0f);
+            }
+        });
+        positions.clear();
+        normals.clear();
+        texcoords.clear();
+    }
+
+    // Primeiro material do primeiro .mtl que abrir, com as regras do LoadMtl do TinyObjLoader:
+    // padrões zerados (Ns = 1), Kd = 0.6 quando há map_Kd sem Kd, e um material sem nome se o arquivo
+    // não tiver "newmtl"
+    static bool loadFirstMaterial(const std::string& baseDir, const std::string& mtllib, MeshMaterial& material) {
+        // Nomes separados por espaço; "\ " é espaço dentro do nome
+        std::vector<std::string> names(1);
+        for (size_t i = 0; i < mtllib.size(); ++i) {
+            if (mtllib[i] == '\\' && i + 1 < mtllib.size() && mtllib[i + 1] == ' ') names.back() += mtllib[++i];
+            else if (mtllib[i] == ' ') { if (!names.back().empty()) names.emplace_back(); }
+            else names.back() += mtllib[i];
+        }
+        for (const std::string& name : names) {
+            if (name.empty()) continue;
+            std::string path = baseDir.empty() ? name : baseDir + (baseDir.back() == '/' || baseDir.back() == '\\' ? "" : "/") + name;
+            std::ifstream file(path);
+            if (!file.is_open()) continue;
+            parseFirstMaterial(file, material);
+            return true;
+        }
+        return false;
+    }
+
+    static void parseFirstMaterial(std::istream& in, MeshMaterial& material) {
+        MeshMaterial current;
+        current.present = true;
+        current.ka = current.kd = current.ks = glm::vec3(0.0f);
+        current.shininess = 1.0f;
+        std::string currentName;
+        bool hasKd = false;
+
+        std::string line;
+        while (std::getline(in, line)) {
+            size_t last = line.find_last_not_of(" \t\r\n");
+            line.resize(last == std::string::npos ? 0 : last + 1);
+            const char* s = line.c_str();
+            const char* end = s + line.size();
+            s = skipSpaces(s, end);
+            if (s == end || *s == '#') continue;
+            auto keyword = [&](const char* name) {
+                size_t n = std::strlen(name);
+                if (static_cast<size_t>(end - s) > n && std::memcmp(s, name, n) == 0 && isSpace(s[n])) {
+                    s += n + 1;
+                    return true;
+                }
+                return false;
+            };
+            auto readVec3 = [&]() {
+                glm::vec3 v;
+                for (int k = 0; k < 3; ++k) v[k] = parseFloat(s, end);
+                return v;
+            };
+
+            if (keyword("newmtl")) {
+                // O primeiro material com nome é o que vale
+                if (!currentName.empty()) break;
+                current = MeshMaterial();
+                current.present = true;
+                current.ka = current.kd = current.ks = glm::vec3(0.0f);
+                current.shininess = 1.0f;
+                hasKd = false;
+                s = skipSpaces(s, end);
+                currentName.assign(s, skipToken(s, end));
+            } else if (keyword("Ka")) {
+                current.ka = readVec3();
+            } else if (keyword("Kd")) {
+                current.kd = readVec3();
+                hasKd = true;
+            } else if (keyword("Ks")) {
+                current.ks = readVec3();
+            } else if (keyword("Ns")) {
+                current.shininess = parseFloat(s, end);
+            } else if (keyword("map_Kd")) {
+                current.diffuseTexname = textureName(s, end);
+                if (!hasKd) current.kd = glm::vec3(0.6f);
+            }
+        }
+        material = current;
+    }
+
+    // Nome da textura depois das opções (-s, -o, -bm...): cada opção consome seus argumentos, e o nome é
+    // o resto da linha
+    static std::string textureName(const char* s, const char* end) {
+        struct Option {
+            const char* name;
+            int arguments;
+        };
+        static const Option options[] = { { "-blendu", 1 }, { "-blendv", 1 }, { "-clamp", 1 }, { "-boost", 1 }, { "-bm", 1 },
+                                          { "-o", 3 }, { "-s", 3 }, { "-t", 3 }, { "-type", 1 }, { "-texres", 1 },
+                                          { "-imfchan", 1 }, { "-mm", 2 }, { "-colorspace", 1 } };
+        std::string name;
+        for (;;) {
+            s = skipSpaces(s, end);
+            if (s == end) return name;
+            const Option* option = nullptr;
+            for (const Option& o : options) {
+                size_t n = std::strlen(o.name);
+                if (static_cast<size_t>(end - s) > n && std::memcmp(s, o.name, n) == 0 && isSpace(s[n])) option = &o;
+            }
+            if (!option) return std::string(s, end);
+            s += std::strlen(option->name);
+            for (int k = 0; k < option->arguments; ++k) s = skipToken(skipSpaces(s, end), end);
+        }
+    }
+
+    template <typename Job>
+    static void runParallel(size_t count, const Job& job) {
+        if (count <= 1) {
+            if (count) job(0);
+            return;
+        }
+        std::vector<std::thread> workers;
+        for (size_t i = 1; i < count; ++i) workers.emplace_back([&job, i] { job(i); });
+        job(0);
+        for (auto& worker : workers) worker.join();
+    }
+
+    static double elapsedSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    unsigned threadCount;
+    ObjParseStats stats;
+    std::vector<float> positions, normals, texcoords;
+};
+
+// Lê o .obj/.mtl com o ObjParser; stats (opcional) recebe tamanhos e tempos de cada etapa
+inline bool loadObjMeshFast(const std::string& objPath, MeshData& mesh, MeshMaterial& material, std::string& err,
+                            ObjParseStats* stats = nullptr, unsigned threadCount = 0) {
+    ObjParser parser(threadCount);
+    bool ok = parser.parse(objPath, mesh, material, err);
+    if (stats) *stats = parser.lastStats();
+    return ok;
+}
+
+// Leitor padrão dos executáveis: ObjParser, ou TinyObjLoader quando o arquivo tem polígonos com mais de
+// 4 vértices (triangulação por ear clipping) ou o leitor rápido não consegue abri-lo
+inline bool loadObjMesh(const std::string& objPath, MeshData& mesh, MeshMaterial& material, std::string& err) {
+    ObjParseStats stats;
+    if (loadObjMeshFast(objPath, mesh, material, err, &stats) && stats.largePolygons == 0) return true;
+    err.clear();
+    return loadObjMeshTinyObj(objPath, mesh, material, err);
+}
+
+#endif
@@ -0,0 +1,203 @@
+#ifndef PACKED_VERTEX_H
+#define PACKED_VERTEX_H
+
+// Conversão de Vertex (44 bytes) para os formatos compactados de mesh.h: PackedVertexFloat (20 bytes)
+// e PackedVertex16 (16 bytes, posição quantizada na caixa da malha). Roda nas threads de carregamento;
+// o relatório de erro mede a precisão perdida em cada malha decodificando de volta na CPU.
+//
+// Decodificação no vertex shader:
+//   posição = positionOffset + positionScale * position   (unorm16 já chega em 0..1)
+//   normal  = octDecode(normal.xy)                        (snorm16 já chega em -1..1)
+
+#include "mesh.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Half float (IEEE 754 binário16) com arredondamento para o par mais próximo
+inline uint16_t floatToHalf(float value) {
+    uint32_t f;
+    std::memcpy(&f, &value, sizeof(f));
+    uint32_t sign = (f >> 16) & 0x8000;
+    uint32_t exponent = (f >> 23) & 0xFF;
+    uint32_t mantissa = f & 0x7FFFFF;
+    if (exponent == 0xFF) return static_cast<uint16_t>(sign | 0x7C00 | (mantissa ? 0x200 : 0));
+
+    int e = static_cast<int>(exponent) - 127 + 15;
+    if (e >= 0x1F) return static_cast<uint16_t>(sign | 0x7C00);
+    if (e <= 0) {
+        // Subnormal: a mantissa com o bit implícito desce até o expoente mínimo
+        if (e < -10) return static_cast<uint16_t>(sign);
+        mantissa |= 0x800000;
+        uint32_t shift = static_cast<uint32_t>(14 - e);
+        uint32_t half = mantissa >> shift;
+        uint32_t rest = mantissa & ((1u << shift) - 1), halfway = 1u << (shift - 1);
+        if (rest > halfway || (rest == halfway && (half & 1))) ++half;
+        return static_cast<uint16_t>(sign | half);
+    }
+    uint32_t half = (static_cast<uint32_t>(e) << 10) | (mantissa >> 13);
+    uint32_t rest = mantissa & 0x1FFF;
+    if (rest > 0x1000 || (rest == 0x1000 && (half & 1))) ++half;   // o vai-um pode subir o expoente
+    return static_cast<uint16_t>(sign | half);
+}
+
+inline float halfToFloat(uint16_t half) {
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FF;
+    if (exponent == 0) {
+        float value = std::ldexp(static_cast<float>(mantissa), -24);
+        return sign ? -value : value;
+    }
+    uint32_t f = exponent == 0x1F ? (sign | 0x7F800000 | (mantissa << 13))
+                                  : (sign | ((exponent + 112) << 23) | (mantissa << 13));
+    float value;
+    std::memcpy(&value, &f, sizeof(value));
+    return value;
+}
+
+// Normal unitária no octaedro desdobrado em [-1, 1]^2
+inline glm::vec2 octEncode(const glm::vec3& n) {
+    float l1 = std::abs(n.x) + std::abs(n.y) + std::abs(n.z);
+    if (l1 <= 0.0f) return glm::vec2(0.0f);
+    glm::vec2 e(n.x / l1, n.y / l1);
+    if (n.z < 0.0f) {
+        glm::vec2 folded((1.0f - std::abs(e.y)) * (e.x >= 0.0f ? 1.0f : -1.0f),
+                         (1.0f - std::abs(e.x)) * (e.y >= 0.0f ? 1.0f : -1.0f));
+        e = folded;
+    }
+    return e;
+}
+
+inline glm::vec3 octDecode(const glm::vec2& e) {
+    glm::vec3 n(e.x, e.y, 1.0f - std::abs(e.x) - std::abs(e.y));
+    if (n.z < 0.0f) {
+        float x = (1.0f - std::abs(e.y)) * (e.x >= 0.0f ? 1.0f : -1.0f);
+        float y = (1.0f - std::abs(e.x)) * (e.y >= 0.0f ? 1.0f : -1.0f);
+        n.x = x;
+        n.y = y;
+    }
+    return glm::normalize(n);
+}
+
+inline int16_t toSnorm16(float v) {
+    return static_cast<int16_t>(std::lround(std::min(std::max(v, -1.0f), 1.0f) * 32767.0f));
+}
+
+inline float fromSnorm16(int16_t v) {
+    return std::max(static_cast<float>(v) / 32767.0f, -1.0f);
+}
+
+// Precisão perdida na conversão (maior erro entre todos os vértices)
+struct VertexPackError {
+    float position = 0.0f;         // em unidades do modelo
+    float positionRelative = 0.0f; // em relação à diagonal da caixa da malha
+    float normalDegrees = 0.0f;
+    float tex = 0.0f;
+};
+
+// Vértices convertidos, prontos para uploadVertexBuffers
+struct PackedVertices {
+    VertexFormat format = VertexFormat::Full;
+    std::vector<uint8_t> data;
+    const uint8_t* mapped = nullptr;   // vértices no .meshbin mapeado (data fica vazio)
+    size_t count = 0;
+    glm::vec3 positionOffset = glm::vec3(0.0f), positionScale = glm::vec3(1.0f);
+    VertexPackError error;
+
+    const uint8_t* bytes() const { return mapped ? mapped : data.data(); }
+};
+
+inline const char* vertexFormatName(VertexFormat format) {
+    switch (format) {
+    case VertexFormat::PackedFloat: return "compacto (posição float)";
+    case VertexFormat::Packed16: return "compacto (posição 16 bits)";
+    default: return "completo";
+    }
+}
+
+// Converte os vértices para o formato pedido e mede o erro. Com VertexFormat::Full não faz nada.
+inline PackedVertices packVertices(const Vertex* vertices, size_t count, VertexFormat format) {
+    PackedVertices packed;
+    packed.format = format;
+    packed.count = count;
+    if (format == VertexFormat::Full || count == 0) return packed;
+
+    glm::vec3 lo = vertices[0].pos, hi = lo;
+    for (size_t i = 1; i < count; ++i) {
+        lo = glm::min(lo, vertices[i].pos);
+        hi = glm::max(hi, vertices[i].pos);
+    }
+    glm::vec3 extent = hi - lo;
+    if (format == VertexFormat::Packed16) {
+        packed.positionOffset = lo;
+        packed.positionScale = extent;
+    }
+
+    packed.data.resize(vertexStride(format) * count);
+    VertexPackError& error = packed.error;
+    float maxNormalCos = 1.0f;
+    for (size_t i = 0; i < count; ++i) {
+        const Vertex& v = vertices[i];
+        glm::vec2 oct = octEncode(v.normal);
+        int16_t normal[2] = { toSnorm16(oct.x), toSnorm16(oct.y) };
+        uint16_t tex[2] = { floatToHalf(v.tex.x), floatToHalf(v.tex.y) };
+
+        glm::vec3 decodedPos = v.pos;
+        if (format == VertexFormat::Packed16) {
+            PackedVertex16 out;
+            for (int c = 0; c < 3; ++c) {
+                float t = extent[c] > 0.0f ? (v.pos[c] - lo[c]) / extent[c] : 0.0f;
+                out.pos[c] = static_cast<uint16_t>(std::lround(std::min(std::max(t, 0.0f), 1.0f) * 65535.0f));
+                decodedPos[c] = lo[c] + extent[c] * (out.pos[c] / 65535.0f);
+            }
+            out.pos[3] = 0;
+            std::memcpy(out.normal, normal, sizeof(normal));
+            std::memcpy(out.tex, tex, sizeof(tex));
+            std::memcpy(packed.data.data() + i * sizeof(out), &out, sizeof(out));
+        } else {
+            PackedVertexFloat out;
+            out.pos[0] = v.pos.x;
+            out.pos[1] = v.pos.y;
+            out.pos[2] = v.pos.z;
+            std::memcpy(out.normal, normal, sizeof(normal));
+            std::memcpy(out.tex, tex, sizeof(tex));
+            std::memcpy(packed.data.data() + i * sizeof(out), &out, sizeof(out));
+        }
+
+        error.position = std::max(error.position, glm::length(decodedPos - v.pos));
+        float length = glm::length(v.normal);
+        if (length > 0.0f) {
+            glm::vec3 decodedNormal = octDecode(glm::vec2(fromSnorm16(normal[0]), fromSnorm16(normal[1])));
+            maxNormalCos = std::min(maxNormalCos, glm::dot(decodedNormal, v.normal / length));
+        }
+        error.tex = std::max(error.tex, std::max(std::abs(halfToFloat(tex[0]) - v.tex.x), std::abs(halfToFloat(tex[1]) - v.tex.y)));
+    }
+    float diagonal = glm::length(extent);
+    error.positionRelative = diagonal > 0.0f ? error.position / diagonal : 0.0f;
+    error.normalDegrees = glm::degrees(std::acos(std::min(std::max(maxNormalCos, -1.0f), 1.0f)));
+    return packed;
+}
+
+// Upload com índices já prontos (o .meshbin mapeado) ou com os de uma MeshData (mesmas regras de uploadMesh)
+inline GpuMesh uploadPackedMesh(const PackedVertices& packed, const void* indices, size_t indexCount, GLenum indexType) {
+    GpuMesh gpu = uploadVertexBuffers(packed.bytes(), packed.count, packed.format, indices, indexCount, indexType);
+    gpu.positionOffset = packed.positionOffset;
+    gpu.positionScale = packed.positionScale;
+    return gpu;
+}
+
+inline GpuMesh uploadPackedMesh(const PackedVertices& packed, const MeshData& mesh, const std::vector<uint32_t>& extraIndices = {}) {
+    GpuMesh gpu = uploadMesh(mesh, extraIndices, packed.bytes(), packed.format);
+    gpu.positionOffset = packed.positionOffset;
+    gpu.positionScale = packed.positionScale;
+    return gpu;
+}
+
+#endif
@@ -0,0 +1,278 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+// Profiler de frame: escopos de CPU aninhados (de qualquer thread) e escopos de GPU com pares de
+// GL_TIMESTAMP, lidos alguns frames depois para nunca parar o pipeline. Cada sessão vira um arquivo
+// JSON no formato trace_event do Chrome (abrir em chrome://tracing ou ui.perfetto.dev).
+//
+// Só existe em builds de depuração: com NDEBUG (Release) as macros PROFILE_* não geram código.
+// PROFILER_FORCE liga o profiler mesmo com NDEBUG; PROFILER_DISABLE desliga sempre.
+
+#if (!defined(NDEBUG) || defined(PROFILER_FORCE)) && !defined(PROFILER_DISABLE)
+#define PROFILER_ENABLED 1
+#else
+#define PROFILER_ENABLED 0
+#endif
+
+#if PROFILER_ENABLED
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+class Profiler {
+public:
+    static const int QUERY_RING = 4;              // frames entre a emissão e a leitura das consultas
+    static const size_t MAX_EVENTS = 2000000;     // limite por sessão (~100 MB de JSON)
+
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    // Inicia uma sessão; a thread que chama passa a ser a "main" do trace.
+    // gpu = false para sessões sem contexto OpenGL (só escopos de CPU).
+    void beginSession(const std::string& path, bool gpu = true) {
+        std::lock_guard<std::mutex> lock(mutex);
+        sessionPath = path;
+        events.clear();
+        dropped = 0;
+        threadNames.clear();
+        threadNames.push_back("GPU");
+        ++generation;
+        registerThread("main");
+        gpuEnabled = gpu;
+        if (gpuEnabled) {
+            GLint64 now = 0;
+            glGetInteger64v(GL_TIMESTAMP, &now);
+            gpuOriginNs = now;
+            gpuOriginUs = nowUs();
+        }
+        active = true;
+    }
+
+    // Lê as consultas ainda pendentes e grava o arquivo da sessão
+    void endSession() {
+        if (!active) return;
+        if (gpuEnabled) {
+            glFinish();
+            for (int i = 0; i < QUERY_RING; ++i) collect(slots[i]);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        active = false;
+        write();
+    }
+
+    bool recording() const { return active; }
+
+    // Fim do frame: avança o anel e lê os tempos de GPU emitidos QUERY_RING - 1 frames atrás
+    void endFrame() {
+        if (!active || !gpuEnabled) return;
+        frameSlot = (frameSlot + 1) % QUERY_RING;
+        collect(slots[frameSlot]);
+    }
+
+    void cpuEvent(const char* name, double startUs, double endUs, int thread) {
+        std::lock_guard<std::mutex> lock(mutex);
+        push(name, "cpu", startUs, endUs - startUs, thread);
+    }
+
+    // Par de timestamps no slot do frame atual; devolve o índice para o fim do escopo
+    int gpuBegin(const char* name) {
+        if (!active || !gpuEnabled) return -1;
+        Slot& slot = slots[frameSlot];
+        if (slot.used == slot.scopes.size()) {
+            GpuScope scope;
+            glGenQueries(2, scope.queries);
+            slot.scopes.push_back(scope);
+        }
+        GpuScope& scope = slot.scopes[slot.used];
+        scope.name = name;
+        glQueryCounter(scope.queries[0], GL_TIMESTAMP);
+        return (int)slot.used++;
+    }
+
+    void gpuEnd(int scope) {
+        if (scope < 0 || !active) return;
+        glQueryCounter(slots[frameSlot].scopes[scope].queries[1], GL_TIMESTAMP);
+    }
+
+    void release() {
+        for (auto& slot : slots) {
+            for (auto& scope : slot.scopes) glDeleteQueries(2, scope.queries);
+            slot.scopes.clear();
+            slot.used = 0;
+        }
+    }
+
+    static double nowUs() {
+        using namespace std::chrono;
+        return duration<double, std::micro>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Identificador curto da thread no trace (0 é a linha da GPU); renumerado a cada sessão
+    int currentThread() {
+        std::lock_guard<std::mutex> lock(mutex);
+        ThreadSlot& slot = threadSlot();
+        if (slot.generation != generation) registerThread("worker " + std::to_string(threadNames.size() - 1));
+        return slot.id;
+    }
+
+private:
+    struct GpuScope {
+        const char* name = nullptr;
+        GLuint queries[2] = { 0, 0 };
+    };
+
+    struct Slot {
+        std::vector<GpuScope> scopes;
+        size_t used = 0;
+    };
+
+    struct Event {
+        const char* name;
+        const char* category;
+        double ts, dur;
+        int thread;
+    };
+
+    struct ThreadSlot {
+        int id = -1;
+        unsigned generation = 0;
+    };
+
+    static ThreadSlot& threadSlot() {
+        thread_local ThreadSlot slot;
+        return slot;
+    }
+
+    // Chamada com o mutex travado
+    void registerThread(const std::string& name) {
+        threadSlot().id = (int)threadNames.size();
+        threadSlot().generation = generation;
+        threadNames.push_back(name);
+    }
+
+    void push(const char* name, const char* category, double ts, double dur, int thread) {
+        if (!active) return;
+        if (events.size() >= MAX_EVENTS) {
+            ++dropped;
+            return;
+        }
+        events.push_back({ name, category, ts, dur, thread });
+    }
+
+    // Consultas de um slot emitidas QUERY_RING - 1 frames atrás: normalmente já prontas
+    void collect(Slot& slot) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (size_t i = 0; i < slot.used; ++i) {
+            GLuint64 begin = 0, end = 0;
+            glGetQueryObjectui64v(slot.scopes[i].queries[0], GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(slot.scopes[i].queries[1], GL_QUERY_RESULT, &end);
+            double ts = gpuOriginUs + ((double)begin - (double)gpuOriginNs) / 1000.0;
+            push(slot.scopes[i].name, "gpu", ts, ((double)end - (double)begin) / 1000.0, 0);
+        }
+        slot.used = 0;
+    }
+
+    // Chamada com o mutex travado
+    void write() {
+        std::ofstream file(sessionPath);
+        if (!file.is_open()) {
+            std::cerr << "Erro ao gravar o trace " << sessionPath << "\n";
+            return;
+        }
+        double origin = events.empty() ? 0.0 : events.front().ts;
+        for (const auto& e : events) origin = std::min(origin, e.ts);
+
+        // Metadados com o nome de cada linha (GPU, main, workers) seguidos dos eventos completos ("X")
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        for (size_t t = 0; t < threadNames.size(); ++t) {
+            file << (t ? ",\n" : "") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << t
+                 << ",\"args\":{\"name\":\"" << threadNames[t] << "\"}}";
+        }
+        file.precision(3);
+        file << std::fixed;
+        for (const Event& e : events) {
+            file << ",\n{\"name\":\"" << e.name << "\",\"cat\":\"" << e.category << "\",\"ph\":\"X\",\"ts\":"
+                 << e.ts - origin << ",\"dur\":" << e.dur << ",\"pid\":1,\"tid\":" << e.thread << "}";
+        }
+        file << "\n]}\n";
+        std::cout << "Trace gravado em " << sessionPath << " (" << events.size() << " eventos"
+                  << (dropped ? ", " + std::to_string(dropped) + " descartados pelo limite" : "") << ")\n";
+    }
+
+    std::mutex mutex;
+    std::atomic<bool> active{ false };
+    bool gpuEnabled = false;
+    std::string sessionPath;
+    std::vector<Event> events;
+    size_t dropped = 0;
+    std::vector<std::string> threadNames;
+    unsigned generation = 0;
+    Slot slots[QUERY_RING];
+    int frameSlot = 0;
+    GLint64 gpuOriginNs = 0;
+    double gpuOriginUs = 0.0;
+};
+
+// Escopo de CPU: mede do construtor ao destrutor, na thread atual
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name) : name(name) {
+        if (Profiler::instance().recording()) start = Profiler::nowUs();
+    }
+
+    ~ProfileScope() {
+        if (start < 0.0) return;
+        Profiler& profiler = Profiler::instance();
+        profiler.cpuEvent(name, start, Profiler::nowUs(), profiler.currentThread());
+    }
+
+private:
+    const char* name;
+    double start = -1.0;
+};
+
+// Escopo de CPU + GPU (só na thread do contexto OpenGL)
+class ProfileGpuScope {
+public:
+    explicit ProfileGpuScope(const char* name) : cpu(name), query(Profiler::instance().gpuBegin(name)) {}
+    ~ProfileGpuScope() { Profiler::instance().gpuEnd(query); }
+
+private:
+    ProfileScope cpu;
+    int query;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define PROFILE_GPU_SCOPE(name) ProfileGpuScope PROFILE_CONCAT(profileGpuScope, __LINE__)(name)
+#define PROFILE_FRAME() Profiler::instance().endFrame()
+#define PROFILE_BEGIN_SESSION(path) Profiler::instance().beginSession(path)
+#define PROFILE_END_SESSION() Profiler::instance().endSession()
+#define PROFILE_RECORDING() Profiler::instance().recording()
+#define PROFILE_RELEASE() Profiler::instance().release()
+
+#else
+
+#define PROFILE_SCOPE(name) ((void)0)
+#define PROFILE_GPU_SCOPE(name) ((void)0)
+#define PROFILE_FRAME() ((void)0)
+#define PROFILE_BEGIN_SESSION(path) ((void)0)
+#define PROFILE_END_SESSION() ((void)0)
+#define PROFILE_RECORDING() false
+#define PROFILE_RELEASE() ((void)0)
+
+#endif
+
+#endif
@@ -0,0 +1,161 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+// Fila de desenho ordenada: cada draw entra com uma chave de 64 bits que codifica o estado de GL que ele
+// precisa, do mais caro de trocar para o mais barato, e a profundidade no fim:
+//
+//   63..60 programa/variante | 59..48 textura | 47..36 malha (VAO) | 35..24 material | 23..0 profundidade
+//
+// Ordenadas as chaves, draws com o mesmo estado ficam vizinhos e, dentro dele, vão da frente para trás
+// (o teste de profundidade descarta mais fragmentos). A ordenação é um radix sort LSD de 8 bits por
+// passada; passadas em que todas as chaves têm o mesmo byte (programa quase sempre, profundidade raramente)
+// são puladas.
+//
+// GLStateCache guarda o último programa, textura, VAO e valores de uniformes enviados, e só chama o GL
+// quando o valor muda; conta as trocas feitas e as evitadas. Código que mexe nesses estados por fora
+// (upload de texturas, o caminho em lote) precisa ser seguido de invalidate().
+
+#include <glad/glad.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Ids densos para os campos da chave: nomes de GL (texturas, VAOs) viram a posição no conjunto ordenado
+class SortKeyIds {
+public:
+    void assign(std::vector<uint32_t> names) {
+        std::sort(names.begin(), names.end());
+        names.erase(std::unique(names.begin(), names.end()), names.end());
+        sorted = std::move(names);
+    }
+
+    uint32_t id(uint32_t name) const {
+        return (uint32_t)(std::lower_bound(sorted.begin(), sorted.end(), name) - sorted.begin());
+    }
+
+    size_t size() const { return sorted.size(); }
+
+private:
+    std::vector<uint32_t> sorted;
+};
+
+class RenderQueue {
+public:
+    struct Item {
+        uint64_t key;
+        uint32_t index;   // quem desenhar (o significado é de quem enfileira)
+    };
+
+    static const int PROGRAM_BITS = 4, TEXTURE_BITS = 12, MESH_BITS = 12, MATERIAL_BITS = 12, DEPTH_BITS = 24;
+
+    // Parte de estado da chave; ids acima do campo são saturados (só pioram o agrupamento)
+    static uint64_t stateKey(uint32_t program, uint32_t texture, uint32_t mesh, uint32_t material) {
+        return field(program, PROGRAM_BITS) << 60 | field(texture, TEXTURE_BITS) << 48 |
+               field(mesh, MESH_BITS) << 36 | field(material, MATERIAL_BITS) << 24;
+    }
+
+    // Profundidade normalizada em [0, 1] (0 = perto) nos 24 bits baixos
+    static uint64_t depthKey(float depth01) {
+        const float maxDepth = (float)((1u << DEPTH_BITS) - 1);
+        float d = std::min(std::max(depth01, 0.0f), 1.0f);
+        return (uint64_t)(d * maxDepth);
+    }
+
+    static uint32_t program(uint64_t key) { return (uint32_t)(key >> 60); }
+
+    void clear() { queue.clear(); }
+    void push(uint64_t key, uint32_t index) { queue.push_back({ key, index }); }
+    size_t size() const { return queue.size(); }
+    bool empty() const { return queue.empty(); }
+    const std::vector<Item>& items() const { return queue; }
+
+    // Radix sort estável; devolve quantas passadas de fato moveram os itens
+    int sort() {
+        size_t n = queue.size();
+        if (n < 2) return 0;
+
+        // Histogramas dos 8 bytes em uma só leitura das chaves
+        uint32_t counts[8][256] = {};
+        for (const Item& item : queue)
+            for (int b = 0; b < 8; ++b) ++counts[b][(item.key >> (8 * b)) & 0xFF];
+
+        scratch.resize(n);
+        int passes = 0;
+        for (int b = 0; b < 8; ++b) {
+            uint32_t* count = counts[b];
+            if (count[(queue[0].key >> (8 * b)) & 0xFF] == n) continue;   // byte igual em todas as chaves
+            uint32_t offset = 0;
+            for (int v = 0; v < 256; ++v) {
+                uint32_t c = count[v];
+                count[v] = offset;
+                offset += c;
+            }
+            for (const Item& item : queue) scratch[count[(item.key >> (8 * b)) & 0xFF]++] = item;
+            queue.swap(scratch);
+            ++passes;
+        }
+        return passes;
+    }
+
+private:
+    static uint64_t field(uint32_t value, int bits) {
+        return (uint64_t)std::min<uint32_t>(value, (1u << bits) - 1);
+    }
+
+    std::vector<Item> queue, scratch;
+};
+
+class GLStateCache {
+public:
+    // Estados inteiros cujo envio fica a cargo de quem chama (uniformes, materiais por nome)
+    enum Slot { Program, Texture, VertexArray, Material, Instancing, SLOT_COUNT };
+
+    // Esquece o que foi enviado: o próximo pedido de cada estado chama o GL
+    void invalidate() {
+        for (int s = 0; s < SLOT_COUNT; ++s) known[s] = false;
+    }
+
+    // true quando o valor mudou e o estado precisa ser enviado; false conta como troca evitada
+    bool set(Slot slot, int64_t value) {
+        if (known[slot] && values[slot] == value) {
+            ++skippedCount;
+            return false;
+        }
+        known[slot] = true;
+        values[slot] = value;
+        ++issuedCount;
+        return true;
+    }
+
+    bool useProgram(GLuint program) {
+        if (!set(Program, program)) return false;
+        glUseProgram(program);
+        return true;
+    }
+
+    // Unidade de textura 0, GL_TEXTURE_2D (a única que os shaders por objeto amostram)
+    bool bindTexture(GLuint texture) {
+        if (!set(Texture, texture)) return false;
+        glBindTexture(GL_TEXTURE_2D, texture);
+        return true;
+    }
+
+    bool bindVertexArray(GLuint vao) {
+        if (!set(VertexArray, vao)) return false;
+        glBindVertexArray(vao);
+        return true;
+    }
+
+    size_t issued() const { return issuedCount; }
+    size_t skipped() const { return skippedCount; }
+    void resetCounters() { issuedCount = skippedCount = 0; }
+
+private:
+    bool known[SLOT_COUNT] = {};
+    int64_t values[SLOT_COUNT] = {};
+    size_t issuedCount = 0, skippedCount = 0;
+};
+
+#endif
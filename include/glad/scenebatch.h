@@ -0,0 +1,471 @@
+#ifndef SCENE_BATCH_H
+#define SCENE_BATCH_H
+
+// Cena inteira em uma única submissão: todas as malhas ficam em uma arena compartilhada de
+// vértices/índices, as transformações e os índices de material/textura em um SSBO, as texturas
+// em um GL_TEXTURE_2D_ARRAY, e cada objeto vira um comando de um glMultiDrawElementsIndirect.
+//
+// O registro de cada cópia é encontrado pelo atributo drawId (location 4, divisor 1): o comando
+// usa baseInstance = primeiro registro, então a instância k lê o id baseInstance + k.
+//
+// Interface correspondente no vertex shader:
+//   layout(location = 4) in uint drawId;
+//   struct DrawRecord { mat4 model; mat3 normalMatrix; int materialIndex; int textureLayer; };
+//   layout(std430, binding = 1) readonly buffer DrawRecords { DrawRecord records[]; };
+//
+// A arena usa o formato de vértice das malhas (todas precisam ter o mesmo). Nos formatos compactados a
+// desquantização da posição de cada malha entra na matriz model do registro; a normalMatrix continua
+// sendo a da transformação do objeto.
+//
+// glMultiDrawElementsIndirect e SSBOs são do OpenGL 4.3, além do que o glad do projeto carrega:
+// as funções são buscadas em loadEntryPoints e, sem suporte, a cena continua no caminho por objeto.
+
+#include "mesh.h"
+
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <unordered_map>
+#include <vector>
+
+#ifndef GL_SHADER_STORAGE_BUFFER
+#define GL_SHADER_STORAGE_BUFFER 0x90D2
+#endif
+
+const GLuint SCENE_BATCH_RECORD_BINDING = 1;
+const GLuint SCENE_BATCH_DRAW_ID_LOCATION = 4;
+const int SCENE_BATCH_MAX_LAYER_SIZE = 2048;
+
+// Layout exigido por glMultiDrawElementsIndirect
+struct DrawElementsIndirectCommand {
+    GLuint count;
+    GLuint instanceCount;
+    GLuint firstIndex;
+    GLint baseVertex;
+    GLuint baseInstance;
+};
+
+// Registro por cópia no layout std430 (128 bytes): mat3 ocupa três colunas de vec4
+struct DrawRecord {
+    glm::mat4 model;
+    glm::vec4 normalMatrix[3];
+    GLint materialIndex;
+    GLint textureLayer;
+    GLint padding[2];
+};
+
+typedef void (APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC_SB)(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+
+class SceneBatch {
+public:
+    SceneBatch() = default;
+    SceneBatch(const SceneBatch&) = delete;
+    SceneBatch& operator=(const SceneBatch&) = delete;
+    ~SceneBatch() { release(); }
+
+    // Busca as funções do OpenGL 4.3 (mesmo loader passado para o glad); false se o driver não as tiver
+    bool loadEntryPoints(GLADloadproc load) {
+        multiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC_SB)load("glMultiDrawElementsIndirect");
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        supported = multiDrawElementsIndirect != nullptr && (major > 4 || (major == 4 && minor >= 3));
+        return supported;
+    }
+
+    bool available() const { return supported && built; }
+
+    // Registra um comando com `copies` cópias da malha; devolve o índice do comando.
+    // Malhas e texturas repetidas (mesmo VBO / mesmo handle) são enviadas uma única vez.
+    size_t addDraw(const GpuMesh& mesh, GLuint texture, int materialIndex, size_t copies = 1) {
+        Command command;
+        command.mesh = meshSlot(mesh);
+        command.layer = textureLayer(texture);
+        command.materialIndex = materialIndex;
+        command.firstRecord = totalRecords;
+        command.copies = copies;
+        commands.push_back(command);
+        totalRecords += copies;
+        return commands.size() - 1;
+    }
+
+    // Monta a arena, o array de texturas e os buffers; chamado uma vez, depois de todos os addDraw
+    void build() {
+        if (!supported || built) return;
+        buildArena();
+        buildTextureArray();
+        buildBuffers();
+        built = true;
+    }
+
+    // Refaz a camada de uma textura que ganhou níveis (TextureStreamer::improved); só copia de novo
+    // quando o nível de origem melhorou
+    void refreshTexture(GLuint texture) {
+        auto it = layerByTexture.find(texture);
+        if (!built || it == layerByTexture.end()) return;
+        size_t layer = (size_t)it->second;
+        if (sourceLevel(texture) == layerLevel[layer]) return;
+
+        // Chamado no meio do frame: o framebuffer de desenho (a janela ou o FBO do modo sem janela) volta no fim
+        GLint drawFbo = 0, readFbo = 0;
+        glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &drawFbo);
+        glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &readFbo);
+        GLuint fbos[2];
+        glGenFramebuffers(2, fbos);
+        blitLayer(layer, fbos);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, (GLuint)drawFbo);
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, (GLuint)readFbo);
+        glDeleteFramebuffers(2, fbos);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    size_t firstRecord(size_t command) const { return commands[command].firstRecord; }
+
+    // Atualiza a transformação de uma cópia; o envio acontece no próximo draw()
+    void setTransform(size_t record, const glm::mat4& model) {
+        DrawRecord& r = records[record];
+        r.model = model * meshes[recordMesh[record]].dequantize;
+        glm::mat3 normal = glm::transpose(glm::inverse(glm::mat3(model)));
+        for (int c = 0; c < 3; ++c) r.normalMatrix[c] = glm::vec4(normal[c], 0.0f);
+        dirtyBegin = std::min(dirtyBegin, record);
+        dirtyEnd = std::max(dirtyEnd, record + 1);
+    }
+
+    // Liga/desliga um comando sem mexer no resto: descartado vira instanceCount = 0 no buffer indireto
+    void setVisible(size_t command, bool visible) {
+        GLuint count = visible ? (GLuint)commands[command].copies : 0;
+        if (indirect[command].instanceCount == count) return;
+        indirect[command].instanceCount = count;
+        indirectDirtyBegin = std::min(indirectDirtyBegin, command);
+        indirectDirtyEnd = std::max(indirectDirtyEnd, command + 1);
+    }
+
+    // Desenha a cena inteira com uma única chamada
+    void draw() {
+        bind();
+        multiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, (GLsizei)commands.size(), 0);
+        glBindVertexArray(0);
+    }
+
+    // Redesenha apenas um comando (usado no destaque do objeto selecionado)
+    void drawCommand(size_t command) {
+        bind();
+        multiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT,
+            (const void*)(sizeof(DrawElementsIndirectCommand) * command), 1, 0);
+        glBindVertexArray(0);
+    }
+
+    size_t commandCount() const { return commands.size(); }
+    size_t recordCount() const { return totalRecords; }
+    size_t meshCount() const { return meshes.size(); }
+    size_t layerCount() const { return textures.size(); }
+    int layerSize() const { return layerDim; }
+    size_t arenaBytes() const { return arenaVertexCount * vertexStride(format) + arenaIndexCount * sizeof(uint32_t); }
+    VertexFormat vertexFormat() const { return format; }
+
+    // Libera os buffers e o array de texturas; chamar antes de destruir o contexto OpenGL
+    void release() {
+        if (vao) glDeleteVertexArrays(1, &vao);
+        GLuint buffers[] = { arenaVbo, arenaEbo, indirectBuffer, drawIdBuffer, recordBuffer };
+        for (GLuint b : buffers)
+            if (b) glDeleteBuffers(1, &b);
+        if (textureArray) glDeleteTextures(1, &textureArray);
+        vao = arenaVbo = arenaEbo = indirectBuffer = drawIdBuffer = recordBuffer = textureArray = 0;
+        built = false;
+    }
+
+    // Libera tudo e esquece os comandos registrados (recarga da cena: addDraw + build de novo)
+    void clear() {
+        release();
+        meshes.clear();
+        meshByVbo.clear();
+        textures.clear();
+        layerByTexture.clear();
+        layerLevel.clear();
+        commands.clear();
+        records.clear();
+        recordMesh.clear();
+        indirect.clear();
+        totalRecords = 0;
+        arenaVertexCount = arenaIndexCount = 0;
+        format = VertexFormat::Full;
+        dirtyBegin = dirtyEnd = 0;
+        indirectDirtyBegin = indirectDirtyEnd = 0;
+        layerDim = 1;
+    }
+
+private:
+    struct MeshRange {
+        GpuMesh source;
+        GLint baseVertex = 0;
+        GLuint firstIndex = 0;
+        glm::mat4 dequantize = glm::mat4(1.0f);   // posição lida do VBO -> espaço do modelo
+    };
+
+    struct Command {
+        size_t mesh = 0;
+        int layer = 0;
+        int materialIndex = 0;
+        size_t firstRecord = 0;
+        size_t copies = 1;
+    };
+
+    size_t meshSlot(const GpuMesh& mesh) {
+        auto it = meshByVbo.find(mesh.VBO);
+        if (it != meshByVbo.end()) return it->second;
+        MeshRange range;
+        range.source = mesh;
+        range.baseVertex = (GLint)arenaVertexCount;
+        range.firstIndex = (GLuint)arenaIndexCount;
+        range.dequantize = glm::scale(glm::translate(glm::mat4(1.0f), mesh.positionOffset), mesh.positionScale);
+        if (meshes.empty()) format = mesh.format;
+        arenaVertexCount += mesh.vertexCount;
+        arenaIndexCount += mesh.indexCount;
+        meshes.push_back(range);
+        meshByVbo.emplace(mesh.VBO, meshes.size() - 1);
+        return meshes.size() - 1;
+    }
+
+    int textureLayer(GLuint texture) {
+        auto it = layerByTexture.find(texture);
+        if (it != layerByTexture.end()) return it->second;
+        textures.push_back(texture);
+        layerByTexture.emplace(texture, (int)textures.size() - 1);
+        return (int)textures.size() - 1;
+    }
+
+    // Copia os VBOs de cada malha para a arena na GPU; os índices vão para 32 bits (um único tipo por chamada)
+    void buildArena() {
+        glGenVertexArrays(1, &vao);
+        glGenBuffers(1, &arenaVbo);
+        glGenBuffers(1, &arenaEbo);
+
+        size_t stride = vertexStride(format);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, arenaVbo);
+        glBufferData(GL_COPY_WRITE_BUFFER, stride * arenaVertexCount, nullptr, GL_STATIC_DRAW);
+        for (const auto& range : meshes) {
+            glBindBuffer(GL_COPY_READ_BUFFER, range.source.VBO);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0,
+                stride * range.baseVertex, stride * range.source.vertexCount);
+        }
+
+        std::vector<uint32_t> indices(arenaIndexCount);
+        std::vector<uint16_t> shortIndices;
+        for (const auto& range : meshes) {
+            glBindBuffer(GL_COPY_READ_BUFFER, range.source.EBO);
+            uint32_t* dst = indices.data() + range.firstIndex;
+            if (range.source.indexType == GL_UNSIGNED_SHORT) {
+                shortIndices.resize(range.source.indexCount);
+                glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(uint16_t) * shortIndices.size(), shortIndices.data());
+                std::copy(shortIndices.begin(), shortIndices.end(), dst);
+            } else {
+                glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(uint32_t) * range.source.indexCount, dst);
+            }
+        }
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, arenaVbo);
+        setupVertexAttributes(format);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, arenaEbo);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint32_t) * indices.size(), indices.data(), GL_STATIC_DRAW);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    }
+
+    // Cada textura vira uma camada do array, redimensionada na GPU (blit linear) para o tamanho comum
+    void buildTextureArray() {
+        layerDim = 1;
+        for (GLuint texture : textures) {
+            GLint w = 0, h = 0;
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_WIDTH, &w);
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, 0, GL_TEXTURE_HEIGHT, &h);
+            layerDim = std::max(layerDim, (int)std::max(w, h));
+        }
+        layerDim = std::min(layerDim, SCENE_BATCH_MAX_LAYER_SIZE);
+        GLsizei layers = (GLsizei)std::max<size_t>(textures.size(), 1);
+
+        glGenTextures(1, &textureArray);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+        int levels = 1 + (int)std::floor(std::log2((float)layerDim));
+        for (int level = 0, dim = layerDim; level < levels; ++level, dim = std::max(dim / 2, 1))
+            glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GL_RGBA8, dim, dim, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+        GLuint fbos[2];
+        glGenFramebuffers(2, fbos);
+        layerLevel.assign(textures.size(), -1);
+        for (size_t layer = 0; layer < textures.size(); ++layer)
+            blitLayer(layer, fbos);
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(2, fbos);
+
+        glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+        glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    // Nível de origem de uma camada: o mais grosso que ainda cobre layerDim, sem passar do mais fino já
+    // residente (GL_TEXTURE_BASE_LEVEL, que desce enquanto o TextureStreamer envia os níveis maiores)
+    int sourceLevel(GLuint texture) {
+        GLint base = 0, maxLevel = 0;
+        glBindTexture(GL_TEXTURE_2D, texture);
+        glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, &base);
+        glGetTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, &maxLevel);
+        int level = base;
+        for (;;) {
+            GLint w = 0, h = 0;
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, level + 1, GL_TEXTURE_WIDTH, &w);
+            glGetTexLevelParameteriv(GL_TEXTURE_2D, level + 1, GL_TEXTURE_HEIGHT, &h);
+            if (level + 1 > maxLevel || std::max(w, h) < layerDim) return level;
+            ++level;
+        }
+    }
+
+    // Redimensiona (blit linear) o nível de origem da textura para a camada do array
+    void blitLayer(size_t layer, const GLuint fbos[2]) {
+        int level = sourceLevel(textures[layer]);
+        layerLevel[layer] = level;
+        GLint w = 0, h = 0;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_WIDTH, &w);
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_HEIGHT, &h);
+
+        // Texturas comprimidas (.ktx2) não servem de framebuffer: o nível volta descomprimido
+        // pelo driver para uma cópia RGBA8 temporária, que é a origem do blit
+        GLint compressed = GL_FALSE;
+        glGetTexLevelParameteriv(GL_TEXTURE_2D, level, GL_TEXTURE_COMPRESSED, &compressed);
+        GLuint source = textures[layer], staging = 0;
+        GLint readLevel = level;
+        if (compressed) {
+            std::vector<unsigned char> pixels((size_t)w * h * 4);
+            glGetTexImage(GL_TEXTURE_2D, level, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            glGenTextures(1, &staging);
+            glBindTexture(GL_TEXTURE_2D, staging);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+            source = staging;
+            readLevel = 0;
+        }
+
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, fbos[0]);
+        glFramebufferTexture2D(GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, source, readLevel);
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, fbos[1]);
+        glFramebufferTextureLayer(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, textureArray, 0, (GLint)layer);
+        glBlitFramebuffer(0, 0, w, h, 0, 0, layerDim, layerDim, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        if (staging) glDeleteTextures(1, &staging);
+    }
+
+    // Comandos indiretos, ids de registro (0..N-1, divisor 1) e SSBO de registros
+    void buildBuffers() {
+        indirect.clear();
+        indirect.reserve(commands.size());
+        records.assign(totalRecords, DrawRecord());
+        recordMesh.assign(totalRecords, 0);
+        for (const auto& command : commands) {
+            for (size_t k = 0; k < command.copies; ++k) recordMesh[command.firstRecord + k] = command.mesh;
+        }
+        for (const auto& command : commands) {
+            const MeshRange& range = meshes[command.mesh];
+            DrawElementsIndirectCommand cmd;
+            cmd.count = (GLuint)range.source.indexCount;
+            cmd.instanceCount = (GLuint)command.copies;
+            cmd.firstIndex = range.firstIndex;
+            cmd.baseVertex = range.baseVertex;
+            cmd.baseInstance = (GLuint)command.firstRecord;
+            indirect.push_back(cmd);
+
+            for (size_t k = 0; k < command.copies; ++k) {
+                DrawRecord& r = records[command.firstRecord + k];
+                r.materialIndex = command.materialIndex;
+                r.textureLayer = command.layer;
+                setTransform(command.firstRecord + k, glm::mat4(1.0f));
+            }
+        }
+
+        glGenBuffers(1, &indirectBuffer);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawElementsIndirectCommand) * indirect.size(), indirect.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        std::vector<GLuint> ids(totalRecords);
+        for (size_t i = 0; i < totalRecords; ++i) ids[i] = (GLuint)i;
+        glGenBuffers(1, &drawIdBuffer);
+        glBindVertexArray(vao);
+        glBindBuffer(GL_ARRAY_BUFFER, drawIdBuffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(GLuint) * ids.size(), ids.data(), GL_STATIC_DRAW);
+        glVertexAttribIPointer(SCENE_BATCH_DRAW_ID_LOCATION, 1, GL_UNSIGNED_INT, sizeof(GLuint), (void*)0);
+        glEnableVertexAttribArray(SCENE_BATCH_DRAW_ID_LOCATION);
+        glVertexAttribDivisor(SCENE_BATCH_DRAW_ID_LOCATION, 1);
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        glGenBuffers(1, &recordBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, recordBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(DrawRecord) * std::max<size_t>(records.size(), 1), records.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        dirtyBegin = records.size();
+        dirtyEnd = 0;
+        indirectDirtyBegin = indirect.size();
+        indirectDirtyEnd = 0;
+    }
+
+    void bind() {
+        if (dirtyBegin < dirtyEnd) {
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, recordBuffer);
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(DrawRecord) * dirtyBegin,
+                sizeof(DrawRecord) * (dirtyEnd - dirtyBegin), records.data() + dirtyBegin);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+            dirtyBegin = records.size();
+            dirtyEnd = 0;
+        }
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+        if (indirectDirtyBegin < indirectDirtyEnd) {
+            glBufferSubData(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawElementsIndirectCommand) * indirectDirtyBegin,
+                sizeof(DrawElementsIndirectCommand) * (indirectDirtyEnd - indirectDirtyBegin), indirect.data() + indirectDirtyBegin);
+            indirectDirtyBegin = indirect.size();
+            indirectDirtyEnd = 0;
+        }
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, SCENE_BATCH_RECORD_BINDING, recordBuffer);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray);
+        glBindVertexArray(vao);
+    }
+
+    PFNGLMULTIDRAWELEMENTSINDIRECTPROC_SB multiDrawElementsIndirect = nullptr;
+    bool supported = false, built = false;
+
+    std::vector<MeshRange> meshes;
+    std::unordered_map<GLuint, size_t> meshByVbo;
+    std::vector<GLuint> textures;
+    std::unordered_map<GLuint, int> layerByTexture;
+    std::vector<int> layerLevel;     // nível da textura de origem copiado para cada camada
+    std::vector<Command> commands;
+    std::vector<DrawRecord> records;
+    std::vector<size_t> recordMesh;  // malha de cada registro (desquantização em setTransform)
+    std::vector<DrawElementsIndirectCommand> indirect;
+    size_t totalRecords = 0;
+    size_t arenaVertexCount = 0, arenaIndexCount = 0;
+    VertexFormat format = VertexFormat::Full;
+    size_t dirtyBegin = 0, dirtyEnd = 0;
+    size_t indirectDirtyBegin = 0, indirectDirtyEnd = 0;
+    int layerDim = 1;
+
+    GLuint vao = 0, arenaVbo = 0, arenaEbo = 0;
+    GLuint indirectBuffer = 0, drawIdBuffer = 0, recordBuffer = 0;
+    GLuint textureArray = 0;
+};
+
+#endif
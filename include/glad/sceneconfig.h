@@ -0,0 +1,177 @@
+#ifndef SCENE_CONFIG_H
+#define SCENE_CONFIG_H
+
+// Arquivo de configuração da cena (Cenas/config.txt) lido para uma estrutura, sem tocar no OpenGL.
+// O Cena_Castle aplica a estrutura sobre a cena viva: na carga inicial sobre a cena vazia e, na recarga
+// a quente, comparando com a configuração anterior para só carregar o que é novo.
+//
+//   camera <posição> <yaw> <pitch> <near> <far>
+//   light <posição> [<cor> <raio>]       (sem raio: luz principal; com raio: luz pontual nos clusters)
+//   lights <quantidade> <centro> <largura> <profundidade> <altura> <raio> [semente]
+//   simulation <ticks por segundo>
+//   object <.obj> <pos> <rot> <escala> <trajetoria.txt|none> [parent <índice do objeto>]
+//   instances <.obj> <quantidade> <centro> <largura> <profundidade> <escala> [semente]
+
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+struct SceneObjectConfig {
+    std::string model;                  // nome do .obj
+    glm::vec3 position = glm::vec3(0.0f), rotation = glm::vec3(0.0f);
+    float scale = 1.0f;
+    std::string trajectory;             // nome do arquivo de trajetória, vazio para "none"
+    int parent = -1;                    // objeto pai (índice de uma linha object anterior), -1 para raiz
+};
+
+struct SceneInstancesConfig {
+    std::string model;
+    size_t count = 0;
+    glm::vec3 center = glm::vec3(0.0f);
+    float width = 0.0f, depth = 0.0f, scale = 1.0f;
+    unsigned seed = 1;
+
+    bool operator==(const SceneInstancesConfig& o) const {
+        return model == o.model && count == o.count && center == o.center && width == o.width &&
+               depth == o.depth && scale == o.scale && seed == o.seed;
+    }
+};
+
+// Luz pontual com alcance finito; a cor pode passar de 1 (intensidade)
+struct SceneLightConfig {
+    glm::vec3 position = glm::vec3(0.0f);
+    glm::vec3 color = glm::vec3(1.0f);
+    float radius = 0.0f;
+};
+
+// Luzes espalhadas em uma caixa (tochas para testes de carga), como a diretiva instances
+struct SceneLightGroupConfig {
+    size_t count = 0;
+    glm::vec3 center = glm::vec3(0.0f);
+    float width = 0.0f, depth = 0.0f, height = 0.0f, radius = 1.0f;
+    unsigned seed = 1;
+};
+
+struct SceneConfig {
+    glm::vec3 cameraPosition = glm::vec3(0.0f);
+    float cameraYaw = -90.0f, cameraPitch = 0.0f, cameraNear = 0.1f, cameraFar = 100.0f;
+    glm::vec3 light = glm::vec3(0.0f);         // luz principal (a primeira linha light sem raio)
+    std::vector<SceneLightConfig> lights;      // luzes pontuais das linhas light com raio
+    std::vector<SceneLightGroupConfig> lightGroups;
+    double simulationRate = 0.0;        // 0: taxa padrão da Simulation
+    std::vector<SceneObjectConfig> objects;
+    std::vector<SceneInstancesConfig> instances;
+
+    bool sameCamera(const SceneConfig& o) const {
+        return cameraPosition == o.cameraPosition && cameraYaw == o.cameraYaw && cameraPitch == o.cameraPitch &&
+               cameraNear == o.cameraNear && cameraFar == o.cameraFar;
+    }
+};
+
+// Lê o arquivo inteiro; false se não abrir (a configuração fica como estava)
+inline bool parseSceneConfig(const std::string& path, SceneConfig& out) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    SceneConfig config;
+    bool hasMainLight = false;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+
+        std::istringstream iss(line);
+        std::string keyword;
+        iss >> keyword;
+
+        if (keyword == "camera") {
+            iss >> config.cameraPosition.x >> config.cameraPosition.y >> config.cameraPosition.z >> config.cameraYaw
+                >> config.cameraPitch >> config.cameraNear >> config.cameraFar;
+        } else if (keyword == "simulation") {
+            iss >> config.simulationRate;
+        } else if (keyword == "light") {
+            SceneLightConfig light;
+            iss >> light.position.x >> light.position.y >> light.position.z;
+            if (iss >> light.color.r >> light.color.g >> light.color.b >> light.radius && light.radius > 0.0f)
+                config.lights.push_back(light);
+            else if (!hasMainLight)
+                config.light = light.position;
+            hasMainLight |= light.radius <= 0.0f;
+        } else if (keyword == "lights") {
+            SceneLightGroupConfig group;
+            iss >> group.count >> group.center.x >> group.center.y >> group.center.z >> group.width >> group.depth
+                >> group.height >> group.radius;
+            if (!(iss >> group.seed)) group.seed = 1;
+            config.lightGroups.push_back(group);
+        } else if (keyword == "object") {
+            SceneObjectConfig object;
+            iss >> object.model >> object.position.x >> object.position.y >> object.position.z
+                >> object.rotation.x >> object.rotation.y >> object.rotation.z >> object.scale >> object.trajectory;
+            if (object.trajectory == "none") object.trajectory.clear();
+            // Hierarquia: posição, rotação, escala e trajetória passam a ser relativas ao pai
+            std::string option;
+            while (iss >> option)
+                if (option == "parent") iss >> object.parent;
+            config.objects.push_back(object);
+        } else if (keyword == "instances") {
+            SceneInstancesConfig group;
+            iss >> group.model >> group.count >> group.center.x >> group.center.y >> group.center.z
+                >> group.width >> group.depth >> group.scale;
+            if (!(iss >> group.seed)) group.seed = 1;
+            config.instances.push_back(group);
+        }
+    }
+    out = std::move(config);
+    return true;
+}
+
+// Todas as luzes pontuais da configuração: as linhas light com raio e as geradas pelas linhas lights,
+// com cores de chama (laranja a amarelo) e posições sorteadas pela semente de cada grupo
+inline std::vector<SceneLightConfig> scenePointLights(const SceneConfig& config) {
+    std::vector<SceneLightConfig> lights = config.lights;
+    for (const SceneLightGroupConfig& group : config.lightGroups) {
+        std::mt19937 rng(group.seed);
+        std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+        for (size_t k = 0; k < group.count; ++k) {
+            SceneLightConfig light;
+            light.position = group.center + glm::vec3((unit(rng) - 0.5f) * group.width, unit(rng) * group.height,
+                                                      (unit(rng) - 0.5f) * group.depth);
+            float warmth = unit(rng);
+            light.color = glm::vec3(1.0f, 0.45f + 0.35f * warmth, 0.15f + 0.2f * warmth) * (1.5f + unit(rng));
+            light.radius = group.radius;
+            lights.push_back(light);
+        }
+    }
+    return lights;
+}
+
+// Casa cada entrada nova com uma anterior do mesmo modelo, para reaproveitar a malha que já está na GPU:
+// primeiro a de mesmo índice, depois a primeira ainda livre. -1 = precisa carregar. Modelos anteriores
+// com nome vazio (o .obj mudou no disco) não casam com nada.
+inline std::vector<int> matchSceneModels(const std::vector<std::string>& previous, const std::vector<std::string>& next) {
+    std::vector<int> match(next.size(), -1);
+    std::vector<bool> taken(previous.size(), false);
+    for (size_t i = 0; i < next.size() && i < previous.size(); ++i) {
+        if (!previous[i].empty() && previous[i] == next[i]) {
+            match[i] = (int)i;
+            taken[i] = true;
+        }
+    }
+    for (size_t i = 0; i < next.size(); ++i) {
+        if (match[i] >= 0) continue;
+        for (size_t j = 0; j < previous.size(); ++j) {
+            if (!taken[j] && !previous[j].empty() && previous[j] == next[i]) {
+                match[i] = (int)j;
+                taken[j] = true;
+                break;
+            }
+        }
+    }
+    return match;
+}
+
+#endif
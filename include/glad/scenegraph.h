@@ -0,0 +1,186 @@
+#ifndef SCENE_GRAPH_H
+#define SCENE_GRAPH_H
+
+// Grafo de cena: cada nó tem translação, rotação (Euler X, Y, Z, em radianos) e escala uniforme
+// relativas ao pai. As matrizes de mundo e de normal ficam em arrays contíguos, indexados pelo nó.
+// Os setters só marcam o nó como sujo quando o valor muda; update() recalcula a matriz local dos
+// nós sujos e a de mundo deles e de todos os descendentes. Sem nada sujo update() não percorre os nós,
+// então uma cena parada não custa nada por frame.
+// Um pai sempre vem antes dos filhos (add só aceita pais já existentes), e uma passada em ordem basta.
+// As matrizes locais saem em lote do TransformBatch (SIMD); a de normal local é R·S^-1 e a de mundo é o
+// produto das locais pela cadeia de pais, sem inversa. Sem hierarquia nenhuma, o lote escreve direto
+// nas matrizes de mundo.
+
+#include "transformbatch.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class SceneGraph {
+public:
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+
+    // Cria um nó filho de `parent` (NO_PARENT: raiz) e devolve seu índice; um pai inválido vira raiz
+    uint32_t add(uint32_t parent = NO_PARENT) {
+        uint32_t node = (uint32_t)parents.size();
+        parents.push_back(parent < node ? parent : NO_PARENT);
+        transforms.push_back(glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(1.0f));
+        worlds.push_back(glm::mat4(1.0f));
+        normals.push_back(glm::mat3(1.0f));
+        dirty.push_back(0);
+        moved.push_back(0);
+        markDirty(node);
+        // O primeiro filho liga as matrizes locais separadas das de mundo; até aqui o lote escrevia direto
+        // nas de mundo, então todos os nós são refeitos uma vez
+        if (parents.back() != NO_PARENT && !hierarchy) {
+            hierarchy = true;
+            locals.resize(parents.size());
+            localNormals.resize(parents.size());
+            for (uint32_t i = 0; i < node; ++i) markDirty(i);
+        } else if (hierarchy) {
+            locals.push_back(glm::mat4(1.0f));
+            localNormals.push_back(glm::mat3(1.0f));
+        }
+        return node;
+    }
+
+    void clear() {
+        parents.clear();
+        transforms.clear();
+        locals.clear();
+        worlds.clear();
+        localNormals.clear();
+        normals.clear();
+        dirty.clear();
+        moved.clear();
+        dirtyNodes.clear();
+        changed.clear();
+        hierarchy = false;
+    }
+
+    void setTranslation(uint32_t node, const glm::vec3& value) {
+        if (transforms.tx[node] == value.x && transforms.ty[node] == value.y && transforms.tz[node] == value.z) return;
+        transforms.tx[node] = value.x;
+        transforms.ty[node] = value.y;
+        transforms.tz[node] = value.z;
+        markDirty(node);
+    }
+
+    void setRotation(uint32_t node, const glm::vec3& value) {
+        if (transforms.rx[node] == value.x && transforms.ry[node] == value.y && transforms.rz[node] == value.z) return;
+        transforms.rx[node] = value.x;
+        transforms.ry[node] = value.y;
+        transforms.rz[node] = value.z;
+        markDirty(node);
+    }
+
+    void setScale(uint32_t node, float value) {
+        if (transforms.sx[node] == value) return;
+        transforms.sx[node] = transforms.sy[node] = transforms.sz[node] = value;
+        markDirty(node);
+    }
+
+    // Recalcula o que ficou sujo desde a última chamada; devolve quantos nós tiveram a matriz de mundo
+    // refeita (os índices ficam em changedNodes(), em ordem crescente)
+    size_t update() {
+        changed.clear();
+        if (dirtyNodes.empty()) return 0;
+
+        std::sort(dirtyNodes.begin(), dirtyNodes.end());
+        composeDirty(hierarchy ? locals.data() : worlds.data(), hierarchy ? localNormals.data() : normals.data());
+        for (uint32_t i : dirtyNodes) dirty[i] = 0;
+
+        if (!hierarchy) {
+            changed.swap(dirtyNodes);
+            dirtyNodes.clear();
+            return changed.size();
+        }
+
+        for (uint32_t i : dirtyNodes) moved[i] = 1;
+        for (uint32_t i = dirtyNodes.front(); i < parents.size(); ++i) {
+            uint32_t parent = parents[i];
+            if (parent != NO_PARENT && moved[parent]) moved[i] = 1;
+            if (!moved[i]) continue;
+
+            if (parent == NO_PARENT) {
+                worlds[i] = locals[i];
+                normals[i] = localNormals[i];
+            } else {
+                worlds[i] = worlds[parent] * locals[i];
+                normals[i] = normals[parent] * localNormals[i];
+            }
+            changed.push_back(i);
+        }
+        for (uint32_t i : changed) moved[i] = 0;
+        dirtyNodes.clear();
+        return changed.size();
+    }
+
+    size_t size() const { return parents.size(); }
+    uint32_t parent(uint32_t node) const { return parents[node]; }
+    glm::vec3 translation(uint32_t node) const { return transforms.translation(node); }
+    glm::vec3 rotation(uint32_t node) const { return transforms.rotation(node); }
+    float scale(uint32_t node) const { return transforms.sx[node]; }
+
+    // Válidas depois de update()
+    const glm::mat4& world(uint32_t node) const { return worlds[node]; }
+    const glm::mat3& normal(uint32_t node) const { return normals[node]; }
+    const std::vector<glm::mat4>& worldMatrices() const { return worlds; }
+    const std::vector<uint32_t>& changedNodes() const { return changed; }
+
+private:
+    void markDirty(uint32_t node) {
+        if (!dirty[node]) {
+            dirty[node] = 1;
+            dirtyNodes.push_back(node);
+        }
+    }
+
+    // Matrizes locais dos nós sujos (dirtyNodes em ordem): com todos sujos o lote corre sobre os arrays
+    // do grafo; senão os sujos são copiados para um lote contíguo e o resultado espalhado de volta
+    void composeDirty(glm::mat4* models, glm::mat3* normalsOut) {
+        size_t count = dirtyNodes.size();
+        if (count == parents.size()) {
+            transforms.compose(0, count, models, normalsOut);
+            return;
+        }
+        gathered.resize(count);
+        for (size_t k = 0; k < count; ++k) {
+            uint32_t i = dirtyNodes[k];
+            gathered.tx[k] = transforms.tx[i];
+            gathered.ty[k] = transforms.ty[i];
+            gathered.tz[k] = transforms.tz[i];
+            gathered.rx[k] = transforms.rx[i];
+            gathered.ry[k] = transforms.ry[i];
+            gathered.rz[k] = transforms.rz[i];
+            gathered.sx[k] = transforms.sx[i];
+            gathered.sy[k] = transforms.sy[i];
+            gathered.sz[k] = transforms.sz[i];
+        }
+        gatheredModels.resize(count);
+        gatheredNormals.resize(count);
+        gathered.compose(0, count, gatheredModels.data(), gatheredNormals.data());
+        for (size_t k = 0; k < count; ++k) {
+            models[dirtyNodes[k]] = gatheredModels[k];
+            normalsOut[dirtyNodes[k]] = gatheredNormals[k];
+        }
+    }
+
+    std::vector<uint32_t> parents;
+    TransformBatch transforms;                  // TRS local de cada nó, em SoA
+    std::vector<glm::mat4> locals, worlds;      // locals só existe com hierarquia
+    std::vector<glm::mat3> localNormals, normals;
+    std::vector<uint8_t> dirty, moved;          // moved: matriz de mundo refeita nesta passada (propaga aos filhos)
+    std::vector<uint32_t> dirtyNodes, changed;
+    bool hierarchy = false;
+
+    TransformBatch gathered;                    // rascunho de composeDirty
+    std::vector<glm::mat4> gatheredModels;
+    std::vector<glm::mat3> gatheredNormals;
+};
+
+#endif
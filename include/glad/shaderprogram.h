@@ -0,0 +1,137 @@
+#ifndef SHADER_PROGRAM_H
+#define SHADER_PROGRAM_H
+
+// Programa de shader com as localizações de todos os uniformes resolvidas uma única vez, logo após o link.
+// O loop de renderização guarda os GLint retornados por uniform() e nunca mais procura por nome.
+// buildFiles lê os fontes do disco (recarga a quente): se a nova versão não compila, o programa
+// anterior continua valendo.
+
+#include <glad/glad.h>
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class ShaderProgram {
+public:
+    GLuint id = 0;
+
+    // Compila e liga os shaders; em caso de erro imprime o log do driver e retorna false
+    bool build(const char* vertexSource, const char* fragmentSource) {
+        GLuint vertexShader = compile(GL_VERTEX_SHADER, vertexSource);
+        GLuint fragmentShader = compile(GL_FRAGMENT_SHADER, fragmentSource);
+        if (!vertexShader || !fragmentShader) {
+            glDeleteShader(vertexShader);
+            glDeleteShader(fragmentShader);
+            return false;
+        }
+
+        GLuint program = glCreateProgram();
+        glAttachShader(program, vertexShader);
+        glAttachShader(program, fragmentShader);
+        glLinkProgram(program);
+        glDeleteShader(vertexShader);
+        glDeleteShader(fragmentShader);
+
+        GLint linked = GL_FALSE;
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+        if (!linked) {
+            std::cerr << "Erro ao ligar o programa de shader:\n" << programLog(program) << "\n";
+            glDeleteProgram(program);
+            return false;
+        }
+
+        if (id) glDeleteProgram(id);
+        id = program;
+        cacheUniforms();
+        return true;
+    }
+
+    // Mesmo que build, com os fontes lidos de arquivos
+    bool buildFiles(const std::string& vertexPath, const std::string& fragmentPath) {
+        std::string vertexSource, fragmentSource;
+        if (!readSource(vertexPath, vertexSource) || !readSource(fragmentPath, fragmentSource)) return false;
+        return build(vertexSource.c_str(), fragmentSource.c_str());
+    }
+
+    static bool readSource(const std::string& path, std::string& source) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Erro ao abrir o shader " << path << "\n";
+            return false;
+        }
+        std::ostringstream text;
+        text << file.rdbuf();
+        source = text.str();
+        return true;
+    }
+
+    void use() const { glUseProgram(id); }
+
+    // Localização cacheada do uniforme (-1 se não existir ou tiver sido removido pelo compilador)
+    GLint uniform(const std::string& name) const {
+        auto it = locations.find(name);
+        return it != locations.end() ? it->second : -1;
+    }
+
+private:
+    static GLuint compile(GLenum type, const char* source) {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &source, NULL);
+        glCompileShader(shader);
+
+        GLint compiled = GL_FALSE;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+        if (!compiled) {
+            GLint length = 0;
+            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &length);
+            std::vector<char> log(length > 1 ? length : 1, '\0');
+            glGetShaderInfoLog(shader, (GLsizei)log.size(), NULL, log.data());
+            std::cerr << "Erro ao compilar " << (type == GL_VERTEX_SHADER ? "vertex" : "fragment") << " shader:\n" << log.data() << "\n";
+            glDeleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+
+    static std::string programLog(GLuint program) {
+        GLint length = 0;
+        glGetProgramiv(program, GL_INFO_LOG_LENGTH, &length);
+        std::vector<char> log(length > 1 ? length : 1, '\0');
+        glGetProgramInfoLog(program, (GLsizei)log.size(), NULL, log.data());
+        return log.data();
+    }
+
+    // Percorre os uniformes ativos do programa e guarda a localização de cada um
+    void cacheUniforms() {
+        locations.clear();
+        GLint count = 0, maxLength = 0;
+        glGetProgramiv(id, GL_ACTIVE_UNIFORMS, &count);
+        glGetProgramiv(id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+        std::vector<char> buffer(maxLength > 1 ? maxLength : 1);
+
+        for (GLint i = 0; i < count; ++i) {
+            GLsizei length = 0;
+            GLint size = 0;
+            GLenum type = 0;
+            glGetActiveUniform(id, (GLuint)i, (GLsizei)buffer.size(), &length, &size, &type, buffer.data());
+            std::string name(buffer.data(), length);
+
+            // Membros de uniform blocks não têm localização
+            GLint location = glGetUniformLocation(id, name.c_str());
+            if (location < 0) continue;
+
+            // Arrays aparecem como "nome[0]"; registra também o nome sem o sufixo
+            if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+                locations[name.substr(0, name.size() - 3)] = location;
+            locations[name] = location;
+        }
+    }
+
+    std::unordered_map<std::string, GLint> locations;
+};
+
+#endif
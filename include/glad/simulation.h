@@ -0,0 +1,169 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+
+// Simulação com passo fixo em uma thread própria: as trajetórias avançam em ticks de 1/rate segundos,
+// medidos com relógio em double (steady_clock), independentes da taxa de frames. Cada tick publica as
+// posições em um par de snapshots (anterior e atual); o renderizador interpola entre os dois um tick
+// atrás do relógio, então frames lentos não atrasam a animação e a simulação não espera o desenho.
+// Sem start() a mesma classe roda na thread de quem chama advanceTo (modo sem janela, reprodutível).
+
+#include "trajectories.h"
+#include "profiler.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class Simulation {
+public:
+    static constexpr double DEFAULT_RATE = 120.0;   // ticks por segundo
+    static const int MAX_CATCH_UP = 30;             // ticks por chamada antes de descartar o atraso
+
+    Simulation() = default;
+    ~Simulation() { stop(); }
+
+    Simulation(const Simulation&) = delete;
+    Simulation& operator=(const Simulation&) = delete;
+
+    // Assume o sistema de trajetórias e volta ao tick 0; para a thread se estiver rodando
+    void reset(TrajectorySystem system, double rate = DEFAULT_RATE) {
+        stop();
+        trajectories = std::move(system);
+        tickRate = rate > 0.0 ? rate : DEFAULT_RATE;
+        tick = 0;
+        dropped = 0;
+        origin = std::chrono::steady_clock::now();
+        std::lock_guard<std::mutex> lock(mutex);
+        capture(current);
+        previous = current;
+        currentTick = previousTick = 0;
+    }
+
+    // Recarga da cena: troca o sistema sem voltar ao tick 0. O mover i continua o mover previousMover[i]
+    // do sistema atual (-1: começa agora); uma taxa nova mantém o instante da simulação
+    void replace(TrajectorySystem system, const std::vector<int>& previousMover, double rate = DEFAULT_RATE) {
+        bool wasRunning = running;
+        stop();
+        system.resume(trajectories, previousMover);
+        trajectories = std::move(system);
+        double newRate = rate > 0.0 ? rate : DEFAULT_RATE;
+        if (newRate != tickRate) {
+            tick = static_cast<uint64_t>(std::floor(tick / tickRate * newRate));
+            tickRate = newRate;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            capture(current);
+            previous = current;
+            currentTick = previousTick = tick;
+        }
+        if (wasRunning) start();
+    }
+
+    void start() {
+        if (running) return;
+        running = true;
+        origin = std::chrono::steady_clock::now() - toDuration(tick / tickRate);
+        worker = std::thread(&Simulation::run, this);
+    }
+
+    void stop() {
+        running = false;
+        if (worker.joinable()) worker.join();
+    }
+
+    // Executa os ticks que faltam até `time` segundos de simulação (chamado pela thread ou, sem
+    // start(), por quem controla o tempo)
+    void advanceTo(double time) {
+        uint64_t target = static_cast<uint64_t>(std::floor(time * tickRate + 1e-6));
+        if (target <= tick) return;
+        // Uma parada longa (depurador, máquina suspensa) não vira uma rajada de ticks: pula o atraso
+        if (target - tick > MAX_CATCH_UP) {
+            dropped += target - tick - MAX_CATCH_UP;
+            tick = target - MAX_CATCH_UP;
+        }
+        const float dt = static_cast<float>(1.0 / tickRate);
+        while (tick < target) {
+            PROFILE_SCOPE("simulation tick");
+            if (!paused) trajectories.update(dt);
+            ++tick;
+            capture(scratch);
+            // Rotação dos buffers: o atual vira o anterior e o recém-escrito vira o atual
+            std::lock_guard<std::mutex> lock(mutex);
+            std::swap(previous, scratch);
+            std::swap(previous, current);
+            previousTick = currentTick;
+            currentTick = tick;
+        }
+    }
+
+    // Posições no instante `time`, interpoladas entre os dois últimos ticks publicados. Para ter sempre
+    // um par ao redor do instante, o renderizador pede o relógio menos um tick (renderTime()).
+    void sample(double time, std::vector<glm::vec3>& positions) const {
+        std::lock_guard<std::mutex> lock(mutex);
+        positions.resize(current.size());
+        double span = static_cast<double>(currentTick - previousTick);
+        double alpha = span > 0.0 ? (time * tickRate - previousTick) / span : 1.0;
+        float a = static_cast<float>(std::min(std::max(alpha, 0.0), 1.0));
+        for (size_t i = 0; i < current.size(); ++i) positions[i] = glm::mix(previous[i], current[i], a);
+    }
+
+    // Relógio da simulação em segundos (double: não perde precisão depois de dias ligado)
+    double now() const {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - origin).count();
+    }
+
+    double renderTime() const { return now() - 1.0 / tickRate; }
+    double rate() const { return tickRate; }
+    uint64_t ticks() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return currentTick;
+    }
+    uint64_t droppedTicks() const { return dropped; }
+    bool threaded() const { return running; }
+
+    void setPaused(bool value) { paused = value; }
+    bool isPaused() const { return paused; }
+
+private:
+    void run() {
+        while (running) {
+            advanceTo(now());
+            // Dorme até o próximo tick; acordar um pouco tarde só atrasa a publicação, não a animação
+            std::this_thread::sleep_until(origin + toDuration((tick + 1) / tickRate));
+        }
+    }
+
+    void capture(std::vector<glm::vec3>& out) const {
+        out.resize(trajectories.size());
+        for (size_t i = 0; i < out.size(); ++i) out[i] = trajectories.position(i);
+    }
+
+    static std::chrono::steady_clock::duration toDuration(double seconds) {
+        return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(seconds));
+    }
+
+    // Só a thread da simulação mexe nestes depois de start()
+    TrajectorySystem trajectories;
+    double tickRate = DEFAULT_RATE;
+    uint64_t tick = 0;
+    std::atomic<uint64_t> dropped{ 0 };
+    std::atomic<bool> paused{ false };
+    std::atomic<bool> running{ false };
+    std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+    std::thread worker;
+
+    mutable std::mutex mutex;            // protege o par publicado
+    std::vector<glm::vec3> previous, current;
+    uint64_t previousTick = 0, currentTick = 0;
+    std::vector<glm::vec3> scratch;      // escrito fora do mutex pela simulação
+};
+
+#endif
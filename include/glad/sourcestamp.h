@@ -0,0 +1,60 @@
+#ifndef SOURCE_STAMP_H
+#define SOURCE_STAMP_H
+
+// Versão de um arquivo-fonte guardada nos caches derivados dele (.meshbin, .ktx2): o cache vale
+// enquanto a fonte tiver o mesmo tamanho e o mesmo mtime, ou o mesmo conteúdo
+
+#include "mappedfile.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <system_error>
+
+// Identifica a versão de um arquivo-fonte: tamanho e mtime para a checagem rápida,
+// hash do conteúdo (FNV-1a) para quando o mtime mudou mas o arquivo não
+struct SourceStamp {
+    uint64_t size;
+    int64_t mtime;
+    uint64_t hash;
+};
+
+inline uint64_t fnv1a64(const unsigned char* data, size_t size) {
+    uint64_t hash = 1469598103934665603ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+// Tamanho e data de modificação, sem ler o conteúdo
+inline bool statSource(const std::string& path, SourceStamp& stamp) {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(path, ec);
+    if (ec) return false;
+    auto mtime = std::filesystem::last_write_time(path, ec);
+    if (ec) return false;
+    stamp.size = size;
+    stamp.mtime = static_cast<int64_t>(mtime.time_since_epoch().count());
+    return true;
+}
+
+inline bool hashSource(const std::string& path, SourceStamp& stamp) {
+    MappedFile file;
+    if (!file.open(path)) return false;
+    stamp.hash = fnv1a64(file.data(), file.size());
+    return true;
+}
+
+inline bool sourceMatches(const std::string& path, const SourceStamp& cached) {
+    SourceStamp current = {};
+    if (!statSource(path, current)) return false;
+    if (current.size != cached.size) return false;
+    if (current.mtime == cached.mtime) return true;
+    // O mtime mudou (checkout, cópia): compara o conteúdo antes de descartar o cache
+    return hashSource(path, current) && current.hash == cached.hash;
+}
+
+#endif
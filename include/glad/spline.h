@@ -0,0 +1,167 @@
+#ifndef SPLINE_H
+#define SPLINE_H
+
+// Curvas fechadas (Catmull-Rom ou Bézier cúbica por partes) parametrizadas por comprimento de arco.
+// Na construção a curva é amostrada em SAMPLES_PER_SEGMENT pontos por segmento; a tabela guarda o
+// comprimento acumulado (Simpson sobre |P'(t)|) e a velocidade |P'(t)| nas pontas de cada intervalo. Avaliar a
+// posição a uma distância s do início é uma busca binária na tabela, a inversão do comprimento dentro
+// do intervalo (velocidade variando linearmente: uma equação do 2º grau) e uma avaliação do polinômio.
+// Assim um objeto anda com velocidade constante e a posição depende só do tempo, sem erro acumulado.
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+enum class CurveType { Linear, CatmullRom, Bezier };
+
+class SplineCurve {
+public:
+    static const int SAMPLES_PER_SEGMENT = 32;
+
+    // Catmull-Rom: passa por todos os pontos (pelo menos 2). Bézier: âncora, controle, controle,
+    // âncora, ... com 3 pontos por segmento (o último segmento volta à primeira âncora).
+    // false se o número de pontos não serve para o tipo.
+    bool build(const std::vector<glm::vec3>& controlPoints, CurveType curveType) {
+        type = curveType;
+        points = controlPoints;
+        cells.clear();
+        total = 0.0f;
+        size_t n = points.size();
+        if (type == CurveType::Bezier) segments = n >= 3 && n % 3 == 0 ? n / 3 : 0;
+        else segments = n >= 2 ? n : 0;
+        if (!segments) return false;
+
+        size_t cellCount = segments * SAMPLES_PER_SEGMENT;
+        const float dt = 1.0f / SAMPLES_PER_SEGMENT;
+        cells.resize(cellCount);
+        double sum = 0.0;   // soma em double: em curvas longas o float perderia os trechos curtos
+        for (size_t k = 0; k < cellCount; ++k) {
+            size_t segment = k / SAMPLES_PER_SEGMENT;
+            float t = (k % SAMPLES_PER_SEGMENT) * dt;
+            Cell& cell = cells[k];
+            cell.start = static_cast<float>(sum);
+            cell.v0 = glm::length(derivative(segment, t));
+            cell.v1 = glm::length(derivative(segment, t + dt));
+            float middle = glm::length(derivative(segment, t + 0.5f * dt));
+            sum += dt / 6.0 * (cell.v0 + 4.0 * middle + cell.v1);   // Simpson
+        }
+        total = static_cast<float>(sum);
+        return total > 0.0f;
+    }
+
+    float length() const { return total; }
+
+    // Posição a uma distância s do início, medida ao longo da curva (s fora de [0, length) dá a volta)
+    glm::vec3 sample(float s) const {
+        size_t hint = 0;
+        return sample(s, hint);
+    }
+
+    // Igual, com o intervalo da chamada anterior como ponto de partida: quem anda para a frente quase
+    // sempre está no mesmo intervalo ou no seguinte, e só cai na busca binária ao pular vários
+    glm::vec3 sample(float s, size_t& hint) const {
+        if (total <= 0.0f) return points.empty() ? glm::vec3(0.0f) : points[0];
+        s = std::fmod(s, total);
+        if (s < 0.0f) s += total;
+
+        size_t k = findCell(s, hint);
+        hint = k;
+        float t = (k % SAMPLES_PER_SEGMENT + invert(k, s)) / SAMPLES_PER_SEGMENT;
+        return evaluate(k / SAMPLES_PER_SEGMENT, t);
+    }
+
+    // Posição no segmento, com t de 0 a 1
+    glm::vec3 evaluate(size_t segment, float t) const {
+        glm::vec3 p0, p1, p2, p3;
+        controlPoints(segment, p0, p1, p2, p3);
+        float t2 = t * t, t3 = t2 * t;
+        if (type == CurveType::CatmullRom) {
+            return 0.5f * (2.0f * p1 + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+                           (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+        }
+        if (type == CurveType::Bezier) {
+            float u = 1.0f - t;
+            return u * u * u * p0 + 3.0f * u * u * t * p1 + 3.0f * u * t2 * p2 + t3 * p3;
+        }
+        return glm::mix(p1, p2, t);
+    }
+
+    // dP/dt no segmento
+    glm::vec3 derivative(size_t segment, float t) const {
+        glm::vec3 p0, p1, p2, p3;
+        controlPoints(segment, p0, p1, p2, p3);
+        if (type == CurveType::CatmullRom) {
+            return 0.5f * ((p2 - p0) + 2.0f * (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t +
+                           3.0f * (3.0f * p1 - p0 - 3.0f * p2 + p3) * t * t);
+        }
+        if (type == CurveType::Bezier) {
+            float u = 1.0f - t;
+            return 3.0f * u * u * (p1 - p0) + 6.0f * u * t * (p2 - p1) + 3.0f * t * t * (p3 - p2);
+        }
+        return p2 - p1;
+    }
+
+    size_t segmentCount() const { return segments; }
+    size_t tableBytes() const { return cells.size() * sizeof(Cell); }
+
+private:
+    // Intervalo da tabela: comprimento acumulado no início e |dP/dt| nas duas pontas, calculado dentro
+    // do segmento do intervalo (nas emendas da Bézier a tangente pode mudar de tamanho: a curva é só C0)
+    struct Cell {
+        float start, v0, v1;
+    };
+
+    float cellEnd(size_t k) const { return k + 1 < cells.size() ? cells[k + 1].start : total; }
+
+    // Último k com cells[k].start <= s
+    size_t findCell(float s, size_t hint) const {
+        if (hint < cells.size() && cells[hint].start <= s) {
+            for (size_t k = hint; k < cells.size() && k < hint + 4; ++k)
+                if (s < cellEnd(k)) return k;
+        }
+        auto next = std::upper_bound(cells.begin() + 1, cells.end(), s, [](float v, const Cell& c) { return v < c.start; });
+        return next - cells.begin() - 1;
+    }
+
+    // Os 4 pontos que definem o segmento. Catmull-Rom: vizinho anterior, início, fim, vizinho seguinte
+    // (a curva é fechada). Bézier: âncora, dois controles e a próxima âncora. Linear: início e fim em p1, p2.
+    void controlPoints(size_t segment, glm::vec3& p0, glm::vec3& p1, glm::vec3& p2, glm::vec3& p3) const {
+        size_t n = points.size();
+        if (type == CurveType::Bezier) {
+            p0 = points[segment * 3];
+            p1 = points[segment * 3 + 1];
+            p2 = points[segment * 3 + 2];
+            p3 = points[(segment * 3 + 3) % n];
+        } else {
+            p0 = points[(segment + n - 1) % n];
+            p1 = points[segment];
+            p2 = points[(segment + 1) % n];
+            p3 = points[(segment + 2) % n];
+        }
+    }
+
+    // Fração a do intervalo k onde o comprimento acumulado chega a s. Com a velocidade indo de v0 a v1
+    // linearmente, o comprimento percorrido é v0 a + (v1 - v0) a² / 2, proporcional ao do intervalo.
+    // Interpolar só o parâmetro (a proporcional a s) erraria a velocidade onde a curva aperta.
+    float invert(size_t k, float s) const {
+        const Cell& cell = cells[k];
+        float span = cellEnd(k) - cell.start;
+        if (span <= 0.0f) return 0.0f;
+        float r = std::min(std::max((s - cell.start) / span, 0.0f), 1.0f);
+        float v0 = cell.v0, v1 = cell.v1;
+        float target = r * 0.5f * (v0 + v1);
+        // Raiz de (v1 - v0)/2 a² + v0 a - target = 0 na forma estável (sem cancelamento quando v1 ≈ v0)
+        float denominator = v0 + std::sqrt(std::max(v0 * v0 + 2.0f * (v1 - v0) * target, 0.0f));
+        return denominator > 0.0f ? std::min(2.0f * target / denominator, 1.0f) : r;
+    }
+
+    CurveType type = CurveType::Linear;
+    std::vector<glm::vec3> points;
+    std::vector<Cell> cells;      // SAMPLES_PER_SEGMENT por segmento
+    float total = 0.0f;           // comprimento da curva
+    size_t segments = 0;
+};
+
+#endif
@@ -0,0 +1,883 @@
+#ifndef TEXTURE_BAKE_H
+#define TEXTURE_BAKE_H
+
+// Texturas pré-processadas para a GPU: a imagem é reduzida em uma cadeia completa de mipmaps (filtro
+// de caixa 2x2) e cada nível é comprimido em blocos 4x4 (BC1 para imagens opacas, BC3 com alfa, BC7 sob
+// pedido, ou RGBA8 sem compressão). O resultado é gravado ao lado da imagem em um .ktx2 e lido depois
+// mapeado em memória: sem decodificar o PNG nem gerar mipmaps na carga, e com 4x (BC3/BC7) a 8x (BC1)
+// menos memória de vídeo que o RGBA8.
+//
+// Layout do .ktx2 (KTX 2.0 sem supercompressão, little-endian):
+//   identificador | cabeçalho | índice de níveis | DFD (Data Format Descriptor) | pares chave/valor | níveis
+// Os níveis ficam do menor para o maior, alinhados ao tamanho do bloco. Os pares chave/valor guardam a
+// orientação (KTXorientation: "rd" ou "ru" quando a imagem foi invertida na carga) e o SourceStamp da
+// imagem de origem, que invalida o cache quando ela muda.
+//
+// Tudo aqui roda só na CPU (sem OpenGL): o texbake funciona em máquinas sem GPU.
+
+#include "mappedfile.h"
+#include "sourcestamp.h"
+
+// Mesma guarda do assetloader.h: a implementação da stb_image não tem proteção própria
+#ifndef STBI_INCLUDE_STB_IMAGE_H
+#include "stb_image.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+enum class TextureFormat : uint32_t { RGBA8, BC1, BC3, BC7 };
+
+inline const char* textureFormatName(TextureFormat format) {
+    switch (format) {
+    case TextureFormat::BC1: return "BC1";
+    case TextureFormat::BC3: return "BC3";
+    case TextureFormat::BC7: return "BC7";
+    default: return "RGBA8";
+    }
+}
+
+inline bool parseTextureFormat(const std::string& name, TextureFormat& format) {
+    if (name == "rgba8") format = TextureFormat::RGBA8;
+    else if (name == "bc1") format = TextureFormat::BC1;
+    else if (name == "bc3") format = TextureFormat::BC3;
+    else if (name == "bc7") format = TextureFormat::BC7;
+    else return false;
+    return true;
+}
+
+// Bytes por bloco 4x4 (RGBA8: por pixel)
+inline size_t textureBlockBytes(TextureFormat format) {
+    switch (format) {
+    case TextureFormat::BC1: return 8;
+    case TextureFormat::BC3:
+    case TextureFormat::BC7: return 16;
+    default: return 4;
+    }
+}
+
+inline size_t textureLevelBytes(TextureFormat format, uint32_t width, uint32_t height) {
+    if (format == TextureFormat::RGBA8) return static_cast<size_t>(width) * height * 4;
+    return static_cast<size_t>((width + 3) / 4) * ((height + 3) / 4) * textureBlockBytes(format);
+}
+
+// Nível de mipmap apontando para dados de outro dono (arquivo mapeado ou BakedTexture)
+struct TextureLevelView {
+    uint32_t width = 0, height = 0;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+};
+
+struct TextureView {
+    TextureFormat format = TextureFormat::RGBA8;
+    std::vector<TextureLevelView> levels;   // levels[0] é a imagem inteira
+};
+
+// Textura comprimida em memória, com todos os níveis
+struct BakedTexture {
+    TextureFormat format = TextureFormat::RGBA8;
+    bool flipped = false;
+    uint32_t width = 0, height = 0;
+    std::vector<std::vector<uint8_t>> levels;
+
+    TextureView view() const {
+        TextureView v;
+        v.format = format;
+        uint32_t w = width, h = height;
+        for (const auto& level : levels) {
+            v.levels.push_back({ w, h, level.data(), level.size() });
+            w = std::max(w / 2, 1u);
+            h = std::max(h / 2, 1u);
+        }
+        return v;
+    }
+};
+
+// BC1 para imagens opacas, BC3 quando algum pixel tem alfa
+inline TextureFormat chooseTextureFormat(const unsigned char* rgba, size_t pixelCount) {
+    for (size_t i = 0; i < pixelCount; ++i)
+        if (rgba[4 * i + 3] != 255) return TextureFormat::BC3;
+    return TextureFormat::BC1;
+}
+
+// Próximo nível da cadeia: média de 2x2 pixels (em dimensões ímpares a última coluna/linha se repete)
+inline std::vector<uint8_t> downsampleRgba(const uint8_t* src, uint32_t width, uint32_t height) {
+    uint32_t w = std::max(width / 2, 1u), h = std::max(height / 2, 1u);
+    std::vector<uint8_t> dst(static_cast<size_t>(w) * h * 4);
+    for (uint32_t y = 0; y < h; ++y) {
+        const uint8_t* row0 = src + static_cast<size_t>(std::min(2 * y, height - 1)) * width * 4;
+        const uint8_t* row1 = src + static_cast<size_t>(std::min(2 * y + 1, height - 1)) * width * 4;
+        for (uint32_t x = 0; x < w; ++x) {
+            uint32_t x0 = std::min(2 * x, width - 1) * 4, x1 = std::min(2 * x + 1, width - 1) * 4;
+            for (int c = 0; c < 4; ++c)
+                dst[(static_cast<size_t>(y) * w + x) * 4 + c] = static_cast<uint8_t>((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+        }
+    }
+    return dst;
+}
+
+// --- Codificadores de bloco ------------------------------------------------------------------------
+// Cada um recebe os 16 pixels RGBA8 do bloco (linha a linha) e escreve o bloco comprimido.
+
+// Eixo principal (iteração de potência sobre a covariância) e média de n pontos com `dims` canais
+inline void principalAxis(const float (*points)[4], int count, int dims, float mean[4], float axis[4]) {
+    for (int c = 0; c < 4; ++c) mean[c] = axis[c] = 0.0f;
+    for (int i = 0; i < count; ++i)
+        for (int c = 0; c < dims; ++c) mean[c] += points[i][c];
+    for (int c = 0; c < dims; ++c) mean[c] /= count;
+    float cov[4][4] = {};
+    for (int i = 0; i < count; ++i)
+        for (int a = 0; a < dims; ++a)
+            for (int b = 0; b < dims; ++b) cov[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+    float v[4] = { 1.0f, 0.9f, 0.8f, 0.7f };
+    for (int iteration = 0; iteration < 8; ++iteration) {
+        float next[4] = {};
+        for (int a = 0; a < dims; ++a)
+            for (int b = 0; b < dims; ++b) next[a] += cov[a][b] * v[b];
+        float length = 0.0f;
+        for (int a = 0; a < dims; ++a) length = std::max(length, std::abs(next[a]));
+        if (length < 1e-8f) break;
+        for (int a = 0; a < dims; ++a) v[a] = next[a] / length;
+    }
+    float norm = 0.0f;
+    for (int a = 0; a < dims; ++a) norm += v[a] * v[a];
+    norm = std::sqrt(norm);
+    for (int a = 0; a < dims; ++a) axis[a] = norm > 0.0f ? v[a] / norm : 0.0f;
+}
+
+// Mínimos quadrados para os extremos A e B dados os pesos t (0 = A, 1 = B) de cada ponto
+inline bool fitEndpoints(const float (*points)[4], const float* t, int count, int dims, float a[4], float b[4]) {
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f, ra[4] = {}, rb[4] = {};
+    for (int i = 0; i < count; ++i) {
+        float s = 1.0f - t[i];
+        aa += s * s;
+        ab += s * t[i];
+        bb += t[i] * t[i];
+        for (int c = 0; c < dims; ++c) {
+            ra[c] += s * points[i][c];
+            rb[c] += t[i] * points[i][c];
+        }
+    }
+    float det = aa * bb - ab * ab;
+    if (std::abs(det) < 1e-6f) return false;
+    for (int c = 0; c < dims; ++c) {
+        a[c] = (bb * ra[c] - ab * rb[c]) / det;
+        b[c] = (aa * rb[c] - ab * ra[c]) / det;
+    }
+    return true;
+}
+
+inline uint16_t packRgb565(const float c[4]) {
+    int r = std::min(std::max(static_cast<int>(c[0] * 31.0f / 255.0f + 0.5f), 0), 31);
+    int g = std::min(std::max(static_cast<int>(c[1] * 63.0f / 255.0f + 0.5f), 0), 63);
+    int b = std::min(std::max(static_cast<int>(c[2] * 31.0f / 255.0f + 0.5f), 0), 31);
+    return static_cast<uint16_t>(r << 11 | g << 5 | b);
+}
+
+inline void unpackRgb565(uint16_t c, int out[3]) {
+    int r = c >> 11 & 31, g = c >> 5 & 63, b = c & 31;
+    out[0] = r << 3 | r >> 2;
+    out[1] = g << 2 | g >> 4;
+    out[2] = b << 3 | b >> 2;
+}
+
+// Paleta de 4 cores do bloco de cor BC1/BC3 (modo de 3 cores quando c0 <= c1, só no BC1)
+inline void bc1Palette(uint16_t c0, uint16_t c1, bool allowThreeColor, int palette[4][4]) {
+    unpackRgb565(c0, palette[0]);
+    unpackRgb565(c1, palette[1]);
+    palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+    for (int c = 0; c < 3; ++c) {
+        if (c0 > c1 || !allowThreeColor) {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        } else {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+    if (c0 <= c1 && allowThreeColor) palette[3][3] = 0;
+}
+
+// Índices mais próximos para um par de extremos; devolve o erro quadrático do bloco
+inline int bc1Indices(const float (*points)[4], uint16_t c0, uint16_t c1, uint32_t& indices) {
+    int palette[4][4];
+    bc1Palette(c0, c1, false, palette);
+    int total = 0;
+    indices = 0;
+    for (int i = 0; i < 16; ++i) {
+        int best = 0, bestError = INT32_MAX;
+        for (int k = 0; k < 4; ++k) {
+            int error = 0;
+            for (int c = 0; c < 3; ++c) {
+                int d = static_cast<int>(points[i][c]) - palette[k][c];
+                error += d * d;
+            }
+            if (error < bestError) {
+                bestError = error;
+                best = k;
+            }
+        }
+        indices |= static_cast<uint32_t>(best) << (2 * i);
+        total += bestError;
+    }
+    return total;
+}
+
+// Bloco de cor BC1 de 4 cores: extremos no eixo principal, depois dois ajustes por mínimos quadrados
+inline void encodeBC1Color(const float (*points)[4], uint8_t out[8]) {
+    float mean[4], axis[4];
+    principalAxis(points, 16, 3, mean, axis);
+    float lo = 0.0f, hi = 0.0f;
+    for (int i = 0; i < 16; ++i) {
+        float d = 0.0f;
+        for (int c = 0; c < 3; ++c) d += (points[i][c] - mean[c]) * axis[c];
+        lo = std::min(lo, d);
+        hi = std::max(hi, d);
+    }
+    float e0[4], e1[4];
+    for (int c = 0; c < 3; ++c) {
+        e0[c] = mean[c] + axis[c] * hi;
+        e1[c] = mean[c] + axis[c] * lo;
+    }
+    uint16_t c0 = packRgb565(e0), c1 = packRgb565(e1);
+    uint32_t indices;
+    int error = bc1Indices(points, c0, c1, indices);
+
+    static const float weights[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+    for (int iteration = 0; iteration < 2 && error > 0; ++iteration) {
+        float t[16];
+        for (int i = 0; i < 16; ++i) t[i] = weights[indices >> (2 * i) & 3];
+        if (!fitEndpoints(points, t, 16, 3, e0, e1)) break;
+        uint16_t n0 = packRgb565(e0), n1 = packRgb565(e1);
+        uint32_t nextIndices;
+        int nextError = bc1Indices(points, n0, n1, nextIndices);
+        if (nextError >= error) break;
+        c0 = n0;
+        c1 = n1;
+        indices = nextIndices;
+        error = nextError;
+    }
+
+    // Modo de 4 cores exige c0 > c1: troca os extremos e remapeia (0 <-> 1, 2 <-> 3)
+    if (c0 < c1) {
+        std::swap(c0, c1);
+        indices ^= 0x55555555u;
+    } else if (c0 == c1) {
+        indices = 0;
+    }
+    std::memcpy(out, &c0, 2);
+    std::memcpy(out + 2, &c1, 2);
+    std::memcpy(out + 4, &indices, 4);
+}
+
+// Bloco de alfa do BC3 (8 níveis entre o mínimo e o máximo, ou 6 níveis mais 0 e 255 explícitos)
+inline void encodeBC3Alpha(const float (*points)[4], uint8_t out[8]) {
+    int alpha[16], lo = 255, hi = 0, lo6 = 255, hi6 = 0;
+    for (int i = 0; i < 16; ++i) {
+        alpha[i] = static_cast<int>(points[i][3]);
+        lo = std::min(lo, alpha[i]);
+        hi = std::max(hi, alpha[i]);
+        if (alpha[i] != 0 && alpha[i] != 255) {
+            lo6 = std::min(lo6, alpha[i]);
+            hi6 = std::max(hi6, alpha[i]);
+        }
+    }
+    if (lo6 > hi6) lo6 = hi6 = lo;
+
+    uint64_t bestBits = 0;
+    int bestError = INT32_MAX, bestA0 = hi, bestA1 = lo;
+    for (int mode = 0; mode < 2; ++mode) {
+        int a0 = mode == 0 ? hi : lo6, a1 = mode == 0 ? lo : hi6;
+        int palette[8] = { a0, a1 };
+        if (a0 > a1) {
+            for (int k = 2; k < 8; ++k) palette[k] = ((8 - k) * a0 + (k - 1) * a1) / 7;
+        } else {
+            for (int k = 2; k < 6; ++k) palette[k] = ((6 - k) * a0 + (k - 1) * a1) / 5;
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+        uint64_t bits = 0;
+        int error = 0;
+        for (int i = 0; i < 16; ++i) {
+            int best = 0, bestDistance = INT32_MAX;
+            for (int k = 0; k < 8; ++k) {
+                int d = std::abs(alpha[i] - palette[k]);
+                if (d < bestDistance) {
+                    bestDistance = d;
+                    best = k;
+                }
+            }
+            bits |= static_cast<uint64_t>(best) << (3 * i);
+            error += bestDistance * bestDistance;
+        }
+        if (error < bestError) {
+            bestError = error;
+            bestBits = bits;
+            bestA0 = a0;
+            bestA1 = a1;
+        }
+    }
+    out[0] = static_cast<uint8_t>(bestA0);
+    out[1] = static_cast<uint8_t>(bestA1);
+    for (int k = 0; k < 6; ++k) out[2 + k] = static_cast<uint8_t>(bestBits >> (8 * k));
+}
+
+// Pesos de interpolação do BC7 com índices de 4 bits
+static const int BC7_WEIGHTS4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+// Extremo de 7 bits + p-bit (8 bits efetivos) mais perto de `value`, escolhendo o p-bit compartilhado
+inline void quantizeBC7Endpoint(const float value[4], int q[4], int& pbit) {
+    float bestError = 1e30f;
+    for (int p = 0; p < 2; ++p) {
+        int candidate[4];
+        float error = 0.0f;
+        for (int c = 0; c < 4; ++c) {
+            candidate[c] = std::min(std::max(static_cast<int>(std::lround((value[c] - p) / 2.0f)), 0), 127);
+            float d = value[c] - (candidate[c] * 2 + p);
+            error += d * d;
+        }
+        if (error < bestError) {
+            bestError = error;
+            pbit = p;
+            std::copy(candidate, candidate + 4, q);
+        }
+    }
+}
+
+// Índices de 4 bits mais próximos para os extremos e0/e1 (valores de 8 bits); devolve o erro do bloco
+inline int bc7Indices(const float (*points)[4], const int e0[4], const int e1[4], int indices[16]) {
+    int palette[16][4];
+    for (int k = 0; k < 16; ++k)
+        for (int c = 0; c < 4; ++c) palette[k][c] = ((64 - BC7_WEIGHTS4[k]) * e0[c] + BC7_WEIGHTS4[k] * e1[c] + 32) >> 6;
+    int total = 0;
+    for (int i = 0; i < 16; ++i) {
+        int best = 0, bestError = INT32_MAX;
+        for (int k = 0; k < 16; ++k) {
+            int error = 0;
+            for (int c = 0; c < 4; ++c) {
+                int d = static_cast<int>(points[i][c]) - palette[k][c];
+                error += d * d;
+            }
+            if (error < bestError) {
+                bestError = error;
+                best = k;
+            }
+        }
+        indices[i] = best;
+        total += bestError;
+    }
+    return total;
+}
+
+// BC7 só no modo 6: um subconjunto, extremos RGBA 7.7.7.7 com p-bit e índices de 4 bits. Cobre bem
+// texturas de cor e alfa suaves com um codificador simples (eixo principal + mínimos quadrados).
+inline void encodeBC7Mode6(const float (*points)[4], uint8_t out[16]) {
+    float mean[4], axis[4];
+    principalAxis(points, 16, 4, mean, axis);
+    float lo = 0.0f, hi = 0.0f;
+    for (int i = 0; i < 16; ++i) {
+        float d = 0.0f;
+        for (int c = 0; c < 4; ++c) d += (points[i][c] - mean[c]) * axis[c];
+        lo = std::min(lo, d);
+        hi = std::max(hi, d);
+    }
+    float f0[4], f1[4];
+    for (int c = 0; c < 4; ++c) {
+        f0[c] = mean[c] + axis[c] * lo;
+        f1[c] = mean[c] + axis[c] * hi;
+    }
+
+    int q0[4], q1[4], p0 = 0, p1 = 0, indices[16], bestError = INT32_MAX;
+    int bestQ0[4] = {}, bestQ1[4] = {}, bestP0 = 0, bestP1 = 0, bestIndices[16] = {};
+    for (int iteration = 0; iteration < 3; ++iteration) {
+        quantizeBC7Endpoint(f0, q0, p0);
+        quantizeBC7Endpoint(f1, q1, p1);
+        int e0[4], e1[4];
+        for (int c = 0; c < 4; ++c) {
+            e0[c] = q0[c] * 2 + p0;
+            e1[c] = q1[c] * 2 + p1;
+        }
+        int error = bc7Indices(points, e0, e1, indices);
+        if (error >= bestError) break;
+        bestError = error;
+        std::copy(q0, q0 + 4, bestQ0);
+        std::copy(q1, q1 + 4, bestQ1);
+        bestP0 = p0;
+        bestP1 = p1;
+        std::copy(indices, indices + 16, bestIndices);
+        if (error == 0) break;
+        float t[16];
+        for (int i = 0; i < 16; ++i) t[i] = BC7_WEIGHTS4[indices[i]] / 64.0f;
+        if (!fitEndpoints(points, t, 16, 4, f0, f1)) break;
+    }
+
+    // O índice do pixel 0 tem só 3 bits (o bit alto é implícito 0): se passar de 7, troca os extremos
+    if (bestIndices[0] >= 8) {
+        std::swap(bestQ0, bestQ1);
+        std::swap(bestP0, bestP1);
+        for (int& index : bestIndices) index = 15 - index;
+    }
+
+    uint64_t lo64 = 0, hi64 = 0;
+    int position = 0;
+    auto put = [&](uint32_t value, int bits) {
+        for (int b = 0; b < bits; ++b, ++position) {
+            uint64_t bit = value >> b & 1u;
+            if (position < 64) lo64 |= bit << position;
+            else hi64 |= bit << (position - 64);
+        }
+    };
+    put(1u << 6, 7);   // modo 6: seis zeros e um 1
+    for (int c = 0; c < 4; ++c) {
+        put(bestQ0[c], 7);
+        put(bestQ1[c], 7);
+    }
+    put(bestP0, 1);
+    put(bestP1, 1);
+    put(bestIndices[0], 3);
+    for (int i = 1; i < 16; ++i) put(bestIndices[i], 4);
+    std::memcpy(out, &lo64, 8);
+    std::memcpy(out + 8, &hi64, 8);
+}
+
+// --- Decodificadores (para o RGBA8 de reserva e para medir a qualidade) ----------------------------
+// Escrevem os 16 pixels RGBA8 do bloco. O BC7 só aceita o modo 6, o único que o texbake grava.
+
+inline void decodeBC1Color(const uint8_t* block, bool allowThreeColor, uint8_t out[16][4]) {
+    uint16_t c0, c1;
+    uint32_t indices;
+    std::memcpy(&c0, block, 2);
+    std::memcpy(&c1, block + 2, 2);
+    std::memcpy(&indices, block + 4, 4);
+    int palette[4][4];
+    bc1Palette(c0, c1, allowThreeColor, palette);
+    for (int i = 0; i < 16; ++i)
+        for (int c = 0; c < 4; ++c) out[i][c] = static_cast<uint8_t>(palette[indices >> (2 * i) & 3][c]);
+}
+
+inline void decodeBC3Alpha(const uint8_t* block, uint8_t out[16][4]) {
+    int a0 = block[0], a1 = block[1], palette[8] = { a0, a1 };
+    if (a0 > a1) {
+        for (int k = 2; k < 8; ++k) palette[k] = ((8 - k) * a0 + (k - 1) * a1) / 7;
+    } else {
+        for (int k = 2; k < 6; ++k) palette[k] = ((6 - k) * a0 + (k - 1) * a1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+    uint64_t bits = 0;
+    for (int k = 0; k < 6; ++k) bits |= static_cast<uint64_t>(block[2 + k]) << (8 * k);
+    for (int i = 0; i < 16; ++i) out[i][3] = static_cast<uint8_t>(palette[bits >> (3 * i) & 7]);
+}
+
+inline bool decodeBC7Mode6(const uint8_t* block, uint8_t out[16][4]) {
+    uint64_t lo64, hi64;
+    std::memcpy(&lo64, block, 8);
+    std::memcpy(&hi64, block + 8, 8);
+    int position = 0;
+    auto get = [&](int bits) {
+        uint32_t value = 0;
+        for (int b = 0; b < bits; ++b, ++position) {
+            uint64_t word = position < 64 ? lo64 >> position : hi64 >> (position - 64);
+            value |= static_cast<uint32_t>(word & 1u) << b;
+        }
+        return value;
+    };
+    if (get(7) != 1u << 6) return false;
+    int e0[4], e1[4];
+    for (int c = 0; c < 4; ++c) {
+        e0[c] = static_cast<int>(get(7)) << 1;
+        e1[c] = static_cast<int>(get(7)) << 1;
+    }
+    int p0 = static_cast<int>(get(1)), p1 = static_cast<int>(get(1));
+    for (int c = 0; c < 4; ++c) {
+        e0[c] |= p0;
+        e1[c] |= p1;
+    }
+    for (int i = 0; i < 16; ++i) {
+        int w = BC7_WEIGHTS4[get(i == 0 ? 3 : 4)];
+        for (int c = 0; c < 4; ++c) out[i][c] = static_cast<uint8_t>(((64 - w) * e0[c] + w * e1[c] + 32) >> 6);
+    }
+    return true;
+}
+
+// --- Níveis inteiros -------------------------------------------------------------------------------
+
+// Comprime um nível RGBA8 em blocos 4x4; as linhas de blocos são divididas entre as threads.
+// Nas bordas de imagens que não são múltiplas de 4 o bloco repete o último pixel.
+inline std::vector<uint8_t> compressLevel(const uint8_t* rgba, uint32_t width, uint32_t height, TextureFormat format, unsigned threadCount = 0) {
+    if (format == TextureFormat::RGBA8) return std::vector<uint8_t>(rgba, rgba + static_cast<size_t>(width) * height * 4);
+    uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    size_t blockBytes = textureBlockBytes(format);
+    std::vector<uint8_t> out(static_cast<size_t>(blocksX) * blocksY * blockBytes);
+
+    auto encodeRows = [&](uint32_t firstRow, uint32_t lastRow) {
+        float points[16][4];
+        for (uint32_t by = firstRow; by < lastRow; ++by) {
+            for (uint32_t bx = 0; bx < blocksX; ++bx) {
+                for (int i = 0; i < 16; ++i) {
+                    uint32_t x = std::min(bx * 4 + i % 4, width - 1), y = std::min(by * 4 + i / 4, height - 1);
+                    const uint8_t* p = rgba + (static_cast<size_t>(y) * width + x) * 4;
+                    for (int c = 0; c < 4; ++c) points[i][c] = p[c];
+                }
+                uint8_t* block = out.data() + (static_cast<size_t>(by) * blocksX + bx) * blockBytes;
+                if (format == TextureFormat::BC1) {
+                    encodeBC1Color(points, block);
+                } else if (format == TextureFormat::BC3) {
+                    encodeBC3Alpha(points, block);
+                    encodeBC1Color(points, block + 8);
+                } else {
+                    encodeBC7Mode6(points, block);
+                }
+            }
+        }
+    };
+
+    unsigned threads = threadCount ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+    threads = std::max(1u, std::min<unsigned>(threads, blocksY / 8));
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t)
+        workers.emplace_back(encodeRows, blocksY * t / threads, blocksY * (t + 1) / threads);
+    encodeRows(0, blocksY / threads);
+    for (auto& worker : workers) worker.join();
+    return out;
+}
+
+// Descomprime um nível para RGBA8; false em BC7 de modo diferente do 6
+inline bool decompressLevel(const TextureLevelView& level, TextureFormat format, std::vector<uint8_t>& rgba) {
+    rgba.resize(static_cast<size_t>(level.width) * level.height * 4);
+    if (format == TextureFormat::RGBA8) {
+        std::memcpy(rgba.data(), level.data, rgba.size());
+        return true;
+    }
+    uint32_t blocksX = (level.width + 3) / 4, blocksY = (level.height + 3) / 4;
+    size_t blockBytes = textureBlockBytes(format);
+    uint8_t pixels[16][4];
+    for (uint32_t by = 0; by < blocksY; ++by) {
+        for (uint32_t bx = 0; bx < blocksX; ++bx) {
+            const uint8_t* block = level.data + (static_cast<size_t>(by) * blocksX + bx) * blockBytes;
+            if (format == TextureFormat::BC1) {
+                decodeBC1Color(block, true, pixels);
+            } else if (format == TextureFormat::BC3) {
+                decodeBC1Color(block + 8, false, pixels);
+                decodeBC3Alpha(block, pixels);
+            } else if (!decodeBC7Mode6(block, pixels)) {
+                return false;
+            }
+            for (int i = 0; i < 16; ++i) {
+                uint32_t x = bx * 4 + i % 4, y = by * 4 + i / 4;
+                if (x < level.width && y < level.height) std::memcpy(&rgba[(static_cast<size_t>(y) * level.width + x) * 4], pixels[i], 4);
+            }
+        }
+    }
+    return true;
+}
+
+// Cadeia completa de mipmaps comprimida a partir da imagem RGBA8 (flipped: linhas de baixo para cima)
+inline BakedTexture bakeTexture(const unsigned char* rgba, uint32_t width, uint32_t height, TextureFormat format, bool flipped,
+                                unsigned threadCount = 0) {
+    BakedTexture baked;
+    baked.format = format;
+    baked.flipped = flipped;
+    baked.width = width;
+    baked.height = height;
+    std::vector<uint8_t> current;
+    const uint8_t* level = rgba;
+    for (;;) {
+        baked.levels.push_back(compressLevel(level, width, height, format, threadCount));
+        if (width == 1 && height == 1) break;
+        current = downsampleRgba(level, width, height);
+        level = current.data();
+        width = std::max(width / 2, 1u);
+        height = std::max(height / 2, 1u);
+    }
+    return baked;
+}
+
+// --- Contêiner KTX2 --------------------------------------------------------------------------------
+
+const uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+const char KTX2_SOURCE_KEY[] = "texbake.source";
+
+struct Ktx2Header {
+    uint8_t identifier[12];
+    uint32_t vkFormat;
+    uint32_t typeSize;
+    uint32_t pixelWidth, pixelHeight, pixelDepth;
+    uint32_t layerCount, faceCount, levelCount;
+    uint32_t supercompressionScheme;
+    uint32_t dfdByteOffset, dfdByteLength;
+    uint32_t kvdByteOffset, kvdByteLength;
+    uint64_t sgdByteOffset, sgdByteLength;
+};
+
+struct Ktx2LevelIndex {
+    uint64_t byteOffset, byteLength, uncompressedByteLength;
+};
+
+// VkFormat de cada formato (R8G8B8A8_UNORM, BC1_RGBA_UNORM_BLOCK, BC3_UNORM_BLOCK, BC7_UNORM_BLOCK)
+inline uint32_t textureVkFormat(TextureFormat format) {
+    switch (format) {
+    case TextureFormat::BC1: return 133;
+    case TextureFormat::BC3: return 137;
+    case TextureFormat::BC7: return 145;
+    default: return 37;
+    }
+}
+
+inline bool textureFormatFromVk(uint32_t vkFormat, TextureFormat& format) {
+    switch (vkFormat) {
+    case 37: format = TextureFormat::RGBA8; return true;
+    case 133: format = TextureFormat::BC1; return true;
+    case 137: format = TextureFormat::BC3; return true;
+    case 145: format = TextureFormat::BC7; return true;
+    default: return false;
+    }
+}
+
+// Data Format Descriptor básico (Khronos Data Format 1.3): modelo de cor, tamanho do bloco e amostras
+inline std::vector<uint32_t> ktx2Descriptor(TextureFormat format) {
+    struct Sample {
+        uint32_t bitOffset, bitLength, channel, upper;
+    };
+    std::vector<Sample> samples;
+    uint32_t model, blockDim, bytesPlane0;
+    switch (format) {
+    case TextureFormat::BC1:   // KHR_DF_MODEL_BC1A, canal "alpha present"
+        model = 128;
+        blockDim = 0x0303;
+        bytesPlane0 = 8;
+        samples = { { 0, 63, 1, 0xFFFFFFFFu } };
+        break;
+    case TextureFormat::BC3:   // KHR_DF_MODEL_BC3: alfa nos 64 bits baixos, cor nos altos
+        model = 130;
+        blockDim = 0x0303;
+        bytesPlane0 = 16;
+        samples = { { 0, 63, 15, 0xFFFFFFFFu }, { 64, 63, 0, 0xFFFFFFFFu } };
+        break;
+    case TextureFormat::BC7:   // KHR_DF_MODEL_BC7
+        model = 134;
+        blockDim = 0x0303;
+        bytesPlane0 = 16;
+        samples = { { 0, 127, 0, 0xFFFFFFFFu } };
+        break;
+    default:                   // KHR_DF_MODEL_RGBSDA, R G B A de 8 bits
+        model = 1;
+        blockDim = 0;
+        bytesPlane0 = 4;
+        samples = { { 0, 7, 0, 255 }, { 8, 7, 1, 255 }, { 16, 7, 2, 255 }, { 24, 7, 15, 255 } };
+        break;
+    }
+    uint32_t blockSize = 24 + 16 * static_cast<uint32_t>(samples.size());
+    std::vector<uint32_t> words = { 4 + blockSize, 0, 2u | blockSize << 16,
+                                    model | 1u << 8 | 1u << 16,   // primárias BT.709, transferência linear
+                                    blockDim, bytesPlane0, 0 };
+    for (const Sample& s : samples) {
+        words.push_back(s.bitOffset | s.bitLength << 16 | s.channel << 24);
+        words.push_back(0);
+        words.push_back(0);
+        words.push_back(s.upper);
+    }
+    return words;
+}
+
+inline void appendKtx2KeyValue(std::vector<uint8_t>& kvd, const std::string& key, const void* value, size_t size) {
+    uint32_t length = static_cast<uint32_t>(key.size() + 1 + size);
+    const uint8_t* lengthBytes = reinterpret_cast<const uint8_t*>(&length);
+    kvd.insert(kvd.end(), lengthBytes, lengthBytes + 4);
+    kvd.insert(kvd.end(), key.begin(), key.end());
+    kvd.push_back(0);
+    kvd.insert(kvd.end(), static_cast<const uint8_t*>(value), static_cast<const uint8_t*>(value) + size);
+    while (kvd.size() % 4) kvd.push_back(0);
+}
+
+// Caminho do cache correspondente a uma imagem (ao lado do arquivo original)
+inline std::string bakedTexturePath(const std::string& imagePath) {
+    return std::filesystem::path(imagePath).replace_extension(".ktx2").string();
+}
+
+// Grava o .ktx2 (via arquivo temporário, como o .meshbin); sourcePath identifica a imagem de origem
+inline bool writeKtx2(const std::string& path, const std::string& sourcePath, const BakedTexture& texture) {
+    SourceStamp stamp = {};
+    if (!statSource(sourcePath, stamp) || !hashSource(sourcePath, stamp)) return false;
+
+    std::vector<uint32_t> dfd = ktx2Descriptor(texture.format);
+    std::vector<uint8_t> kvd;
+    appendKtx2KeyValue(kvd, "KTXorientation", texture.flipped ? "ru" : "rd", 3);
+    appendKtx2KeyValue(kvd, "KTXwriter", "texbake", 8);
+    appendKtx2KeyValue(kvd, KTX2_SOURCE_KEY, &stamp, sizeof(stamp));
+
+    Ktx2Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER));
+    header.vkFormat = textureVkFormat(texture.format);
+    header.typeSize = 1;
+    header.pixelWidth = texture.width;
+    header.pixelHeight = texture.height;
+    header.faceCount = 1;
+    header.levelCount = static_cast<uint32_t>(texture.levels.size());
+    header.dfdByteOffset = static_cast<uint32_t>(sizeof(Ktx2Header) + sizeof(Ktx2LevelIndex) * texture.levels.size());
+    header.dfdByteLength = static_cast<uint32_t>(dfd.size() * 4);
+    header.kvdByteOffset = header.dfdByteOffset + header.dfdByteLength;
+    header.kvdByteLength = static_cast<uint32_t>(kvd.size());
+
+    // Níveis do menor para o maior, cada um alinhado ao bloco (8 ou 16 bytes; 4 no RGBA8)
+    uint64_t alignment = std::max<uint64_t>(textureBlockBytes(texture.format), 4);
+    std::vector<Ktx2LevelIndex> index(texture.levels.size());
+    uint64_t offset = header.kvdByteOffset + header.kvdByteLength;
+    for (size_t i = texture.levels.size(); i-- > 0;) {
+        offset = (offset + alignment - 1) / alignment * alignment;
+        index[i] = { offset, texture.levels[i].size(), texture.levels[i].size() };
+        offset += texture.levels[i].size();
+    }
+
+    std::string tmpPath = path + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return false;
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        out.write(reinterpret_cast<const char*>(index.data()), sizeof(Ktx2LevelIndex) * index.size());
+        out.write(reinterpret_cast<const char*>(dfd.data()), dfd.size() * 4);
+        out.write(reinterpret_cast<const char*>(kvd.data()), kvd.size());
+        uint64_t written = header.kvdByteOffset + header.kvdByteLength;
+        const char padding[16] = {};
+        for (size_t i = texture.levels.size(); i-- > 0;) {
+            out.write(padding, static_cast<std::streamsize>(index[i].byteOffset - written));
+            out.write(reinterpret_cast<const char*>(texture.levels[i].data()), texture.levels[i].size());
+            written = index[i].byteOffset + index[i].byteLength;
+        }
+        if (!out.good()) return false;
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        return false;
+    }
+    return true;
+}
+
+// .ktx2 mapeado em memória, somente leitura
+class Ktx2File {
+public:
+    // Abre e valida o arquivo; com sourcePath, também confere se foi gerado a partir da versão atual da
+    // imagem e com a mesma orientação (flipped). false se ausente, corrompido, desatualizado ou em um
+    // formato que não é dos quatro acima.
+    bool open(const std::string& path, const std::string& sourcePath = "", bool flipped = false) {
+        if (!file.open(path)) return false;
+        if (!parse(sourcePath, flipped)) {
+            file.close();
+            return false;
+        }
+        return true;
+    }
+
+    bool isOpen() const { return file.isOpen(); }
+    const TextureView& view() const { return textureView; }
+    TextureFormat format() const { return textureView.format; }
+    uint32_t width() const { return textureView.levels.empty() ? 0 : textureView.levels[0].width; }
+    uint32_t height() const { return textureView.levels.empty() ? 0 : textureView.levels[0].height; }
+
+private:
+    bool parse(const std::string& sourcePath, bool flipped) {
+        const uint8_t* data = file.data();
+        size_t size = file.size();
+        Ktx2Header header;
+        if (size < sizeof(header)) return false;
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.identifier, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) != 0) return false;
+        if (header.supercompressionScheme != 0 || header.pixelDepth != 0 || header.layerCount != 0 || header.faceCount != 1) return false;
+        if (header.pixelWidth == 0 || header.pixelHeight == 0 || header.levelCount == 0 || header.levelCount > 32) return false;
+        if (!textureFormatFromVk(header.vkFormat, textureView.format)) return false;
+        if (sizeof(header) + sizeof(Ktx2LevelIndex) * header.levelCount > size) return false;
+        if (static_cast<uint64_t>(header.kvdByteOffset) + header.kvdByteLength > size) return false;
+
+        textureView.levels.clear();
+        uint32_t w = header.pixelWidth, h = header.pixelHeight;
+        for (uint32_t i = 0; i < header.levelCount; ++i) {
+            Ktx2LevelIndex level;
+            std::memcpy(&level, data + sizeof(header) + sizeof(level) * i, sizeof(level));
+            if (level.byteOffset > size || level.byteLength > size - level.byteOffset) return false;
+            if (level.byteLength != textureLevelBytes(textureView.format, w, h)) return false;
+            textureView.levels.push_back({ w, h, data + level.byteOffset, static_cast<size_t>(level.byteLength) });
+            w = std::max(w / 2, 1u);
+            h = std::max(h / 2, 1u);
+        }
+
+        if (sourcePath.empty()) return true;
+        std::string orientation;
+        SourceStamp stamp = {};
+        bool hasStamp = false;
+        const uint8_t* kvd = data + header.kvdByteOffset;
+        for (size_t offset = 0; offset + 4 <= header.kvdByteLength;) {
+            uint32_t length;
+            std::memcpy(&length, kvd + offset, 4);
+            if (length > header.kvdByteLength - offset - 4) return false;
+            const char* entry = reinterpret_cast<const char*>(kvd + offset + 4);
+            size_t keyLength = strnlen(entry, length);
+            std::string key(entry, keyLength);
+            const char* value = entry + keyLength + 1;
+            size_t valueLength = keyLength < length ? length - keyLength - 1 : 0;
+            if (key == "KTXorientation") orientation.assign(value, strnlen(value, valueLength));
+            if (key == KTX2_SOURCE_KEY && valueLength == sizeof(stamp)) {
+                std::memcpy(&stamp, value, sizeof(stamp));
+                hasStamp = true;
+            }
+            offset += (4 + length + 3) / 4 * 4;
+        }
+        if (orientation != (flipped ? "ru" : "rd")) return false;
+        return hasStamp && sourceMatches(sourcePath, stamp);
+    }
+
+    MappedFile file;
+    TextureView textureView;
+};
+
+// Textura pronta para o upload: o .ktx2 mapeado ou, se ele não pôde ser gravado, o bake em memória
+struct TextureAsset {
+    Ktx2File file;
+    BakedTexture baked;
+    TextureView view;
+    bool fromCache = false;
+
+    uint32_t width() const { return view.levels.empty() ? 0 : view.levels[0].width; }
+    uint32_t height() const { return view.levels.empty() ? 0 : view.levels[0].height; }
+};
+
+// Abre o .ktx2 ao lado da imagem se ele estiver em dia; senão decodifica a imagem com a stb_image,
+// comprime a cadeia de mipmaps (BC1 ou BC3, conforme o alfa) e grava o cache para as próximas execuções.
+// flipped deve refletir o stbi_set_flip_vertically_on_load que quem chama configurou.
+inline bool loadTextureAsset(const std::string& imagePath, bool flipped, TextureAsset& asset) {
+    std::string cachePath = bakedTexturePath(imagePath);
+    if (asset.file.open(cachePath, imagePath, flipped)) {
+        asset.view = asset.file.view();
+        asset.fromCache = true;
+        return true;
+    }
+
+    int width, height, channels;
+    unsigned char* pixels = stbi_load(imagePath.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+    if (!pixels) return false;
+    TextureFormat format = chooseTextureFormat(pixels, static_cast<size_t>(width) * height);
+    asset.baked = bakeTexture(pixels, static_cast<uint32_t>(width), static_cast<uint32_t>(height), format, flipped);
+    stbi_image_free(pixels);
+
+    // Relido do arquivo para liberar a cópia em memória; sem permissão de escrita, usa a cópia mesmo
+    if (writeKtx2(cachePath, imagePath, asset.baked) && asset.file.open(cachePath, imagePath, flipped)) {
+        asset.baked = BakedTexture();
+        asset.view = asset.file.view();
+    } else {
+        asset.view = asset.baked.view();
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef TEXTURE_CACHE_H
+#define TEXTURE_CACHE_H
+
+// Cache de texturas da GPU indexado pelo caminho do arquivo: cada imagem é enviada uma única vez,
+// e os modelos que a compartilham recebem o mesmo handle (com contagem de referências).
+// Deve ser usado apenas na thread que possui o contexto OpenGL.
+
+#include <glad/glad.h>
+
+#include "texturebake.h"
+#include "texturestream.h"
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Envia uma cadeia de mipmaps pronta (sem glGenerateMipmap) para a textura ligada em GL_TEXTURE_2D.
+// Se o driver não aceita o formato comprimido, descomprime na CPU e envia RGBA8. Devolve os bytes na GPU.
+inline size_t uploadTextureLevels(const TextureView& view) {
+    GLenum internalFormat = textureInternalFormat(view.format);
+    bool compressed = internalFormat != GL_RGBA8;
+    size_t bytes = 0;
+    std::vector<uint8_t> rgba;
+    for (size_t i = 0; i < view.levels.size(); ++i) {
+        const TextureLevelView& level = view.levels[i];
+        GLint index = static_cast<GLint>(i);
+        if (compressed) {
+            glCompressedTexImage2D(GL_TEXTURE_2D, index, internalFormat, level.width, level.height, 0, static_cast<GLsizei>(level.size), level.data);
+            bytes += level.size;
+        } else if (decompressLevel(level, view.format, rgba)) {
+            glTexImage2D(GL_TEXTURE_2D, index, GL_RGBA8, level.width, level.height, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba.data());
+            bytes += rgba.size();
+        }
+    }
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(view.levels.size()) - 1);
+    return bytes;
+}
+
+// Textura de um TextureAsset (.ktx2 ou bake recém-feito) com os mesmos parâmetros do TextureCache
+inline GLuint createTexture(const TextureView& view, size_t* bytes = nullptr) {
+    GLuint handle;
+    glGenTextures(1, &handle);
+    glBindTexture(GL_TEXTURE_2D, handle);
+    size_t uploaded = uploadTextureLevels(view);
+    if (bytes) *bytes = uploaded;
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    return handle;
+}
+
+class TextureCache {
+public:
+    // Handle da textura; se ainda não está na GPU, envia a textura pré-processada (.ktx2 ou o bake em
+    // memória quando o .ktx2 não pôde ser gravado) com os níveis comprimidos como estão. Sem textura
+    // (arquivo ausente ou inválido) devolve a textura branca padrão.
+    // Com um streamer (setStreamer), só a cauda de mipmaps vai agora e o resto chega nos próximos frames;
+    // o streamer fica com o TextureAsset até lá.
+    GLuint acquire(const std::string& path, std::unique_ptr<TextureAsset> texture) {
+        auto it = byPath.find(path);
+        if (it != byPath.end()) {
+            ++it->second.refCount;
+            ++hitCount;
+            return it->second.handle;
+        }
+        ++missCount;
+        if (!texture || texture->view.levels.empty()) return fallback();
+
+        Entry entry;
+        if (streamer && streamer->available())
+            entry.handle = streamer->add(std::move(texture), &entry.bytes);
+        else
+            entry.handle = createTexture(texture->view, &entry.bytes);
+        entry.refCount = 1;
+        residentBytes += entry.bytes;
+        byPath.emplace(path, entry);
+        pathOf.emplace(entry.handle, path);
+        return entry.handle;
+    }
+
+    // Libera uma referência; a textura sai da GPU quando ninguém mais a usa
+    void release(GLuint handle) {
+        if (handle == 0 || handle == fallbackHandle) return;
+        auto p = pathOf.find(handle);
+        if (p == pathOf.end()) return;
+        auto it = byPath.find(p->second);
+        if (--it->second.refCount == 0) {
+            if (streamer) streamer->cancel(handle);
+            glDeleteTextures(1, &handle);
+            residentBytes -= it->second.bytes;
+            byPath.erase(it);
+            pathOf.erase(p);
+        }
+    }
+
+    // Textura 1x1 branca para modelos sem textura difusa (o material define a cor)
+    GLuint fallback() {
+        if (fallbackHandle == 0) {
+            const unsigned char white[4] = { 255, 255, 255, 255 };
+            glGenTextures(1, &fallbackHandle);
+            glBindTexture(GL_TEXTURE_2D, fallbackHandle);
+            glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+            residentBytes += 4;
+        }
+        return fallbackHandle;
+    }
+
+    // Streaming progressivo dos próximos acquire de .ktx2 (nulo: envio completo na hora)
+    void setStreamer(TextureStreamer* textureStreamer) { streamer = textureStreamer; }
+
+    size_t hits() const { return hitCount; }
+    size_t misses() const { return missCount; }
+    size_t bytesResident() const { return residentBytes; }
+    size_t textureCount() const { return byPath.size() + (fallbackHandle ? 1 : 0); }
+
+private:
+    struct Entry {
+        GLuint handle = 0;
+        size_t bytes = 0;
+        int refCount = 0;
+    };
+
+    std::unordered_map<std::string, Entry> byPath;
+    std::unordered_map<GLuint, std::string> pathOf;
+    GLuint fallbackHandle = 0;
+    TextureStreamer* streamer = nullptr;
+    size_t hitCount = 0, missCount = 0;
+    size_t residentBytes = 0;
+};
+
+#endif
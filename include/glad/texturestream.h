@@ -0,0 +1,366 @@
+#ifndef TEXTURE_STREAM_H
+#define TEXTURE_STREAM_H
+
+// Streaming progressivo de texturas (.ktx2 com mipmaps prontos): na criação só a cauda da cadeia
+// (níveis de até 64x64) vai para a GPU e a textura já pode ser usada; os níveis maiores chegam ao longo
+// dos frames seguintes, do mais grosso para o mais fino, em faixas de linhas de blocos copiadas para um
+// anel de PBOs. Cada fatia do anel só é reaproveitada depois que a fence da GPU confirma que o envio
+// anterior terminou, então a thread do OpenGL nunca espera pelo driver.
+//
+// A cada nível completo o GL_TEXTURE_BASE_LEVEL desce um degrau. Entre as texturas pendentes vai primeiro
+// a que tem o maior déficit: tamanho na tela (request) dividido pela resolução já residente.
+//
+// glTexStorage2D e glBufferStorage (mapeamento persistente) são do OpenGL 4.2/4.4, além do que o glad do
+// projeto carrega: as funções são buscadas em init e, sem suporte, available() é false e quem chama
+// envia a cadeia inteira de uma vez.
+
+#include <glad/glad.h>
+
+#include "texturebake.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Formatos comprimidos (EXT_texture_compression_s3tc e ARB_texture_compression_bptc); o glad.h do
+// projeto só traz o núcleo do OpenGL
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_BPTC_UNORM
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
+#endif
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+typedef void (APIENTRYP PFNGLTEXSTORAGE2DPROC_TS)(GLenum target, GLsizei levels, GLenum internalformat, GLsizei width, GLsizei height);
+typedef void (APIENTRYP PFNGLBUFFERSTORAGEPROC_TS)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+// O driver aceita o formato? BC1/BC3 pedem S3TC e BC7 pede BPTC (consultado uma vez por processo)
+inline bool textureFormatSupported(TextureFormat format) {
+    static int s3tc = -1, bptc = -1;
+    if (s3tc < 0) {
+        s3tc = bptc = 0;
+        GLint count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+        for (GLint i = 0; i < count; ++i) {
+            const char* name = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i));
+            if (!name) continue;
+            if (std::strcmp(name, "GL_EXT_texture_compression_s3tc") == 0) s3tc = 1;
+            if (std::strcmp(name, "GL_ARB_texture_compression_bptc") == 0) bptc = 1;
+        }
+    }
+    if (format == TextureFormat::BC1 || format == TextureFormat::BC3) return s3tc == 1;
+    if (format == TextureFormat::BC7) return bptc == 1;
+    return true;
+}
+
+// Formato interno na GPU: o comprimido quando o driver aceita, senão RGBA8 (descomprimido na CPU)
+inline GLenum textureInternalFormat(TextureFormat format) {
+    if (format == TextureFormat::RGBA8 || !textureFormatSupported(format)) return GL_RGBA8;
+    return format == TextureFormat::BC1 ? GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+         : format == TextureFormat::BC3 ? GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+         : GL_COMPRESSED_RGBA_BPTC_UNORM;
+}
+
+struct TextureStreamStats {
+    size_t added = 0, completed = 0;
+    size_t tailBytes = 0;        // cauda enviada na criação, sem PBO
+    size_t streamedBytes = 0;    // níveis enviados pelo anel
+    size_t chunks = 0;           // faixas de linhas de blocos
+    size_t busyFrames = 0;       // frames com trabalho pendente e o anel inteiro ainda em uso pela GPU
+};
+
+class TextureStreamer {
+public:
+    static const size_t DEFAULT_SLOT_BYTES = 2u << 20;
+    static const int DEFAULT_SLOT_COUNT = 4;
+    static const size_t DEFAULT_FRAME_BUDGET = 4u << 20;   // bytes enviados por frame
+    static const uint32_t TAIL_SIZE = 64;                   // níveis até 64x64 vão junto com a criação
+
+    TextureStreamer() = default;
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    // Busca as funções do OpenGL 4.4 e cria o anel de PBOs mapeado de forma persistente
+    bool init(GLADloadproc load, size_t slotBytes = DEFAULT_SLOT_BYTES, int slotCount = DEFAULT_SLOT_COUNT,
+              size_t frameBudget = DEFAULT_FRAME_BUDGET) {
+        texStorage2D = (PFNGLTEXSTORAGE2DPROC_TS)load("glTexStorage2D");
+        bufferStorage = (PFNGLBUFFERSTORAGEPROC_TS)load("glBufferStorage");
+        GLint major = 0, minor = 0;
+        glGetIntegerv(GL_MAJOR_VERSION, &major);
+        glGetIntegerv(GL_MINOR_VERSION, &minor);
+        if (!texStorage2D || !bufferStorage || major < 4 || (major == 4 && minor < 4)) return false;
+
+        slotSize = slotBytes;
+        budget = frameBudget;
+        slots.assign(std::max(slotCount, 1), Slot());
+        GLsizeiptr ringBytes = static_cast<GLsizeiptr>(slotSize * slots.size());
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        glGenBuffers(1, &pbo);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+        bufferStorage(GL_PIXEL_UNPACK_BUFFER, ringBytes, nullptr, flags);
+        mapped = static_cast<uint8_t*>(glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, ringBytes, flags));
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (!mapped) {
+            release();
+            return false;
+        }
+        return true;
+    }
+
+    bool available() const { return mapped != nullptr; }
+
+    // Cria a textura com a cadeia inteira alocada e só a cauda preenchida; o resto entra na fila.
+    // bytes recebe o tamanho final na GPU (com todos os níveis).
+    GLuint add(std::unique_ptr<TextureAsset> texture, size_t* bytes = nullptr) {
+        const TextureView& view = texture->view;
+        Job job;
+        job.format = view.format;
+        job.internalFormat = textureInternalFormat(view.format);
+        job.decompress = job.internalFormat == GL_RGBA8 && view.format != TextureFormat::RGBA8;
+        job.order = counters.added++;
+
+        int levelCount = static_cast<int>(view.levels.size());
+        glGenTextures(1, &job.handle);
+        glBindTexture(GL_TEXTURE_2D, job.handle);
+        texStorage2D(GL_TEXTURE_2D, levelCount, job.internalFormat, view.levels[0].width, view.levels[0].height);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, levelCount - 1);
+
+        if (bytes) {
+            *bytes = 0;
+            for (const TextureLevelView& level : view.levels)
+                *bytes += gpuLevelBytes(job, level.width, level.height);
+        }
+
+        // Cauda: poucos KB, enviados direto da memória mapeada. Se uma linha de blocos do nível 0 não cabe
+        // numa fatia do anel (largura acima de ~32 mil pixels), a cadeia inteira vai agora.
+        bool streamable = gpuLevelBytes(job, view.levels[0].width, 4) <= slotSize;
+        job.residentLevel = levelCount;
+        for (int level = levelCount - 1; level >= 0; --level) {
+            const TextureLevelView& lv = view.levels[level];
+            if (streamable && level < levelCount - 1 && std::max(lv.width, lv.height) > TAIL_SIZE) break;
+            const void* data = lv.data;
+            if (job.decompress) {
+                decompressLevel(lv, view.format, scratch);
+                data = scratch.data();
+            }
+            subImage(job, level, 0, lv.width, lv.height, data, gpuLevelBytes(job, lv.width, lv.height));
+            counters.tailBytes += gpuLevelBytes(job, lv.width, lv.height);
+            job.residentLevel = level;
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, job.residentLevel);
+
+        GLuint handle = job.handle;
+        if (job.residentLevel == 0) {
+            ++counters.completed;
+        } else {
+            job.texture = std::move(texture);
+            jobs.emplace(handle, std::move(job));
+        }
+        return handle;
+    }
+
+    // Tamanho da textura na tela neste frame (pixels do maior objeto que a usa); vale até o próximo update
+    void request(GLuint texture, float screenPixels) {
+        auto it = jobs.find(texture);
+        if (it != jobs.end()) it->second.screenPixels = std::max(it->second.screenPixels, screenPixels);
+    }
+
+    // Uma vez por frame: libera as fatias do anel já consumidas pela GPU e envia até o orçamento do frame.
+    // waitForSlots espera as fences em vez de adiar o envio (modo sem janela: frames reprodutíveis).
+    void update(bool waitForSlots = false) {
+        improvedTextures.clear();
+        if (!mapped || jobs.empty()) return;
+
+        // Maior déficit primeiro: tamanho na tela sobre a resolução residente; empate pela ordem de criação
+        queue.clear();
+        for (auto& entry : jobs) queue.push_back(&entry.second);
+        std::sort(queue.begin(), queue.end(), [](const Job* a, const Job* b) {
+            float da = a->screenPixels / a->residentSize(), db = b->screenPixels / b->residentSize();
+            return da != db ? da > db : a->order < b->order;
+        });
+
+        size_t sent = 0, offset = 0;
+        int slot = -1;
+        bool ringFull = false;
+        usedSlots = 0;
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+        for (Job* job : queue) {
+            while (job->residentLevel > 0 && sent < budget) {
+                const TextureView& view = job->texture->view;
+                int level = job->residentLevel - 1;
+                const TextureLevelView& lv = view.levels[level];
+                uint32_t blockRows = (lv.height + 3) / 4;
+                size_t rowBytes = gpuLevelBytes(*job, lv.width, 4);
+                size_t sourceRowBytes = textureLevelBytes(view.format, lv.width, 4);
+
+                // Fatia nova quando nem uma linha de blocos cabe no que sobrou da atual
+                if (slot < 0 || offset + rowBytes > slotSize) {
+                    if (slot >= 0) closeSlot(slot);
+                    slot = acquireSlot(waitForSlots);
+                    offset = 0;
+                    if (slot < 0) {
+                        ringFull = true;
+                        break;
+                    }
+                }
+                uint32_t rows = static_cast<uint32_t>(std::min<size_t>(blockRows - job->nextRow, (slotSize - offset) / rowBytes));
+                uint32_t y = job->nextRow * 4;
+                uint32_t height = std::min(rows * 4, lv.height - y);
+                TextureLevelView strip = { lv.width, height, lv.data + job->nextRow * sourceRowBytes, textureLevelBytes(view.format, lv.width, height) };
+                size_t size = gpuLevelBytes(*job, lv.width, height);
+                uint8_t* dst = mapped + slot * slotSize + offset;
+                if (job->decompress) {
+                    decompressLevel(strip, view.format, scratch);
+                    std::memcpy(dst, scratch.data(), size);
+                } else {
+                    std::memcpy(dst, strip.data, size);
+                }
+                glBindTexture(GL_TEXTURE_2D, job->handle);
+                subImage(*job, level, y, lv.width, height, reinterpret_cast<const void*>(slot * slotSize + offset), size);
+                offset = (offset + size + 15) & ~static_cast<size_t>(15);
+                sent += size;
+                counters.streamedBytes += size;
+                ++counters.chunks;
+
+                job->nextRow += rows;
+                if (job->nextRow == blockRows) {
+                    // Nível completo: na ordem de comandos do OpenGL o envio acima vem antes de qualquer desenho
+                    job->residentLevel = level;
+                    job->nextRow = 0;
+                    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level);
+                    if (improvedTextures.empty() || improvedTextures.back() != job->handle)
+                        improvedTextures.push_back(job->handle);
+                }
+            }
+            if (ringFull || sent >= budget) break;
+        }
+        if (slot >= 0) closeSlot(slot);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        if (ringFull) ++counters.busyFrames;
+
+        for (Job* job : queue) {
+            job->screenPixels = 0.0f;
+            if (job->residentLevel == 0) {
+                GLuint handle = job->handle;
+                ++counters.completed;
+                jobs.erase(handle);
+            }
+        }
+    }
+
+    // A textura vai ser apagada por quem a criou: sai da fila
+    void cancel(GLuint texture) { jobs.erase(texture); }
+
+    // Texturas que ganharam pelo menos um nível no último update
+    const std::vector<GLuint>& improved() const { return improvedTextures; }
+
+    bool idle() const { return jobs.empty(); }
+    size_t pendingCount() const { return jobs.size(); }
+    const TextureStreamStats& stats() const { return counters; }
+
+    // Libera o anel; as texturas pertencem a quem chamou add. Chamar antes de destruir o contexto OpenGL
+    void release() {
+        for (Slot& slot : slots) {
+            if (slot.fence) glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+        if (pbo) {
+            if (mapped) {
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+                glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+                glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            }
+            glDeleteBuffers(1, &pbo);
+        }
+        pbo = 0;
+        mapped = nullptr;
+        jobs.clear();
+    }
+
+private:
+    struct Job {
+        GLuint handle = 0;
+        std::unique_ptr<TextureAsset> texture;   // mantém o .ktx2 mapeado até o último nível
+        TextureFormat format = TextureFormat::RGBA8;
+        GLenum internalFormat = GL_RGBA8;
+        bool decompress = false;                 // formato sem suporte no driver: RGBA8 descomprimido na CPU
+        int residentLevel = 0;                   // nível mais fino já completo (GL_TEXTURE_BASE_LEVEL)
+        uint32_t nextRow = 0;                    // próxima linha de blocos do nível residentLevel - 1
+        float screenPixels = 0.0f;
+        size_t order = 0;
+
+        float residentSize() const {
+            const TextureLevelView& lv = texture->view.levels[residentLevel];
+            return static_cast<float>(std::max(lv.width, lv.height));
+        }
+    };
+
+    struct Slot {
+        GLsync fence = nullptr;   // nulo: livre
+    };
+
+    // Bytes do nível na GPU (RGBA8 quando o driver não aceita o formato comprimido)
+    static size_t gpuLevelBytes(const Job& job, uint32_t width, uint32_t height) {
+        if (job.internalFormat == GL_RGBA8) return static_cast<size_t>(width) * height * 4;
+        return textureLevelBytes(job.format, width, height);
+    }
+
+    // Faixa de linhas [y, y + height) do nível, da memória do processo ou do PBO ligado (data = deslocamento)
+    static void subImage(const Job& job, int level, uint32_t y, uint32_t width, uint32_t height, const void* data, size_t size) {
+        if (job.internalFormat == GL_RGBA8)
+            glTexSubImage2D(GL_TEXTURE_2D, level, 0, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, data);
+        else
+            glCompressedTexSubImage2D(GL_TEXTURE_2D, level, 0, y, width, height, job.internalFormat, static_cast<GLsizei>(size), data);
+    }
+
+    // Próxima fatia do anel, em ordem circular; -1 se a GPU ainda lê dela ou se o frame já usou todas
+    int acquireSlot(bool wait) {
+        if (usedSlots == slots.size()) return -1;
+        Slot& slot = slots[cursor];
+        if (slot.fence) {
+            GLenum status = glClientWaitSync(slot.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? 1000000000ull : 0);
+            if (status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED) return -1;
+            glDeleteSync(slot.fence);
+            slot.fence = nullptr;
+        }
+        return static_cast<int>(cursor);
+    }
+
+    void closeSlot(int index) {
+        slots[index].fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        cursor = (cursor + 1) % slots.size();
+        ++usedSlots;
+    }
+
+    PFNGLTEXSTORAGE2DPROC_TS texStorage2D = nullptr;
+    PFNGLBUFFERSTORAGEPROC_TS bufferStorage = nullptr;
+    GLuint pbo = 0;
+    uint8_t* mapped = nullptr;
+    size_t slotSize = DEFAULT_SLOT_BYTES;
+    size_t budget = DEFAULT_FRAME_BUDGET;
+    std::vector<Slot> slots;
+    size_t cursor = 0, usedSlots = 0;
+
+    std::unordered_map<GLuint, Job> jobs;
+    std::vector<Job*> queue;
+    std::vector<GLuint> improvedTextures;
+    std::vector<uint8_t> scratch;
+    TextureStreamStats counters;
+};
+
+#endif
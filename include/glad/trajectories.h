@@ -0,0 +1,359 @@
+#ifndef TRAJECTORIES_H
+#define TRAJECTORIES_H
+
+// Sistema de trajetórias: cada "mover" anda em linha reta até o próximo ponto de controle do seu
+// caminho e, ao chegar, passa para o seguinte (em laço). Os dados ficam em arrays separados (SoA)
+// e o passo de todos os movers é feito com AVX (8 por vez) ou SSE (4 por vez), comparando distâncias
+// ao quadrado e com 1/sqrt aproximado; só os que chegam a um ponto no frame caem no código escalar
+// para trocar de alvo.
+// Caminhos do tipo Catmull-Rom ou Bézier não usam esse passo: a posição vem da curva parametrizada por
+// comprimento de arco (spline.h), em função do tempo total, com velocidade constante e sem deriva.
+// Não depende de OpenGL: o Cena_Castle só lê as posições para montar as matrizes.
+
+#include "spline.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define TRAJECTORIES_SSE 1
+// AVX com despacho em tempo de execução no GCC/Clang; no MSVC só com /arch:AVX
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TRAJECTORIES_AVX 1
+#define TRAJECTORIES_AVX_TARGET __attribute__((target("avx")))
+#elif defined(__AVX__)
+#define TRAJECTORIES_AVX 1
+#define TRAJECTORIES_AVX_TARGET
+#endif
+#endif
+
+// Caminho de um objeto: pontos de controle e como ligá-los
+struct TrajectoryPath {
+    CurveType type = CurveType::Linear;
+    std::vector<glm::vec3> points;
+
+    bool operator==(const TrajectoryPath& o) const { return type == o.type && points == o.points; }
+};
+
+inline bool parseCurveType(const std::string& name, CurveType& type) {
+    if (name == "linear") type = CurveType::Linear;
+    else if (name == "catmullrom") type = CurveType::CatmullRom;
+    else if (name == "bezier") type = CurveType::Bezier;
+    else return false;
+    return true;
+}
+
+// Pontos de controle de um arquivo de trajetórias, separados por seções "# Objeto N". Uma linha
+// "curve linear|catmullrom|bezier" dentro da seção escolhe o tipo do caminho (padrão: linear).
+// Pontos antes da primeira seção ficam na seção 0.
+inline std::vector<TrajectoryPath> loadTrajectoryFile(const std::string& path, bool& ok) {
+    std::vector<TrajectoryPath> sections;
+    std::ifstream file(path);
+    ok = file.is_open();
+    if (!ok) return sections;
+
+    size_t current = 0;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty()) continue;
+        unsigned section;
+        if (line[0] == '#') {
+            if (std::sscanf(line.c_str(), "# Objeto %u", &section) == 1) current = section;
+            continue;
+        }
+        if (sections.size() <= current) sections.resize(current + 1);
+        char name[32];
+        float x, y, z;
+        if (std::sscanf(line.c_str(), "curve %31s", name) == 1) {
+            if (!parseCurveType(name, sections[current].type))
+                std::fprintf(stderr, "Tipo de curva desconhecido em %s: %s\n", path.c_str(), name);
+        } else if (std::sscanf(line.c_str(), "%f %f %f", &x, &y, &z) == 3) {
+            sections[current].points.emplace_back(x, y, z);
+        }
+    }
+    return sections;
+}
+
+class TrajectorySystem {
+public:
+    enum class Kernel { Scalar, SSE, AVX };
+
+    // Novo mover na posição inicial; sem pontos de controle ele fica parado. Devolve o índice.
+    size_t add(const glm::vec3& start, const std::vector<glm::vec3>& path, float speed = 10.0f) {
+        size_t id = px.size();
+        px.push_back(start.x);
+        py.push_back(start.y);
+        pz.push_back(start.z);
+        // Parado = caminho de um ponto só (a própria posição) e velocidade zero: o kernel não precisa de exceção
+        const std::vector<glm::vec3> still{ start };
+        const std::vector<glm::vec3>& points = path.empty() ? still : path;
+        pathFirst.push_back((uint32_t)cx.size());
+        pathLength.push_back((uint32_t)points.size());
+        for (const auto& p : points) {
+            cx.push_back(p.x);
+            cy.push_back(p.y);
+            cz.push_back(p.z);
+        }
+        index.push_back(0);
+        moverCurve.push_back(-1);
+        tx.push_back(points[0].x);
+        ty.push_back(points[0].y);
+        tz.push_back(points[0].z);
+        speeds.push_back(path.empty() ? 0.0f : speed);
+        return id;
+    }
+
+    // Caminho lido do arquivo: linear usa o passo acima (partindo de start); as curvas começam no seu
+    // primeiro ponto. Curva inválida (poucos pontos) vira caminho linear pelos mesmos pontos.
+    size_t add(const glm::vec3& start, const TrajectoryPath& path, float speed = 10.0f) {
+        SplineCurve curve;
+        if (path.type == CurveType::Linear || !curve.build(path.points, path.type)) {
+            if (path.type != CurveType::Linear)
+                std::fprintf(stderr, "Curva com %zu pontos inválida; usando caminho linear\n", path.points.size());
+            return add(start, path.points, speed);
+        }
+        // No passo linear o mover fica parado (caminho de um ponto, velocidade zero); update() o reposiciona
+        size_t id = add(curve.sample(0.0f), std::vector<glm::vec3>(), 0.0f);
+        moverCurve[id] = (int32_t)curves.size();
+        curveMovers.push_back((uint32_t)id);
+        curveSpeeds.push_back(speed);
+        curveHints.push_back(0);
+        curveStarts.push_back(elapsed);
+        curves.push_back(std::move(curve));
+        return id;
+    }
+
+    void clear() {
+        for (auto* v : { &px, &py, &pz, &tx, &ty, &tz, &speeds, &cx, &cy, &cz }) v->clear();
+        pathFirst.clear();
+        pathLength.clear();
+        index.clear();
+        moverCurve.clear();
+        curves.clear();
+        curveMovers.clear();
+        curveSpeeds.clear();
+        curveHints.clear();
+        curveStarts.clear();
+        elapsed = 0.0;
+    }
+
+    // Recarga da cena: este sistema (recém-montado) assume o relógio de `from`, e o mover i continua de
+    // onde o mover previous[i] de `from` estava (o chamador garante que os dois têm o mesmo caminho).
+    // Movers com previous[i] < 0 começam o caminho agora.
+    void resume(const TrajectorySystem& from, const std::vector<int>& previous) {
+        elapsed = from.elapsed;
+        std::fill(curveStarts.begin(), curveStarts.end(), elapsed);
+        for (size_t i = 0; i < previous.size() && i < px.size(); ++i) {
+            int j = previous[i];
+            if (j < 0 || (size_t)j >= from.px.size() || pathLength[i] != from.pathLength[j]) continue;
+            px[i] = from.px[j];
+            py[i] = from.py[j];
+            pz[i] = from.pz[j];
+            tx[i] = from.tx[j];
+            ty[i] = from.ty[j];
+            tz[i] = from.tz[j];
+            index[i] = from.index[j];
+            int32_t c = moverCurve[i], d = from.moverCurve[j];
+            if (c >= 0 && d >= 0) {
+                curveStarts[c] = from.curveStarts[d];
+                curveHints[c] = from.curveHints[d];
+            }
+        }
+    }
+
+    // Avança todos os movers dt segundos com o melhor kernel disponível
+    void update(float dt) { update(dt, bestKernel()); }
+
+    void update(float dt, Kernel kernel) {
+        size_t count = px.size(), done = 0;
+#ifdef TRAJECTORIES_AVX
+        if (kernel == Kernel::AVX) done = updateAVX(dt, count);
+#endif
+#ifdef TRAJECTORIES_SSE
+        if (kernel == Kernel::SSE || kernel == Kernel::AVX) done += updateSSE(dt, done, count);
+#endif
+        for (size_t i = done; i < count; ++i) stepScalar(i, dt);
+        updateCurves(dt);
+    }
+
+    static Kernel bestKernel() {
+#if defined(TRAJECTORIES_AVX) && defined(__GNUC__)
+        static const bool avx = __builtin_cpu_supports("avx");
+        if (avx) return Kernel::AVX;
+#elif defined(TRAJECTORIES_AVX)
+        return Kernel::AVX;
+#endif
+#ifdef TRAJECTORIES_SSE
+        return Kernel::SSE;
+#else
+        return Kernel::Scalar;
+#endif
+    }
+
+    static const char* kernelName(Kernel kernel) {
+        return kernel == Kernel::AVX ? "AVX" : kernel == Kernel::SSE ? "SSE" : "escalar";
+    }
+
+    glm::vec3 position(size_t i) const { return glm::vec3(px[i], py[i], pz[i]); }
+    size_t currentIndex(size_t i) const { return index[i]; }
+    size_t size() const { return px.size(); }
+
+    size_t curveCount() const { return curves.size(); }
+
+private:
+    // Distância percorrida = velocidade x tempo total (em double), reduzida ao comprimento da curva:
+    // a posição não acumula erro, e cada mover custa no máximo uma busca binária na tabela da sua curva
+    void updateCurves(float dt) {
+        elapsed += dt;
+        for (size_t c = 0; c < curves.size(); ++c) {
+            double distance = std::fmod(curveSpeeds[c] * (elapsed - curveStarts[c]), (double)curves[c].length());
+            glm::vec3 p = curves[c].sample((float)distance, curveHints[c]);
+            uint32_t i = curveMovers[c];
+            px[i] = p.x;
+            py[i] = p.y;
+            pz[i] = p.z;
+        }
+    }
+
+    // Mesma regra e mesmas contas do laço original do Cena_Castle: se o passo alcança o alvo, encaixa
+    // nele e troca de alvo; senão anda na direção do alvo. Com normalize x passo (e não delta x passo /
+    // distância) o arredondamento é o mesmo, e um mover perto do alvo chega no mesmo frame que no original
+    void stepScalar(size_t i, float dt) {
+        glm::vec3 position(px[i], py[i], pz[i]), target(tx[i], ty[i], tz[i]);
+        float distance = glm::distance(target, position);
+        float step = speeds[i] * dt;
+        if (step >= distance) {
+            px[i] = target.x;
+            py[i] = target.y;
+            pz[i] = target.z;
+            advance(i);
+        } else {
+            position += glm::normalize(target - position) * step;
+            px[i] = position.x;
+            py[i] = position.y;
+            pz[i] = position.z;
+        }
+    }
+
+    // Próximo ponto de controle (fora do caminho crítico: só quando o mover chega ao alvo)
+    void advance(size_t i) {
+        uint32_t next = index[i] + 1 == pathLength[i] ? 0 : index[i] + 1;
+        index[i] = next;
+        size_t point = pathFirst[i] + next;
+        tx[i] = cx[point];
+        ty[i] = cy[point];
+        tz[i] = cz[point];
+    }
+
+#ifdef TRAJECTORIES_SSE
+    // Blocos de 4 a partir de `first`; devolve quantos movers processou
+    size_t updateSSE(float dt, size_t first, size_t count) {
+        const __m128 dtv = _mm_set1_ps(dt);
+        float *x0 = px.data(), *y0 = py.data(), *z0 = pz.data();
+        const float *tx0 = tx.data(), *ty0 = ty.data(), *tz0 = tz.data(), *speed0 = speeds.data();
+        size_t i = first;
+        for (; i + 4 <= count; i += 4) {
+            __m128 x = _mm_loadu_ps(x0 + i), y = _mm_loadu_ps(y0 + i), z = _mm_loadu_ps(z0 + i);
+            __m128 targetX = _mm_loadu_ps(tx0 + i), targetY = _mm_loadu_ps(ty0 + i), targetZ = _mm_loadu_ps(tz0 + i);
+            __m128 dx = _mm_sub_ps(targetX, x), dy = _mm_sub_ps(targetY, y), dz = _mm_sub_ps(targetZ, z);
+            __m128 distance2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            __m128 step = _mm_mul_ps(_mm_loadu_ps(speed0 + i), dtv);
+            __m128 arrive = _mm_cmpge_ps(_mm_mul_ps(step, step), distance2);
+            __m128 scale = _mm_mul_ps(step, rsqrt(distance2));   // inf/NaN só nas linhas que chegam, descartadas abaixo
+            x = blend(_mm_add_ps(x, _mm_mul_ps(dx, scale)), targetX, arrive);
+            y = blend(_mm_add_ps(y, _mm_mul_ps(dy, scale)), targetY, arrive);
+            z = blend(_mm_add_ps(z, _mm_mul_ps(dz, scale)), targetZ, arrive);
+            _mm_storeu_ps(x0 + i, x);
+            _mm_storeu_ps(y0 + i, y);
+            _mm_storeu_ps(z0 + i, z);
+            int arrived = _mm_movemask_ps(arrive);
+            while (arrived) {
+                int lane = ctz(arrived);
+                advance(i + lane);
+                arrived &= arrived - 1;
+            }
+        }
+        return i - first;
+    }
+
+    // 1/sqrt aproximado (12 bits) + uma iteração de Newton (~22 bits): evita sqrt e divisão, as
+    // instruções mais lentas do passo, e o erro fica muito abaixo do passo de um frame
+    static __m128 rsqrt(__m128 v) {
+        __m128 r = _mm_rsqrt_ps(v);
+        __m128 rr = _mm_mul_ps(_mm_mul_ps(v, r), r);
+        return _mm_mul_ps(_mm_mul_ps(_mm_set1_ps(0.5f), r), _mm_sub_ps(_mm_set1_ps(3.0f), rr));
+    }
+
+    static __m128 blend(__m128 a, __m128 b, __m128 mask) {
+        return _mm_or_ps(_mm_and_ps(mask, b), _mm_andnot_ps(mask, a));
+    }
+#endif
+
+#ifdef TRAJECTORIES_AVX
+    // Blocos de 8 desde o início; devolve quantos movers processou
+    TRAJECTORIES_AVX_TARGET size_t updateAVX(float dt, size_t count) {
+        const __m256 dtv = _mm256_set1_ps(dt);
+        float *x0 = px.data(), *y0 = py.data(), *z0 = pz.data();
+        const float *tx0 = tx.data(), *ty0 = ty.data(), *tz0 = tz.data(), *speed0 = speeds.data();
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 x = _mm256_loadu_ps(x0 + i), y = _mm256_loadu_ps(y0 + i), z = _mm256_loadu_ps(z0 + i);
+            __m256 targetX = _mm256_loadu_ps(tx0 + i), targetY = _mm256_loadu_ps(ty0 + i), targetZ = _mm256_loadu_ps(tz0 + i);
+            __m256 dx = _mm256_sub_ps(targetX, x), dy = _mm256_sub_ps(targetY, y), dz = _mm256_sub_ps(targetZ, z);
+            __m256 distance2 = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)), _mm256_mul_ps(dz, dz));
+            __m256 step = _mm256_mul_ps(_mm256_loadu_ps(speed0 + i), dtv);
+            __m256 arrive = _mm256_cmp_ps(_mm256_mul_ps(step, step), distance2, _CMP_GE_OQ);
+            __m256 r = _mm256_rsqrt_ps(distance2);
+            r = _mm256_mul_ps(_mm256_mul_ps(_mm256_set1_ps(0.5f), r),
+                              _mm256_sub_ps(_mm256_set1_ps(3.0f), _mm256_mul_ps(_mm256_mul_ps(distance2, r), r)));
+            __m256 scale = _mm256_mul_ps(step, r);
+            x = _mm256_blendv_ps(_mm256_add_ps(x, _mm256_mul_ps(dx, scale)), targetX, arrive);
+            y = _mm256_blendv_ps(_mm256_add_ps(y, _mm256_mul_ps(dy, scale)), targetY, arrive);
+            z = _mm256_blendv_ps(_mm256_add_ps(z, _mm256_mul_ps(dz, scale)), targetZ, arrive);
+            _mm256_storeu_ps(x0 + i, x);
+            _mm256_storeu_ps(y0 + i, y);
+            _mm256_storeu_ps(z0 + i, z);
+            int arrived = _mm256_movemask_ps(arrive);
+            while (arrived) {
+                int lane = ctz(arrived);
+                advance(i + lane);
+                arrived &= arrived - 1;
+            }
+        }
+        return i;
+    }
+#endif
+
+    static int ctz(int bits) {
+        int n = 0;
+        while (!(bits & 1)) {
+            bits >>= 1;
+            ++n;
+        }
+        return n;
+    }
+
+    std::vector<float> px, py, pz;       // posição atual
+    std::vector<float> tx, ty, tz;       // alvo atual (cópia do ponto de controle em index)
+    std::vector<float> speeds;           // unidades por segundo
+    std::vector<uint32_t> index;         // ponto de controle atual de cada mover
+    std::vector<int32_t> moverCurve;     // curva de cada mover (-1 no passo linear)
+    std::vector<uint32_t> pathFirst, pathLength;
+    std::vector<float> cx, cy, cz;       // pontos de controle de todos os caminhos, concatenados
+    std::vector<SplineCurve> curves;     // caminhos curvos, cada um com sua tabela de comprimento de arco
+    std::vector<uint32_t> curveMovers;   // mover de cada curva
+    std::vector<float> curveSpeeds;
+    std::vector<size_t> curveHints;      // intervalo da tabela usado no frame anterior
+    std::vector<double> curveStarts;     // instante em que cada curva começou (recargas entram no meio)
+    double elapsed = 0.0;                // tempo total simulado (só as curvas usam)
+};
+
+#endif
@@ -0,0 +1,363 @@
+#ifndef TRANSFORM_BATCH_H
+#define TRANSFORM_BATCH_H
+
+// Matrizes modelo e de normal em lote: translação, rotação de Euler (X, depois Y, depois Z, em radianos,
+// a mesma ordem das três chamadas glm::rotate do Cena_Castle) e escala por eixo ficam em arrays
+// separados (SoA), e compose() monta M = T·Rx·Ry·Rz·S para um intervalo de objetos, 8 por vez (AVX2 + FMA)
+// ou 4 (SSE), com seno e cosseno polinomiais no próprio registrador.
+// A matriz de normal de T·R·S é (R·S)^-T = R·S^-1: as colunas da rotação divididas pela escala, sem
+// inversa. Quando o bloco inteiro tem escala uniforme (o caso comum) basta um recíproco por objeto.
+// O resultado sai direto em glm::mat4/glm::mat3, prontos para o grafo de cena e para os uniformes.
+// Não depende de OpenGL.
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define TRANSFORMS_SSE 1
+// AVX2 + FMA com despacho em tempo de execução no GCC/Clang; no MSVC só com /arch:AVX2
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TRANSFORMS_AVX2 1
+#define TRANSFORMS_AVX2_TARGET __attribute__((target("avx2,fma")))
+#elif defined(__AVX2__)
+#define TRANSFORMS_AVX2 1
+#define TRANSFORMS_AVX2_TARGET
+#endif
+#endif
+
+class TransformBatch {
+public:
+    enum class Kernel { Scalar, SSE, AVX2 };
+
+    std::vector<float> tx, ty, tz;   // translação
+    std::vector<float> rx, ry, rz;   // rotação de Euler
+    std::vector<float> sx, sy, sz;   // escala por eixo
+
+    size_t size() const { return tx.size(); }
+
+    void clear() { resize(0); }
+
+    void resize(size_t count) {
+        for (std::vector<float>* v : { &tx, &ty, &tz, &rx, &ry, &rz })
+            v->resize(count, 0.0f);
+        for (std::vector<float>* v : { &sx, &sy, &sz })
+            v->resize(count, 1.0f);
+    }
+
+    void set(size_t i, const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale) {
+        tx[i] = translation.x;
+        ty[i] = translation.y;
+        tz[i] = translation.z;
+        rx[i] = rotation.x;
+        ry[i] = rotation.y;
+        rz[i] = rotation.z;
+        sx[i] = scale.x;
+        sy[i] = scale.y;
+        sz[i] = scale.z;
+    }
+
+    void push_back(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale) {
+        resize(size() + 1);
+        set(size() - 1, translation, rotation, scale);
+    }
+
+    glm::vec3 translation(size_t i) const { return glm::vec3(tx[i], ty[i], tz[i]); }
+    glm::vec3 rotation(size_t i) const { return glm::vec3(rx[i], ry[i], rz[i]); }
+    glm::vec3 scale(size_t i) const { return glm::vec3(sx[i], sy[i], sz[i]); }
+
+    // Monta os objetos [first, first + count): models[k] e normals[k] recebem o objeto first + k
+    // (normals pode ser nulo). Os polinômios de seno/cosseno valem para ângulos de até ~8000 rad.
+    void compose(size_t first, size_t count, glm::mat4* models, glm::mat3* normals) const {
+        compose(first, count, models, normals, bestKernel());
+    }
+
+    void compose(size_t first, size_t count, glm::mat4* models, glm::mat3* normals, Kernel kernel) const {
+        size_t done = 0;
+#ifdef TRANSFORMS_AVX2
+        if (kernel == Kernel::AVX2) done = composeAVX2(first, count, models, normals);
+#endif
+#ifdef TRANSFORMS_SSE
+        if (kernel == Kernel::SSE || kernel == Kernel::AVX2) done += composeSSE(first + done, count - done, models + done, normals ? normals + done : nullptr);
+#endif
+        for (size_t k = done; k < count; ++k) composeScalar(first + k, models[k], normals ? &normals[k] : nullptr);
+    }
+
+    static Kernel bestKernel() {
+#if defined(TRANSFORMS_AVX2) && defined(__GNUC__)
+        static const bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        if (avx2) return Kernel::AVX2;
+#elif defined(TRANSFORMS_AVX2)
+        return Kernel::AVX2;
+#endif
+#ifdef TRANSFORMS_SSE
+        return Kernel::SSE;
+#else
+        return Kernel::Scalar;
+#endif
+    }
+
+    static const char* kernelName(Kernel kernel) {
+        return kernel == Kernel::AVX2 ? "AVX2" : kernel == Kernel::SSE ? "SSE" : "escalar";
+    }
+
+private:
+    // Referência e cauda dos blocos: mesma fórmula dos kernels, com sin/cos da biblioteca
+    void composeScalar(size_t i, glm::mat4& model, glm::mat3* normal) const {
+        float cx = std::cos(rx[i]), sx0 = std::sin(rx[i]);
+        float cy = std::cos(ry[i]), sy0 = std::sin(ry[i]);
+        float cz = std::cos(rz[i]), sz0 = std::sin(rz[i]);
+        // Colunas de Rx·Ry·Rz
+        glm::vec3 c0(cy * cz, sx0 * sy0 * cz + cx * sz0, sx0 * sz0 - cx * sy0 * cz);
+        glm::vec3 c1(-cy * sz0, cx * cz - sx0 * sy0 * sz0, cx * sy0 * sz0 + sx0 * cz);
+        glm::vec3 c2(sy0, -sx0 * cy, cx * cy);
+        model[0] = glm::vec4(c0 * sx[i], 0.0f);
+        model[1] = glm::vec4(c1 * sy[i], 0.0f);
+        model[2] = glm::vec4(c2 * sz[i], 0.0f);
+        model[3] = glm::vec4(tx[i], ty[i], tz[i], 1.0f);
+        if (!normal) return;
+        if (sx[i] == sy[i] && sy[i] == sz[i]) {
+            float inv = 1.0f / sx[i];
+            (*normal)[0] = c0 * inv;
+            (*normal)[1] = c1 * inv;
+            (*normal)[2] = c2 * inv;
+        } else {
+            (*normal)[0] = c0 / sx[i];
+            (*normal)[1] = c1 / sy[i];
+            (*normal)[2] = c2 / sz[i];
+        }
+    }
+
+    // Constantes do seno/cosseno polinomial (Cephes sinf/cosf): redução por múltiplos de pi/4 em três
+    // partes e polinômios de grau 7 (seno) e 8 (cosseno) em [-pi/4, pi/4]
+    static constexpr float FOUR_OVER_PI = 1.27323954473516f;
+    static constexpr float DP1 = 0.78515625f, DP2 = 2.4187564849853515625e-4f, DP3 = 3.77489497744594108e-8f;
+    static constexpr float SIN_P0 = -1.9515295891e-4f, SIN_P1 = 8.3321608736e-3f, SIN_P2 = -1.6666654611e-1f;
+    static constexpr float COS_P0 = 2.443315711809948e-5f, COS_P1 = -1.388731625493765e-3f, COS_P2 = 4.166664568298827e-2f;
+
+#ifdef TRANSFORMS_SSE
+    static void sincos(__m128 angle, __m128& s, __m128& c) {
+        const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000));
+        __m128 sinSign = _mm_and_ps(angle, signMask);
+        __m128 x = _mm_andnot_ps(signMask, angle);
+
+        // Octante: j = (int)(x * 4/pi) arredondado para par
+        __m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(FOUR_OVER_PI)));
+        j = _mm_and_si128(_mm_add_epi32(j, _mm_set1_epi32(1)), _mm_set1_epi32(~1));
+        __m128 y = _mm_cvtepi32_ps(j);
+        __m128 swapSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29));
+        __m128 usePoly = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+        __m128 cosSign = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+        sinSign = _mm_xor_ps(sinSign, swapSign);
+
+        x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(DP1)));
+        x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(DP2)));
+        x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(DP3)));
+        __m128 z = _mm_mul_ps(x, x);
+
+        __m128 pc = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(COS_P0), z), _mm_set1_ps(COS_P1));
+        pc = _mm_add_ps(_mm_mul_ps(pc, z), _mm_set1_ps(COS_P2));
+        pc = _mm_mul_ps(_mm_mul_ps(pc, z), z);
+        pc = _mm_add_ps(_mm_sub_ps(pc, _mm_mul_ps(_mm_set1_ps(0.5f), z)), _mm_set1_ps(1.0f));
+        __m128 ps = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(SIN_P0), z), _mm_set1_ps(SIN_P1));
+        ps = _mm_add_ps(_mm_mul_ps(ps, z), _mm_set1_ps(SIN_P2));
+        ps = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(ps, z), x), x);
+
+        // Nos octantes ímpares (j & 2) seno e cosseno trocam de polinômio
+        s = _mm_or_ps(_mm_and_ps(usePoly, ps), _mm_andnot_ps(usePoly, pc));
+        c = _mm_or_ps(_mm_and_ps(usePoly, pc), _mm_andnot_ps(usePoly, ps));
+        s = _mm_xor_ps(s, sinSign);
+        c = _mm_xor_ps(c, cosSign);
+    }
+
+    // Transpõe 4 vetores (um elemento de coluna para 4 objetos) em 4 colunas, uma por objeto
+    static void transpose(__m128& a, __m128& b, __m128& c, __m128& d) {
+        _MM_TRANSPOSE4_PS(a, b, c, d);
+    }
+
+    // Blocos de 4; devolve quantos objetos montou
+    size_t composeSSE(size_t first, size_t count, glm::mat4* models, glm::mat3* normals) const {
+        size_t k = 0;
+        for (; k + 4 <= count; k += 4) {
+            size_t i = first + k;
+            __m128 sinX, cosX, sinY, cosY, sinZ, cosZ;
+            sincos(_mm_loadu_ps(&rx[i]), sinX, cosX);
+            sincos(_mm_loadu_ps(&ry[i]), sinY, cosY);
+            sincos(_mm_loadu_ps(&rz[i]), sinZ, cosZ);
+
+            __m128 sxsy = _mm_mul_ps(sinX, sinY), cxsy = _mm_mul_ps(cosX, sinY);
+            __m128 r00 = _mm_mul_ps(cosY, cosZ);
+            __m128 r10 = _mm_add_ps(_mm_mul_ps(sxsy, cosZ), _mm_mul_ps(cosX, sinZ));
+            __m128 r20 = _mm_sub_ps(_mm_mul_ps(sinX, sinZ), _mm_mul_ps(cxsy, cosZ));
+            __m128 r01 = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(cosY, sinZ));
+            __m128 r11 = _mm_sub_ps(_mm_mul_ps(cosX, cosZ), _mm_mul_ps(sxsy, sinZ));
+            __m128 r21 = _mm_add_ps(_mm_mul_ps(cxsy, sinZ), _mm_mul_ps(sinX, cosZ));
+            __m128 r02 = sinY;
+            __m128 r12 = _mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(sinX, cosY));
+            __m128 r22 = _mm_mul_ps(cosX, cosY);
+
+            __m128 scaleX = _mm_loadu_ps(&sx[i]), scaleY = _mm_loadu_ps(&sy[i]), scaleZ = _mm_loadu_ps(&sz[i]);
+            __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+
+            // Modelo: colunas da rotação vezes a escala do eixo, translação na coluna 3
+            __m128 m0 = _mm_mul_ps(r00, scaleX), m1 = _mm_mul_ps(r10, scaleX), m2 = _mm_mul_ps(r20, scaleX), m3 = zero;
+            __m128 m4 = _mm_mul_ps(r01, scaleY), m5 = _mm_mul_ps(r11, scaleY), m6 = _mm_mul_ps(r21, scaleY), m7 = zero;
+            __m128 m8 = _mm_mul_ps(r02, scaleZ), m9 = _mm_mul_ps(r12, scaleZ), m10 = _mm_mul_ps(r22, scaleZ), m11 = zero;
+            __m128 m12 = _mm_loadu_ps(&tx[i]), m13 = _mm_loadu_ps(&ty[i]), m14 = _mm_loadu_ps(&tz[i]), m15 = one;
+            transpose(m0, m1, m2, m3);
+            transpose(m4, m5, m6, m7);
+            transpose(m8, m9, m10, m11);
+            transpose(m12, m13, m14, m15);
+            const __m128 columns[4][4] = { { m0, m4, m8, m12 }, { m1, m5, m9, m13 }, { m2, m6, m10, m14 }, { m3, m7, m11, m15 } };
+            for (int lane = 0; lane < 4; ++lane) {
+                float* out = &models[k + lane][0][0];
+                for (int c = 0; c < 4; ++c) _mm_storeu_ps(out + 4 * c, columns[lane][c]);
+            }
+
+            if (!normals) continue;
+            // Normal: colunas da rotação divididas pela escala; escala uniforme no bloco = um recíproco
+            __m128 invX = _mm_div_ps(one, scaleX), invY = invX, invZ = invX;
+            __m128 uniform = _mm_and_ps(_mm_cmpeq_ps(scaleX, scaleY), _mm_cmpeq_ps(scaleY, scaleZ));
+            if (_mm_movemask_ps(uniform) != 0xF) {
+                invY = _mm_div_ps(one, scaleY);
+                invZ = _mm_div_ps(one, scaleZ);
+            }
+            __m128 n0 = _mm_mul_ps(r00, invX), n1 = _mm_mul_ps(r10, invX), n2 = _mm_mul_ps(r20, invX), n3 = zero;
+            __m128 n4 = _mm_mul_ps(r01, invY), n5 = _mm_mul_ps(r11, invY), n6 = _mm_mul_ps(r21, invY), n7 = zero;
+            __m128 n8 = _mm_mul_ps(r02, invZ), n9 = _mm_mul_ps(r12, invZ), n10 = _mm_mul_ps(r22, invZ), n11 = zero;
+            transpose(n0, n1, n2, n3);
+            transpose(n4, n5, n6, n7);
+            transpose(n8, n9, n10, n11);
+            const __m128 normalColumns[4][3] = { { n0, n4, n8 }, { n1, n5, n9 }, { n2, n6, n10 }, { n3, n7, n11 } };
+            for (int lane = 0; lane < 4; ++lane) storeNormal(&normals[k + lane][0][0], normalColumns[lane], k + lane + 1 == count);
+        }
+        return k;
+    }
+
+    // Colunas de 3 floats gravadas com stores de 4: o quarto float cai na coluna seguinte (reescrita
+    // logo depois) ou no próximo objeto (gravado depois deste); só o último do intervalo vai escalar
+    static void storeNormal(float* out, const __m128 columns[3], bool last) {
+        _mm_storeu_ps(out, columns[0]);
+        _mm_storeu_ps(out + 3, columns[1]);
+        if (!last) {
+            _mm_storeu_ps(out + 6, columns[2]);
+        } else {
+            alignas(16) float tail[4];
+            _mm_store_ps(tail, columns[2]);
+            out[6] = tail[0];
+            out[7] = tail[1];
+            out[8] = tail[2];
+        }
+    }
+#endif
+
+#ifdef TRANSFORMS_AVX2
+    TRANSFORMS_AVX2_TARGET static void sincos(__m256 angle, __m256& s, __m256& c) {
+        const __m256 signMask = _mm256_castsi256_ps(_mm256_set1_epi32((int)0x80000000));
+        __m256 sinSign = _mm256_and_ps(angle, signMask);
+        __m256 x = _mm256_andnot_ps(signMask, angle);
+
+        __m256i j = _mm256_cvttps_epi32(_mm256_mul_ps(x, _mm256_set1_ps(FOUR_OVER_PI)));
+        j = _mm256_and_si256(_mm256_add_epi32(j, _mm256_set1_epi32(1)), _mm256_set1_epi32(~1));
+        __m256 y = _mm256_cvtepi32_ps(j);
+        __m256 swapSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_and_si256(j, _mm256_set1_epi32(4)), 29));
+        __m256 usePoly = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(j, _mm256_set1_epi32(2)), _mm256_setzero_si256()));
+        __m256 cosSign = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_andnot_si256(_mm256_sub_epi32(j, _mm256_set1_epi32(2)), _mm256_set1_epi32(4)), 29));
+        sinSign = _mm256_xor_ps(sinSign, swapSign);
+
+        x = _mm256_fnmadd_ps(y, _mm256_set1_ps(DP1), x);
+        x = _mm256_fnmadd_ps(y, _mm256_set1_ps(DP2), x);
+        x = _mm256_fnmadd_ps(y, _mm256_set1_ps(DP3), x);
+        __m256 z = _mm256_mul_ps(x, x);
+
+        __m256 pc = _mm256_fmadd_ps(_mm256_set1_ps(COS_P0), z, _mm256_set1_ps(COS_P1));
+        pc = _mm256_fmadd_ps(pc, z, _mm256_set1_ps(COS_P2));
+        pc = _mm256_mul_ps(_mm256_mul_ps(pc, z), z);
+        pc = _mm256_add_ps(_mm256_fnmadd_ps(_mm256_set1_ps(0.5f), z, pc), _mm256_set1_ps(1.0f));
+        __m256 ps = _mm256_fmadd_ps(_mm256_set1_ps(SIN_P0), z, _mm256_set1_ps(SIN_P1));
+        ps = _mm256_fmadd_ps(ps, z, _mm256_set1_ps(SIN_P2));
+        ps = _mm256_fmadd_ps(_mm256_mul_ps(ps, z), x, x);
+
+        s = _mm256_xor_ps(_mm256_blendv_ps(pc, ps, usePoly), sinSign);
+        c = _mm256_xor_ps(_mm256_blendv_ps(ps, pc, usePoly), cosSign);
+    }
+
+    // 4 vetores de 8 objetos viram, em cada metade de 128 bits, a coluna de um objeto: a[0..3] e
+    // a[4..7] saem em out[0..3] (objetos 0-3 na metade baixa, 4-7 na alta)
+    TRANSFORMS_AVX2_TARGET static void transpose(__m256 a, __m256 b, __m256 c, __m256 d, __m256 out[4]) {
+        __m256 t0 = _mm256_unpacklo_ps(a, b), t1 = _mm256_unpackhi_ps(a, b);
+        __m256 t2 = _mm256_unpacklo_ps(c, d), t3 = _mm256_unpackhi_ps(c, d);
+        out[0] = _mm256_shuffle_ps(t0, t2, 0x44);
+        out[1] = _mm256_shuffle_ps(t0, t2, 0xEE);
+        out[2] = _mm256_shuffle_ps(t1, t3, 0x44);
+        out[3] = _mm256_shuffle_ps(t1, t3, 0xEE);
+    }
+
+    TRANSFORMS_AVX2_TARGET static __m128 half(__m256 v, int high) {
+        return high ? _mm256_extractf128_ps(v, 1) : _mm256_castps256_ps128(v);
+    }
+
+    // Blocos de 8 desde `first`; devolve quantos objetos montou
+    TRANSFORMS_AVX2_TARGET size_t composeAVX2(size_t first, size_t count, glm::mat4* models, glm::mat3* normals) const {
+        size_t k = 0;
+        for (; k + 8 <= count; k += 8) {
+            size_t i = first + k;
+            __m256 sinX, cosX, sinY, cosY, sinZ, cosZ;
+            sincos(_mm256_loadu_ps(&rx[i]), sinX, cosX);
+            sincos(_mm256_loadu_ps(&ry[i]), sinY, cosY);
+            sincos(_mm256_loadu_ps(&rz[i]), sinZ, cosZ);
+
+            __m256 sxsy = _mm256_mul_ps(sinX, sinY), cxsy = _mm256_mul_ps(cosX, sinY);
+            __m256 r00 = _mm256_mul_ps(cosY, cosZ);
+            __m256 r10 = _mm256_fmadd_ps(sxsy, cosZ, _mm256_mul_ps(cosX, sinZ));
+            __m256 r20 = _mm256_fnmadd_ps(cxsy, cosZ, _mm256_mul_ps(sinX, sinZ));
+            __m256 r01 = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(cosY, sinZ));
+            __m256 r11 = _mm256_fnmadd_ps(sxsy, sinZ, _mm256_mul_ps(cosX, cosZ));
+            __m256 r21 = _mm256_fmadd_ps(cxsy, sinZ, _mm256_mul_ps(sinX, cosZ));
+            __m256 r02 = sinY;
+            __m256 r12 = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_mul_ps(sinX, cosY));
+            __m256 r22 = _mm256_mul_ps(cosX, cosY);
+
+            __m256 scaleX = _mm256_loadu_ps(&sx[i]), scaleY = _mm256_loadu_ps(&sy[i]), scaleZ = _mm256_loadu_ps(&sz[i]);
+            __m256 zero = _mm256_setzero_ps(), one = _mm256_set1_ps(1.0f);
+
+            __m256 c0[4], c1[4], c2[4], c3[4];
+            transpose(_mm256_mul_ps(r00, scaleX), _mm256_mul_ps(r10, scaleX), _mm256_mul_ps(r20, scaleX), zero, c0);
+            transpose(_mm256_mul_ps(r01, scaleY), _mm256_mul_ps(r11, scaleY), _mm256_mul_ps(r21, scaleY), zero, c1);
+            transpose(_mm256_mul_ps(r02, scaleZ), _mm256_mul_ps(r12, scaleZ), _mm256_mul_ps(r22, scaleZ), zero, c2);
+            transpose(_mm256_loadu_ps(&tx[i]), _mm256_loadu_ps(&ty[i]), _mm256_loadu_ps(&tz[i]), one, c3);
+            for (int lane = 0; lane < 8; ++lane) {
+                float* out = &models[k + lane][0][0];
+                int q = lane & 3, high = lane >> 2;
+                _mm_storeu_ps(out, half(c0[q], high));
+                _mm_storeu_ps(out + 4, half(c1[q], high));
+                _mm_storeu_ps(out + 8, half(c2[q], high));
+                _mm_storeu_ps(out + 12, half(c3[q], high));
+            }
+
+            if (!normals) continue;
+            __m256 invX = _mm256_div_ps(one, scaleX), invY = invX, invZ = invX;
+            __m256 uniform = _mm256_and_ps(_mm256_cmp_ps(scaleX, scaleY, _CMP_EQ_OQ), _mm256_cmp_ps(scaleY, scaleZ, _CMP_EQ_OQ));
+            if (_mm256_movemask_ps(uniform) != 0xFF) {
+                invY = _mm256_div_ps(one, scaleY);
+                invZ = _mm256_div_ps(one, scaleZ);
+            }
+            __m256 n0[4], n1[4], n2[4];
+            transpose(_mm256_mul_ps(r00, invX), _mm256_mul_ps(r10, invX), _mm256_mul_ps(r20, invX), zero, n0);
+            transpose(_mm256_mul_ps(r01, invY), _mm256_mul_ps(r11, invY), _mm256_mul_ps(r21, invY), zero, n1);
+            transpose(_mm256_mul_ps(r02, invZ), _mm256_mul_ps(r12, invZ), _mm256_mul_ps(r22, invZ), zero, n2);
+            for (int lane = 0; lane < 8; ++lane) {
+                int q = lane & 3, high = lane >> 2;
+                const __m128 columns[3] = { half(n0[q], high), half(n1[q], high), half(n2[q], high) };
+                storeNormal(&normals[k + lane][0][0], columns, k + lane + 1 == count);
+            }
+        }
+        return k;
+    }
+#endif
+};
+
+#endif
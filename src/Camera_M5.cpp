@@ -3,6 +3,7 @@
 #include "stb_image.h"
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "tiny_obj_loader.h"
+#include "mesh.h"
 #include "Camera.h"
 
 // ==== INCLUDES PADRÕES ====
@@ -16,15 +17,10 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-// ==== STRUCT PARA ARMAZENAR UM VÉRTICE ====
-struct Vertex {
-    glm::vec3 pos, color, normal;
-    glm::vec2 tex;
-};
-
 struct Model {
-    GLuint VAO, VBO, textureID;
-    size_t vertexCount;
+    GLuint VAO, VBO, EBO, textureID;
+    size_t vertexCount, indexCount;
+    GLenum indexType;
     glm::vec3 ka, kd, ks;
     float shininess;
 };
@@ -128,51 +124,12 @@ Model loadModel(const std::string& objPath) {
     bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, objPath.c_str(), baseDir.string().c_str());
     if (!ret) throw std::runtime_error(err);
 
-    std::vector<Vertex> vertices;
-
-    // Itera sobre os índices do modelo
-    for (const auto& shape : shapes) {
-        for (const auto& idx : shape.mesh.indices) {
-            Vertex v;
-            v.pos = {
-                attrib.vertices[3 * idx.vertex_index + 0],
-                attrib.vertices[3 * idx.vertex_index + 1],
-                attrib.vertices[3 * idx.vertex_index + 2]
-            };
-            v.color = { 1.0f, 1.0f, 1.0f };
-            v.tex = (idx.texcoord_index >= 0) ?
-                glm::vec2(
-                    attrib.texcoords[2 * idx.texcoord_index + 0],
-                    attrib.texcoords[2 * idx.texcoord_index + 1]
-                ) : glm::vec2(0.0f);
-
-            v.normal = (idx.normal_index >= 0) ?
-                glm::vec3(
-                    attrib.normals[3 * idx.normal_index + 0],
-                    attrib.normals[3 * idx.normal_index + 1],
-                    attrib.normals[3 * idx.normal_index + 2]
-                ) : glm::vec3(0.0f, 0.0f, 1.0f);
-            vertices.push_back(v);
-        }
-    }
-
-    vertexCount = vertices.size();
-
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tex));
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-    glEnableVertexAttribArray(3);
-    glBindVertexArray(0);
+    // Deduplica vértices compartilhados e envia VBO/EBO indexados
+    MeshData mesh = buildIndexedMesh(attrib, shapes);
+    GpuMesh gpu = uploadMesh(mesh);
+    VAO = gpu.VAO;
+    VBO = gpu.VBO;
+    vertexCount = gpu.vertexCount;
 
     // Carrega textura associada (se houver)
     if (!materials.empty()) {
@@ -206,8 +163,11 @@ Model loadModel(const std::string& objPath) {
     Model model;
     model.VAO = VAO;
     model.VBO = VBO;
+    model.EBO = gpu.EBO;
     model.textureID = textureID;
     model.vertexCount = vertexCount;
+    model.indexCount = gpu.indexCount;
+    model.indexType = gpu.indexType;
     model.ka = ka;
     model.kd = kd;
     model.ks = ks;
@@ -379,7 +339,7 @@ void draw(GLuint shaderID, GLint modelLoc, GLint normalLoc, float angle, const s
         glUniform3fv(glGetUniformLocation(shaderID, "ks"), 1, glm::value_ptr(model.ks));
         glUniform1f(glGetUniformLocation(shaderID, "shininess"), model.shininess);
 
-        glDrawArrays(GL_TRIANGLES, 0, model.vertexCount);
+        glDrawElements(GL_TRIANGLES, (GLsizei)model.indexCount, model.indexType, nullptr);
     }
 
     glBindVertexArray(0);
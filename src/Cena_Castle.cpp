@@ -6,37 +6,84 @@
 #include "Camera.h"
 #define STB_IMAGE_IMPLEMENTATION
 #include "stb_image.h"
+#define STB_IMAGE_WRITE_IMPLEMENTATION
+#include "stb_image_write.h"
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "tiny_obj_loader.h"
+#include "mesh.h"
+#include "meshcache.h"
+#include "meshlod.h"
+#include "packedvertex.h"
+#include "assetloader.h"
+#include "texturecache.h"
+#include "texturestream.h"
+#include "shaderprogram.h"
+#include "materialbuffer.h"
+#include "instancing.h"
+#include "scenebatch.h"
+#include "renderqueue.h"
+#include "lightbuffer.h"
+#include "bounds.h"
+#include "bvh.h"
+#include "meshbvh.h"
+#include "headless.h"
+#include "profiler.h"
+#include "simulation.h"
+#include "scenegraph.h"
+#include "sceneconfig.h"
+#include "filewatch.h"
 
 #include <iostream>
 #include <vector>
 #include <string>
 #include <filesystem>
+#include <chrono>
+#include <random>
+#include <set>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/constants.hpp>
 
 // === ESTRUTURAS DE DADOS ===
-struct Vertex {
-    glm::vec3 pos, color, normal;
-    glm::vec2 tex;
-};
-
 struct Model {
-    GLuint VAO, VBO, textureID;
-    size_t vertexCount;
+    GLuint VAO, VBO, EBO, textureID;
+    size_t vertexCount, indexCount;
+    GLenum indexType;
     glm::vec3 ka, kd, ks;
     float shininess;
+    int materialIndex = 0;      // posição do material no UBO de materiais
+    AABB bounds;                // volumes envolventes em coordenadas do modelo
+    BoundingSphere sphere;
+    std::shared_ptr<const MeshBVH> pickBvh;   // triângulos em espaço de objeto para o ray picking
+    std::vector<MeshLod> lods;  // cadeia de LODs no mesmo EBO; lods[0] é a malha completa (indexCount)
+    VertexFormat vertexFormat = VertexFormat::Full;
+    glm::vec3 positionOffset = glm::vec3(0.0f), positionScale = glm::vec3(1.0f);   // desquantização da posição
+    uint64_t sortKey = 0;       // estado do draw na chave da fila de desenho (programa, textura, malha, material)
+};
+
+// Cópias de uma mesma malha desenhadas com uma única chamada instanciada (diretiva "instances")
+struct InstanceGroup {
+    Model model;
+    std::vector<glm::mat4> transforms;
+    InstanceBuffer buffer;
+    AABB worldBounds;           // união das cópias; o grupo é descartado inteiro
+    // LOD de cada cópia: o buffer guarda as cópias agrupadas por nível, e cada nível vira um draw
+    std::vector<LodState> copyLods;
+    std::vector<glm::mat4> lodOrder;     // transformações na ordem do buffer
+    std::vector<size_t> lodFirst;        // primeira cópia de cada nível no buffer (lods.size() + 1 entradas)
 };
 
-struct Trajectory {
-    std::vector<glm::vec3> controlPoints;
-    size_t currentIndex = 0;
-    float moveSpeed = 10.0f;
-    glm::vec3 currentPos = glm::vec3(0.0f);
+// O que applySceneConfig mudou na cena viva (recarga a quente)
+struct SceneReload {
+    std::vector<int> previousObject;     // objeto anterior cuja malha cada objeto reaproveita (-1: carregado agora)
+    std::vector<int> previousMover;      // mover anterior que cada objeto continua (-1: recomeça o caminho)
+    size_t loaded = 0, reused = 0, released = 0;
+    bool modelsChanged = false;          // lote, materiais e estados por objeto precisam ser refeitos
+    bool cameraChanged = false;
+    bool failed = false;                 // configuração não aplicada; a cena ficou como estava
 };
 
 
@@ -46,14 +93,18 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos);
 void scroll_callback(GLFWwindow* window, double xoffset, double yoffset);
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
 
-Model loadModel(const std::string& path);
-void loadSceneConfig(const std::string& path);
-void loadTrajectoriesFromTxt(const std::string& path);
+Model uploadModel(PendingAsset& asset);
+SceneReload applySceneConfig(const SceneConfig& config, const std::set<std::string>& changedFiles);
+void loadSceneModels(const std::vector<std::string>& objPaths, const std::vector<int>& loadGroup, const std::vector<size_t>& loadSlot,
+                     std::vector<Model>& targetModels, std::vector<InstanceGroup>& targetGroups);
+TrajectoryPath loadTrajectoriesFromTxt(const std::string& path, size_t objectIndex);
 void saveTrajectoriesToTxt(const std::string& path);
-int setupShader();
 
-int intersectedObjectIndex(const glm::vec3& rayOrigin, const glm::vec3& rayDir);
-glm::vec3 calculateRayDirection(const glm::mat4& projection, const glm::mat4& view);
+std::string modelPath(const std::string& name);
+std::string trajectoryPath(const std::string& name);
+
+int intersectedObjectIndex(const glm::vec3& rayOrigin, const glm::vec3& rayDir, RayHit& hit);
+glm::vec3 calculateRayDirection(const glm::mat4& projection, const glm::mat4& view, const glm::vec2& ndc);
 
 // === VARIÁVEIS GLOBAIS ===
 const GLuint WIDTH = 1920, HEIGHT = 1080;
@@ -61,167 +112,539 @@ bool rotateX = false, rotateY = false, rotateZ = false;
 glm::vec3 position(0.0f);
 float scale = 1.0f;
 
-GLuint VAO, VBO, textureID;
-size_t vertexCount = 0;
 glm::vec3 ka(0.2f), kd(0.8f), ks(1.0f);
 float shininess = 32.0f;
 
 Camera camera(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), -90.0f, 0.0f);
 float deltaTime = 0.0f;        
-float animationDelta = 0.0f;   
-float lastFrame = 0.0f;
+double lastFrame = 0.0;
+
 float lastX = WIDTH / 2.0f, lastY = HEIGHT / 2.0f;
 bool firstMouse = true;
 float fov = 45.0f;
 bool isPaused = false;
-
-std::vector<Trajectory> trajectories;
+bool legacyUniforms = false;   // tecla M: volta ao envio de ka/kd/ks/shininess por nome, para comparação
+bool batchedScene = false;     // tecla B: cena inteira em um único glMultiDrawElementsIndirect
+bool batchAvailable = false;
+bool frustumCulling = true;    // tecla F: desliga o culling para comparação
+bool sortedDraws = true;       // tecla O: desenha sem ordenar a fila, para comparação
+VertexFormat vertexFormat = VertexFormat::Packed16;   // --vertices: formato dos VBOs de todos os modelos
+int lodMode = 0;               // tecla L: 0 = LOD com cross-fade, 1 = troca direta, 2 = sempre o LOD 0
+const char* lodModeNames[] = { "com cross-fade", "troca direta", "desligado (sempre LOD 0)" };
+bool traceToggleRequested = false;   // tecla P: encerra a sessão do profiler ou inicia uma nova
+int traceSession = 1;
+
+Simulation simulation;           // trajetórias em passo fixo, numa thread própria
+double simulationRate = Simulation::DEFAULT_RATE;
+std::vector<TrajectoryPath> objectPaths;   // caminho de cada objeto (do arquivo de configuração)
 std::vector<glm::vec3> objectPositions;
-std::vector<glm::vec3> objectRotations;
-std::vector<float> objectScales;
+std::vector<glm::vec3> objectTranslations;   // posição de cada objeto no frame, interpolada entre ticks da simulação
+SceneGraph sceneGraph;   // nó i = objeto i: rotação, escala e hierarquia; matrizes de mundo e de normal em cache
 
 size_t selectedObject = 0;
 int highlightedObject = -1; 
 
 std::vector<Model> models;
+std::vector<InstanceGroup> instanceGroups;
+TextureCache textureCache;
+TextureStreamer textureStreamer;   // mipmaps maiores enviados ao longo dos frames, por PBO
 
+SceneConfig sceneConfig;   // configuração aplicada na cena viva (base da comparação na recarga)
 glm::vec3 lightPosition;
+std::vector<PointLight> pointLights;   // luzes pontuais da configuração, atribuídas aos clusters a cada frame
 float cameraYaw, cameraPitch;
 float cameraNear, cameraFar;
 glm::vec3 cameraStartPosition;
 
 // === SHADERS ===
-const GLchar* vertexShaderSource = R"(
-#version 450
-layout(location = 0) in vec3 position;
-layout(location = 1) in vec3 color;
-layout(location = 2) in vec2 texCoord;
-layout(location = 3) in vec3 normal;
-
-out vec3 FragPos;
-out vec3 Normal;
-out vec4 finalColor;
-out vec2 TexCoord;
-
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
-uniform mat3 normalMatrix;
-
-void main() {
-    FragPos = vec3(model * vec4(position, 1.0));
-    Normal = normalize(normalMatrix * normal);
-    TexCoord = texCoord;
-    finalColor = vec4(color, 1.0);
-    gl_Position = projection * view * model * vec4(position, 1.0);
+// Fontes GLSL em Shaders/, relidos na recarga a quente; o par "_lote" é o do multi-draw indireto
+const std::string SHADER_DIR = "../Shaders/";
+const std::string vertexShaderPath = SHADER_DIR + "Cena_Castle.vert";
+const std::string fragmentShaderPath = SHADER_DIR + "Cena_Castle.frag";
+const std::string batchVertexShaderPath = SHADER_DIR + "Cena_Castle_lote.vert";
+const std::string batchFragmentShaderPath = SHADER_DIR + "Cena_Castle_lote.frag";
+
+// Caminho de renderização ativo, para o relatório de tempos
+int renderPath() {
+    return batchedScene ? 2 : (legacyUniforms ? 0 : 1);
+}
+
+std::string traceSessionPath(const std::string& prefix, int session) {
+    return prefix + "_" + std::to_string(session) + ".json";
 }
-)";
-
-const GLchar* fragmentShaderSource = R"(
-#version 450
-in vec3 FragPos;
-in vec3 Normal;
-in vec2 TexCoord;
-in vec4 finalColor;
-
-out vec4 fragColor;
-
-uniform sampler2D texture1;
-uniform vec3 lightPos;
-uniform vec3 viewPos;
-uniform vec3 ka, kd, ks;
-uniform float shininess;
-
-void main() {
-    vec3 norm = normalize(Normal);
-    vec3 lightDir = normalize(lightPos - FragPos);
-    vec3 viewDir = normalize(viewPos - FragPos);
-    vec3 reflectDir = reflect(-lightDir, norm);
-
-    vec3 ambient = ka * vec3(texture(texture1, TexCoord));
-    float diff = max(dot(norm, lightDir), 0.0);
-    vec3 diffuse = kd * diff * vec3(texture(texture1, TexCoord));
-    float spec = pow(max(dot(viewDir, reflectDir), 0.0), shininess);
-    vec3 specular = ks * spec;
-
-    vec3 result = ambient + diffuse + specular;
-    fragColor = vec4(result, 1.0) * finalColor;
+
+// Diâmetro aproximado em pixels de uma esfera na tela (altura da janela e fov vertical da câmera)
+float projectedPixels(const glm::vec3& center, float radius, const glm::vec3& eye, float fovY) {
+    float distance = glm::length(center - eye);
+    if (distance <= radius) return (float)HEIGHT;
+    return (float)HEIGHT * radius / (distance * std::tan(0.5f * fovY));
 }
-)";
 
-int main() {
+// Pixels por unidade de mundo no ponto da esfera mais próximo da câmera (escala do erro dos LODs)
+float pixelsPerUnit(const glm::vec3& center, float radius, const glm::vec3& eye, float fovY) {
+    float distance = std::max(glm::length(center - eye) - radius, cameraNear);
+    return 0.5f * (float)HEIGHT / (distance * std::tan(0.5f * fovY));
+}
+
+// Faixa de índices de um nível no EBO do modelo
+void drawLod(const Model& model, int lod, GLsizei instances = 1) {
+    const MeshLod& range = model.lods[lod];
+    size_t indexSize = model.indexType == GL_UNSIGNED_SHORT ? sizeof(uint16_t) : sizeof(uint32_t);
+    const void* offset = (const void*)(range.firstIndex * indexSize);
+    if (instances == 1)
+        glDrawElements(GL_TRIANGLES, (GLsizei)range.indexCount, model.indexType, offset);
+    else
+        glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)range.indexCount, model.indexType, offset, instances);
+}
+
+const char* renderPathName(int path) {
+    static const char* names[] = { "[uniformes por nome] ", "[UBO de materiais] ", "[multi-draw indireto] " };
+    return names[path];
+}
+
+int main(int argc, char** argv) {
+    auto programStart = std::chrono::steady_clock::now();
+
+    // Linha de comando: arquivo de cena e o modo sem janela (benchmarks e testes de imagem)
+    HeadlessOptions headless;
+    std::string argError;
+    if (!parseHeadlessOptions(argc, argv, headless, argError)) {
+        std::cerr << argError << "\n" << headlessUsage();
+        return 1;
+    }
+
+    if (headless.enabled) initHeadlessPlatform(headless);
     glfwInit();
-    GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Castle Scene", nullptr, nullptr);
+    GLFWwindow* window = headless.enabled ? createHeadlessWindow(headless, WIDTH, HEIGHT)
+                                          : glfwCreateWindow(WIDTH, HEIGHT, "Castle Scene", nullptr, nullptr);
+    if (!window) {
+        std::cerr << "Falha ao criar o contexto OpenGL" << (headless.enabled ? " sem janela (--context " + headless.context + ")" : "") << "\n";
+        glfwTerminate();
+        return -1;
+    }
     glfwMakeContextCurrent(window);
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-    lastX = WIDTH / 2.0f;
-    lastY = HEIGHT / 2.0f;
-    firstMouse = true;
-    glfwSetCursorPosCallback(window, mouse_callback);
-    glfwSetMouseButtonCallback(window, mouse_button_callback);
-    glfwSetScrollCallback(window, scroll_callback);
-    glfwSetKeyCallback(window, key_callback);
+    if (!headless.enabled) {
+        glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+        lastX = WIDTH / 2.0f;
+        lastY = HEIGHT / 2.0f;
+        firstMouse = true;
+        glfwSetCursorPosCallback(window, mouse_callback);
+        glfwSetMouseButtonCallback(window, mouse_button_callback);
+        glfwSetScrollCallback(window, scroll_callback);
+        glfwSetKeyCallback(window, key_callback);
+    }
     gladLoadGLLoader((GLADloadproc)glfwGetProcAddress);
 
-    GLuint shaderID = setupShader();
-    
+    // A primeira sessão do profiler cobre o carregamento; a tecla P fecha e abre novas sessões
+    PROFILE_BEGIN_SESSION(traceSessionPath(headless.tracePrefix, traceSession));
+
+    ShaderProgram shader;
+    if (!shader.buildFiles(vertexShaderPath, fragmentShaderPath)) {
+        glfwTerminate();
+        return -1;
+    }
+    GLuint shaderID = shader.id;
+
+    // Texturas .ktx2 entram só com a cauda de mipmaps; o resto chega durante os primeiros frames
+    if (headless.streamTextures) {
+        if (textureStreamer.init((GLADloadproc)glfwGetProcAddress))
+            textureCache.setStreamer(&textureStreamer);
+        else
+            std::cout << "Streaming de texturas indisponível (requer OpenGL 4.4); texturas enviadas inteiras\n";
+    }
+
     // Carrega configurações da cena a partir de arquivo externo
-    loadSceneConfig("../Cenas/config.txt");
+    vertexFormat = headless.vertexFormat;
+    {
+        SceneConfig config;
+        if (!parseSceneConfig(headless.configPath, config))
+            std::cerr << "Erro ao abrir arquivo de configuração: " << headless.configPath << "\n";
+        applySceneConfig(config, {});
+    }
 
     // Inicializa a câmera com parâmetros carregados da configuração
     camera = Camera(cameraStartPosition, glm::vec3(0.0f, 1.0f, 0.0f), cameraYaw, cameraPitch);
 
     glEnable(GL_DEPTH_TEST);
 
-    // Ativa o shader e define o sampler da textura
-    glUseProgram(shaderID);
-    glUniform1i(glGetUniformLocation(shaderID, "texture1"), 0);
+    // Localizações dos uniformes, resolvidas uma única vez no link do programa (e de novo quando os
+    // shaders são recompilados pela recarga a quente)
+    GLint modelLoc = -1, viewLoc = -1, projLoc = -1, normalLoc = -1, viewPosLoc = -1;
+    GLint materialIndexLoc = -1, useMaterialBlockLoc = -1, useInstancingLoc = -1, lodFadeLoc = -1;
+    GLint positionOffsetLoc = -1, positionScaleLoc = -1;
+    auto setupShader = [&]() {
+        // Ativa o shader e define o sampler da textura
+        shaderID = shader.id;
+        glUseProgram(shaderID);
+        glUniform1i(shader.uniform("texture1"), 0);
+
+        modelLoc = shader.uniform("model");
+        viewLoc = shader.uniform("view");
+        projLoc = shader.uniform("projection");
+        normalLoc = shader.uniform("normalMatrix");
+        viewPosLoc = shader.uniform("viewPos");
+        materialIndexLoc = shader.uniform("materialIndex");
+        useMaterialBlockLoc = shader.uniform("useMaterialBlock");
+        useInstancingLoc = shader.uniform("useInstancing");
+        lodFadeLoc = shader.uniform("lodFade");
+        glUniform1f(lodFadeLoc, 0.0f);
+        positionOffsetLoc = shader.uniform("positionOffset");
+        positionScaleLoc = shader.uniform("positionScale");
+        glUniform1i(shader.uniform("packedVertices"), vertexFormat != VertexFormat::Full ? 1 : 0);
+
+        // Define propriedades globais de iluminação
+        glUniform3fv(shader.uniform("ka"), 1, glm::value_ptr(ka));
+        glUniform3fv(shader.uniform("kd"), 1, glm::value_ptr(kd));
+        glUniform3fv(shader.uniform("ks"), 1, glm::value_ptr(ks));
+        glUniform1f(shader.uniform("shininess"), shininess);
+        glUniform3fv(shader.uniform("lightPos"), 1, glm::value_ptr(lightPosition));
+        glUniform2f(shader.uniform("clusterTileSize"), (float)WIDTH / LightClusters::GRID_X, (float)HEIGHT / LightClusters::GRID_Y);
+        glUniform2fv(shader.uniform("clusterDepth"), 1, glm::value_ptr(LightClusters::depthParams(cameraNear, cameraFar)));
+        glUniform3fv(viewPosLoc, 1, glm::value_ptr(camera.Position));
+    };
+    setupShader();
+
+    // Luzes pontuais: listas por cluster montadas nas threads de trabalho e enviadas em SSBOs a cada frame
+    LightClusters lightClusters;
+    LightBuffer lightBuffer;
+    lightBuffer.setLights(pointLights);
+    std::cout << "Luzes pontuais: " << pointLights.size() << " em clusters de " << LightClusters::GRID_X << "x"
+              << LightClusters::GRID_Y << "x" << LightClusters::GRID_Z << " (" << lightClusters.threadCount() << " threads)\n";
+
+    // Materiais de todos os modelos no UBO; cada draw só informa o índice.
+    // O destaque vermelho da seleção é mais um material da tabela. A tabela é refeita a cada recarga,
+    // para os materiais dos modelos que saíram da cena não ocuparem espaço.
+    MaterialBuffer materials;
+    int highlightMaterial = MaterialBuffer::DEFAULT_MATERIAL;
+    auto registerMaterials = [&]() {
+        materials.clear();
+        highlightMaterial = materials.add(glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f), 1.0f);
+        for (auto& model : models)
+            model.materialIndex = materials.add(model.ka, model.kd, model.ks, model.shininess);
+        for (auto& group : instanceGroups)
+            group.model.materialIndex = materials.add(group.model.ka, group.model.kd, group.model.ks, group.model.shininess);
+        materials.upload(0);
+    };
+    registerMaterials();
+
+    // Fila de desenho do caminho por objeto: a parte de estado da chave de cada modelo é fixa (texturas e
+    // VAOs viram ids densos da cena atual); por frame só entra a profundidade. Grupos instanciados usam a
+    // variante 1 do programa e vêm depois dos objetos.
+    RenderQueue renderQueue;
+    GLStateCache glState;
+    auto assignSortKeys = [&]() {
+        std::vector<uint32_t> textures, meshes;
+        for (const auto& model : models) {
+            textures.push_back(model.textureID);
+            meshes.push_back(model.VAO);
+        }
+        for (const auto& group : instanceGroups) {
+            textures.push_back(group.model.textureID);
+            meshes.push_back(group.model.VAO);
+        }
+        SortKeyIds textureIds, meshIds;
+        textureIds.assign(std::move(textures));
+        meshIds.assign(std::move(meshes));
+        for (auto& model : models)
+            model.sortKey = RenderQueue::stateKey(0, textureIds.id(model.textureID), meshIds.id(model.VAO), model.materialIndex);
+        for (auto& group : instanceGroups)
+            group.model.sortKey = RenderQueue::stateKey(1, textureIds.id(group.model.textureID), meshIds.id(group.model.VAO), group.model.materialIndex);
+    };
+    assignSortKeys();
+
+    // Material de um draw: índice no UBO ou, no caminho antigo, os quatro uniformes por nome
+    auto sendMaterial = [&](int index, const glm::vec3& materialKa, const glm::vec3& materialKd, const glm::vec3& materialKs, float materialShininess) {
+        if (!glState.set(GLStateCache::Material, index)) return;
+        if (legacyUniforms) {
+            glUniform3fv(glGetUniformLocation(shaderID, "ka"), 1, glm::value_ptr(materialKa));
+            glUniform3fv(glGetUniformLocation(shaderID, "kd"), 1, glm::value_ptr(materialKd));
+            glUniform3fv(glGetUniformLocation(shaderID, "ks"), 1, glm::value_ptr(materialKs));
+            glUniform1f(glGetUniformLocation(shaderID, "shininess"), materialShininess);
+        } else {
+            glUniform1i(materialIndexLoc, index);
+        }
+    };
+    std::cout << "Materiais no UBO: " << materials.size() << " (tecla M alterna para o envio por nome)\n";
+
+    // Lote da cena (tecla B): arena única, SSBO de transformações e array de texturas.
+    // Os objetos entram primeiro, então o comando i é o objeto i.
+    SceneBatch sceneBatch;
+    ShaderProgram batchShader;
+    GLint batchViewLoc = -1, batchProjLoc = -1, batchViewPosLoc = -1, batchOverrideLoc = -1;
+    bool batchTransformsSynced = false;   // registros dos objetos com as matrizes atuais do grafo
+    auto setupBatchShader = [&]() {
+        batchShader.use();
+        glUniform1i(batchShader.uniform("textures"), 0);
+        glUniform3fv(batchShader.uniform("lightPos"), 1, glm::value_ptr(lightPosition));
+        glUniform2f(batchShader.uniform("clusterTileSize"), (float)WIDTH / LightClusters::GRID_X, (float)HEIGHT / LightClusters::GRID_Y);
+        glUniform2fv(batchShader.uniform("clusterDepth"), 1, glm::value_ptr(LightClusters::depthParams(cameraNear, cameraFar)));
+        glUniform1i(batchShader.uniform("overrideMaterial"), -1);
+        glUniform1i(batchShader.uniform("packedVertices"), sceneBatch.vertexFormat() != VertexFormat::Full ? 1 : 0);
+        batchViewLoc = batchShader.uniform("view");
+        batchProjLoc = batchShader.uniform("projection");
+        batchViewPosLoc = batchShader.uniform("viewPos");
+        batchOverrideLoc = batchShader.uniform("overrideMaterial");
+        shader.use();
+    };
+    // Refeito do zero quando a recarga muda as malhas da cena
+    auto buildBatch = [&]() {
+        auto meshOf = [](const Model& model) {
+            GpuMesh gpu;
+            gpu.VAO = model.VAO;
+            gpu.VBO = model.VBO;
+            gpu.EBO = model.EBO;
+            gpu.vertexCount = model.vertexCount;
+            gpu.indexCount = model.indexCount;
+            gpu.indexType = model.indexType;
+            gpu.format = model.vertexFormat;
+            gpu.positionOffset = model.positionOffset;
+            gpu.positionScale = model.positionScale;
+            return gpu;
+        };
+        sceneBatch.clear();
+        batchTransformsSynced = false;
+        for (const auto& model : models)
+            sceneBatch.addDraw(meshOf(model), model.textureID, model.materialIndex);
+        std::vector<size_t> groupCommands;
+        for (const auto& group : instanceGroups)
+            groupCommands.push_back(sceneBatch.addDraw(meshOf(group.model), group.model.textureID, group.model.materialIndex, group.transforms.size()));
+        sceneBatch.build();
+
+        // Grupos instanciados são estáticos: as transformações vão uma única vez
+        for (size_t g = 0; g < instanceGroups.size(); ++g) {
+            size_t first = sceneBatch.firstRecord(groupCommands[g]);
+            for (size_t k = 0; k < instanceGroups[g].transforms.size(); ++k)
+                sceneBatch.setTransform(first + k, instanceGroups[g].transforms[k]);
+        }
+        setupBatchShader();
+
+        std::cout << "Lote da cena: " << sceneBatch.commandCount() << " comandos, " << sceneBatch.recordCount() << " registros, "
+                  << sceneBatch.meshCount() << " malhas (" << sceneBatch.arenaBytes() / 1024 << " KB na arena), "
+                  << sceneBatch.layerCount() << " texturas de " << sceneBatch.layerSize() << "px (tecla B alterna)\n";
+    };
+    if (sceneBatch.loadEntryPoints((GLADloadproc)glfwGetProcAddress) &&
+        batchShader.buildFiles(batchVertexShaderPath, batchFragmentShaderPath)) {
+        buildBatch();
+        batchAvailable = true;
+    } else {
+        std::cout << "Multi-draw indireto indisponível (requer OpenGL 4.3); usando o desenho por objeto\n";
+    }
+
+    // Um mover por objeto: caminhos lineares partem da posição da configuração (sem pontos de controle
+    // fica parado); curvas começam no primeiro ponto e andam com velocidade constante
+    auto buildTrajectories = [&]() {
+        TrajectorySystem trajectories;
+        for (size_t i = 0; i < objectPositions.size(); ++i)
+            trajectories.add(objectPositions[i], objectPaths[i]);
+        return trajectories;
+    };
+    {
+        TrajectorySystem trajectories = buildTrajectories();
+        std::cout << "Trajetórias: " << trajectories.size() << " movers (" << trajectories.curveCount() << " em curvas), kernel "
+                  << TrajectorySystem::kernelName(TrajectorySystem::bestKernel()) << ", simulação a " << simulationRate << " Hz\n";
+        simulation.reset(std::move(trajectories), simulationRate);
+    }
+    simulation.setPaused(isPaused);
 
-    // Localiza uniformes das matrizes
-    GLint modelLoc = glGetUniformLocation(shaderID, "model");
-    GLint viewLoc = glGetUniformLocation(shaderID, "view");
-    GLint projLoc = glGetUniformLocation(shaderID, "projection");
-    GLint normalLoc = glGetUniformLocation(shaderID, "normalMatrix");
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    // Define propriedades globais de iluminação
-    glUniform3fv(glGetUniformLocation(shaderID, "ka"), 1, glm::value_ptr(ka));
-    glUniform3fv(glGetUniformLocation(shaderID, "kd"), 1, glm::value_ptr(kd));
-    glUniform3fv(glGetUniformLocation(shaderID, "ks"), 1, glm::value_ptr(ks));
-    glUniform1f(glGetUniformLocation(shaderID, "shininess"), shininess);
-    glUniform3fv(glGetUniformLocation(shaderID, "lightPos"), 1, glm::value_ptr(lightPosition));
-    glUniform3fv(glGetUniformLocation(shaderID, "viewPos"), 1, glm::value_ptr(cameraStartPosition));
+    // Comparação entre os dois caminhos: média do tempo de frame e do tempo de CPU gasto nos draws
+    const int statsInterval = 240;
+    int statsFrames = 0, statsIntervals = 0;
+    double statsFrameMs = 0.0, statsSubmitMs = 0.0;
+    size_t statsTriangles = 0, statsTransforms = 0, statsStateChanges = 0, statsStateSkipped = 0;
+    size_t statsClusterLights = 0, statsClusterEntries = 0;
+    double statsClusterMs = 0.0;
+    int statsPath = renderPath();
+
+    // Frustum culling: caixas de mundo dos objetos em uma BVH reajustada a cada frame
+    ObjectBVH objectBvh;
+    std::vector<AABB> worldBounds;
+    std::vector<BoundingSphere> worldSpheres;
+    std::vector<uint32_t> visibleObjects;
+    std::vector<bool> groupVisible;
+    CullStats cullStats;
+    bool boundsStale = true;     // algum volume de mundo mudou desde o último ajuste da BVH
+
+    // Níveis de detalhe: um estado por objeto, um por cópia nos grupos instanciados
+    lodMode = headless.lodMode;
+    std::vector<LodState> objectLods;
+
+    // Estado por objeto e por grupo, dimensionado pela cena atual
+    auto resetSceneState = [&]() {
+        worldBounds.assign(models.size(), AABB());
+        worldSpheres.assign(models.size(), BoundingSphere());
+        groupVisible.assign(instanceGroups.size(), true);
+        objectLods.assign(models.size(), LodState());
+        for (auto& group : instanceGroups) {
+            group.copyLods.assign(group.transforms.size(), LodState());
+            group.lodOrder = group.transforms;
+            group.lodFirst.assign(group.model.lods.size() + 1, group.transforms.size());
+            group.lodFirst[0] = 0;
+        }
+    };
+    resetSceneState();
 
-    // Inicializa as posições iniciais das trajetórias
-    trajectories.resize(objectPositions.size());
-    for (size_t i = 0; i < objectPositions.size(); ++i) {
-        trajectories[i].currentPos = objectPositions[i];
+    size_t lodLevels = 0, lodMeshes = 0;
+    for (const auto& model : models) {
+        lodLevels += model.lods.size();
+        lodMeshes += model.lods.size() > 1 ? 1 : 0;
+    }
+    for (const auto& group : instanceGroups) {
+        lodLevels += group.model.lods.size();
+        lodMeshes += group.model.lods.size() > 1 ? 1 : 0;
+    }
+    std::cout << "LODs: " << lodMeshes << " de " << models.size() + instanceGroups.size() << " malhas com cadeia, "
+              << lodLevels << " níveis no total, troca " << lodModeNames[lodMode] << " (tecla L alterna; o lote usa sempre o LOD 0)\n";
+
+    // Recarga a quente (só com janela): configuração, trajetórias e modelos da cena e os quatro shaders
+    FileWatcher watcher;
+    auto watchScene = [&]() {
+        watcher.watch(headless.configPath);
+        for (const auto& object : sceneConfig.objects) {
+            watcher.watch(modelPath(object.model));
+            if (!object.trajectory.empty()) watcher.watch(trajectoryPath(object.trajectory));
+        }
+        for (const auto& group : sceneConfig.instances) watcher.watch(modelPath(group.model));
+    };
+    const std::set<std::string> shaderFiles = { vertexShaderPath, fragmentShaderPath, batchVertexShaderPath, batchFragmentShaderPath };
+    if (!headless.enabled) {
+        for (const auto& path : shaderFiles) watcher.watch(path);
+        watchScene();
+        std::cout << "Recarga a quente: " << watcher.size() << " arquivos observados (" << watcher.backend() << ")\n";
     }
 
-    objectPositions.resize(models.size(), glm::vec3(0.0f));
-    objectRotations.resize(models.size(), glm::vec3(0.0f));
-    objectScales.resize(models.size(), 1.0f);
+    auto hotReload = [&](const std::vector<std::string>& changed) {
+        PROFILE_SCOPE("hotReload");
+        auto reloadStart = std::chrono::steady_clock::now();
+        std::set<std::string> changedFiles(changed.begin(), changed.end());
+        bool shadersChanged = false, sceneChanged = false;
+        std::cout << "Recarga a quente:";
+        for (const auto& path : changed) {
+            if (shaderFiles.count(path)) shadersChanged = true;
+            else sceneChanged = true;
+            std::cout << " " << std::filesystem::path(path).filename().string();
+        }
+        std::cout << "\n";
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        // Um shader que não compila deixa o programa anterior no lugar (o log do driver já saiu no console)
+        if (shadersChanged) {
+            if (shader.buildFiles(vertexShaderPath, fragmentShaderPath)) setupShader();
+            if (batchAvailable && batchShader.buildFiles(batchVertexShaderPath, batchFragmentShaderPath)) setupBatchShader();
+        }
+
+        if (sceneChanged) {
+            SceneConfig config;
+            if (!parseSceneConfig(headless.configPath, config)) {
+                std::cerr << "Erro ao abrir arquivo de configuração: " << headless.configPath << "\n";
+                return;
+            }
+            SceneReload reload = applySceneConfig(config, changedFiles);
+            if (reload.failed) return;
+            lightBuffer.setLights(pointLights);
+
+            if (reload.modelsChanged) {
+                registerMaterials();
+                assignSortKeys();
+                if (batchAvailable) buildBatch();
+                resetSceneState();
+                for (auto& group : instanceGroups) group.buffer.update(group.transforms);   // volta à ordem sem LOD
+                // A seleção acompanha o objeto, que pode ter mudado de posição na lista
+                int selected = -1;
+                for (size_t i = 0; i < reload.previousObject.size(); ++i)
+                    if (selectedObject != (size_t)-1 && reload.previousObject[i] == (int)selectedObject) selected = (int)i;
+                selectedObject = (size_t)selected;
+                highlightedObject = selected;
+            }
+            simulation.replace(buildTrajectories(), reload.previousMover, simulationRate);
+            if (reload.cameraChanged)
+                camera = Camera(cameraStartPosition, glm::vec3(0.0f, 1.0f, 0.0f), cameraYaw, cameraPitch);
+            setupShader();
+            if (batchAvailable) setupBatchShader();
+            watchScene();
+
+            size_t continued = 0;
+            for (int mover : reload.previousMover) continued += mover >= 0 ? 1 : 0;
+            std::cout << "  cena: " << reload.loaded << " modelos carregados, " << reload.reused << " reaproveitados, "
+                      << reload.released << " liberados; " << continued << " de " << reload.previousMover.size()
+                      << " trajetórias continuam de onde estavam\n";
+        }
+        std::cout << "  recarga em " << elapsedMs(reloadStart) << " ms\n";
+    };
+
+    // Modo sem janela: FBO do tamanho da janela, câmera do arquivo e passo de tempo fixo
+    OffscreenTarget offscreen;
+    FrameTimings frameTimings;
+    std::vector<CameraKey> cameraKeys;
+    if (headless.enabled) {
+        if (!offscreen.create(WIDTH, HEIGHT)) {
+            std::cerr << "Framebuffer fora da tela incompleto\n";
+            lightBuffer.release();
+            glfwTerminate();
+            return -1;
+        }
+        if (!headless.cameraPath.empty() && !loadCameraPath(headless.cameraPath, cameraKeys))
+            std::cerr << "Caminho de câmera inválido: " << headless.cameraPath << " (usando a câmera da configuração)\n";
+        if (!headless.outputDir.empty()) std::filesystem::create_directories(headless.outputDir);
+        std::cout << "Modo sem janela: " << headless.frames << " frames em " << WIDTH << "x" << HEIGHT << ", "
+                  << glGetString(GL_RENDERER) << "\n";
+    }
+    int frameIndex = 0;
+
+    // Com janela a simulação anda sozinha pelo relógio; sem janela ela avança junto com os frames
+    if (!headless.enabled) simulation.start();
+
+    auto previousFrameStart = std::chrono::steady_clock::now();
+
+    while (headless.enabled ? frameIndex < headless.frames : !glfwWindowShouldClose(window)) {
+        PROFILE_SCOPE("frame");
+        if (headless.enabled) frameTimings.beginFrame();
+        else glfwPollEvents();
+
+        // Recarga a quente: arquivos observados que mudaram desde o último frame
+        if (!headless.enabled) {
+            std::vector<std::string> changed = watcher.changes();
+            if (!changed.empty()) hotReload(changed);
+        }
 
-    while (!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
+        auto frameStart = std::chrono::steady_clock::now();
+        if (statsPath != renderPath()) {
+            statsPath = renderPath();
+            statsFrames = statsIntervals = 0;
+            statsFrameMs = statsSubmitMs = statsClusterMs = 0.0;
+            statsTriangles = statsTransforms = statsStateChanges = statsStateSkipped = 0;
+            statsClusterLights = statsClusterEntries = 0;
+        } else {
+            statsFrameMs += std::chrono::duration<double, std::milli>(frameStart - previousFrameStart).count();
+            ++statsIntervals;
+        }
+        previousFrameStart = frameStart;
 
-        // Calcula tempo entre frames
-        float currentFrame = glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
+        // Calcula tempo entre frames (fixo no modo sem janela, para os frames serem reprodutíveis).
+        // Só a câmera usa deltaTime; a animação vem da simulação.
+        double currentFrame = headless.enabled ? frameIndex / 60.0 : glfwGetTime();
+        deltaTime = static_cast<float>(currentFrame - lastFrame);
         lastFrame = currentFrame;
-        animationDelta = isPaused ? 0.0f : deltaTime;
-
-        // Entrada de teclado para movimentação da câmera
-        if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-            camera.ProcessKeyboard(Camera_Movement::FORWARD, deltaTime);
-        if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-            camera.ProcessKeyboard(Camera_Movement::BACKWARD, deltaTime);
-        if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
-            camera.ProcessKeyboard(Camera_Movement::LEFT, deltaTime);
-        if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
-            camera.ProcessKeyboard(Camera_Movement::RIGHT, deltaTime);
+
+        if (headless.enabled) {
+            // Câmera percorre o caminho do início ao fim ao longo dos frames
+            if (!cameraKeys.empty()) {
+                float t = headless.frames > 1 ? (float)frameIndex / (headless.frames - 1) : 0.0f;
+                CameraKey key = sampleCameraPath(cameraKeys, t);
+                camera = Camera(key.position, glm::vec3(0.0f, 1.0f, 0.0f), key.yaw, key.pitch);
+            }
+        } else {
+            // Entrada de teclado para movimentação da câmera
+            if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+                camera.ProcessKeyboard(Camera_Movement::FORWARD, deltaTime);
+            if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+                camera.ProcessKeyboard(Camera_Movement::BACKWARD, deltaTime);
+            if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+                camera.ProcessKeyboard(Camera_Movement::LEFT, deltaTime);
+            if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+                camera.ProcessKeyboard(Camera_Movement::RIGHT, deltaTime);
+        }
 
         glClearColor(0.529f, 0.808f, 0.922f, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
@@ -232,220 +655,717 @@ int main() {
 
         glUniformMatrix4fv(viewLoc, 1, GL_FALSE, glm::value_ptr(view));
         glUniformMatrix4fv(projLoc, 1, GL_FALSE, glm::value_ptr(projection));
-        glUniform3fv(glGetUniformLocation(shaderID, "viewPos"), 1, glm::value_ptr(camera.Position));
-
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glBindVertexArray(VAO);
-
-        // Renderiza cada objeto carregado
-        for (size_t i = 0; i < objectPositions.size(); ++i) {
-            auto& model = models[i];
-            auto& traj = trajectories[i];
-
-            // Atualização da trajetória
-            if (!traj.controlPoints.empty()) {
-                glm::vec3 target = traj.controlPoints[traj.currentIndex];
-                glm::vec3 direction = glm::normalize(target - traj.currentPos);
-                float distance = glm::distance(target, traj.currentPos);
-                float step = traj.moveSpeed * animationDelta;
-
-                if (step >= distance) {
-                    traj.currentPos = target;
-                    traj.currentIndex = (traj.currentIndex + 1) % traj.controlPoints.size();
+        auto submitStart = std::chrono::steady_clock::now();
+        if (legacyUniforms)
+            glUniform3fv(glGetUniformLocation(shaderID, "viewPos"), 1, glm::value_ptr(camera.Position));
+        else
+            glUniform3fv(viewPosLoc, 1, glm::value_ptr(camera.Position));
+        glUniform1i(useMaterialBlockLoc, legacyUniforms ? 0 : 1);
+
+        // Posições da simulação no instante do frame. O grafo só refaz as matrizes dos objetos que se
+        // moveram (e dos filhos deles), e só esses atualizam os volumes de mundo e o lote
+        {
+            PROFILE_SCOPE("transforms");
+            if (simulation.threaded()) {
+                simulation.sample(simulation.renderTime(), objectTranslations);
+            } else {
+                simulation.advanceTo(currentFrame);
+                simulation.sample(currentFrame, objectTranslations);
+            }
+            for (size_t i = 0; i < objectTranslations.size(); ++i)
+                sceneGraph.setTranslation((uint32_t)i, objectTranslations[i] + position);
+            statsTransforms += sceneGraph.update();
+
+            const std::vector<uint32_t>& changedNodes = sceneGraph.changedNodes();
+            for (uint32_t i : changedNodes) {
+                worldBounds[i] = transformBounds(models[i].bounds, sceneGraph.world(i));
+                worldSpheres[i] = transformSphere(models[i].sphere, sceneGraph.world(i));
+            }
+            boundsStale |= !changedNodes.empty();
+
+            // No caminho em lote só a transformação muda; o desenho sai depois do laço. Ao entrar no lote
+            // (ou depois de refazê-lo na recarga) todas as transformações vão de uma vez
+            if (batchedScene) {
+                if (!batchTransformsSynced) {
+                    for (uint32_t i = 0; i < sceneGraph.size(); ++i)
+                        sceneBatch.setTransform(sceneBatch.firstRecord(i), sceneGraph.world(i));
+                    batchTransformsSynced = true;
                 } else {
-                    traj.currentPos += direction * step;
+                    for (uint32_t i : changedNodes)
+                        sceneBatch.setTransform(sceneBatch.firstRecord(i), sceneGraph.world(i));
                 }
             } else {
-                traj.currentPos = objectPositions[i];
+                batchTransformsSynced = false;
+            }
+        }
+
+        // Luzes pontuais nos clusters do frustum deste frame (os dois caminhos de desenho leem os mesmos SSBOs)
+        {
+            PROFILE_SCOPE("lightClusters");
+            auto clusterStart = std::chrono::steady_clock::now();
+            lightClusters.setProjection(glm::radians(camera.Zoom), (float)WIDTH / HEIGHT, cameraNear, cameraFar);
+            lightClusters.assign(pointLights, view);
+            lightBuffer.uploadClusters(lightClusters);
+            statsClusterLights += lightClusters.visibleLights();
+            statsClusterEntries += lightBuffer.listEntries();
+            statsClusterMs += elapsedMs(clusterStart);
+        }
+
+        // Frustum culling antes de qualquer submissão (near/far da configuração da câmera)
+        {
+            PROFILE_SCOPE("culling");
+            Frustum frustum = Frustum::fromMatrix(projection * view);
+            if (frustumCulling) {
+                // Cena parada: a BVH do frame anterior continua valendo
+                if (boundsStale || objectBvh.size() != worldBounds.size()) objectBvh.update(worldBounds);
+                boundsStale = false;
+                objectBvh.cull(frustum, worldBounds, &worldSpheres, visibleObjects, cullStats);
+            } else {
+                visibleObjects.resize(models.size());
+                for (uint32_t i = 0; i < visibleObjects.size(); ++i) visibleObjects[i] = i;
+                cullStats = CullStats();
+                cullStats.visible = visibleObjects.size();
             }
+            for (size_t g = 0; g < instanceGroups.size(); ++g)
+                groupVisible[g] = !frustumCulling || frustum.intersects(instanceGroups[g].worldBounds);
+
+            if (batchedScene) {
+                std::vector<bool> objectVisible(models.size(), false);
+                for (uint32_t i : visibleObjects) objectVisible[i] = true;
+                for (size_t i = 0; i < models.size(); ++i) sceneBatch.setVisible(i, objectVisible[i]);
+                for (size_t g = 0; g < instanceGroups.size(); ++g) sceneBatch.setVisible(models.size() + g, groupVisible[g]);
+            }
+        }
 
-            // Constrói matriz modelo com transformação (translação, rotação, escala)
-            glm::mat4 modelMatrix = glm::mat4(1.0f);
-            modelMatrix = glm::translate(modelMatrix, traj.currentPos + position);
-            modelMatrix = glm::rotate(modelMatrix, objectRotations[i].x, glm::vec3(1,0,0));
-            modelMatrix = glm::rotate(modelMatrix, objectRotations[i].y, glm::vec3(0,1,0));
-            modelMatrix = glm::rotate(modelMatrix, objectRotations[i].z, glm::vec3(0,0,1));
-            modelMatrix = glm::scale(modelMatrix, glm::vec3(objectScales[i]));
-            glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMatrix)));
+        // Streaming de texturas: os objetos visíveis maiores na tela recebem seus mipmaps primeiro
+        if (!textureStreamer.idle()) {
+            PROFILE_SCOPE("textureStreaming");
+            float fovY = glm::radians(camera.Zoom);
+            for (uint32_t i : visibleObjects)
+                textureStreamer.request(models[i].textureID, projectedPixels(worldSpheres[i].center, worldSpheres[i].radius, camera.Position, fovY));
+            for (size_t g = 0; g < instanceGroups.size(); ++g) {
+                const InstanceGroup& group = instanceGroups[g];
+                if (!groupVisible[g] || group.transforms.empty()) continue;
+                // Cópia mais próxima: ponto da caixa do grupo mais perto da câmera, com o raio de uma cópia
+                glm::vec3 nearest = glm::clamp(camera.Position, group.worldBounds.min, group.worldBounds.max);
+                float radius = group.model.sphere.radius * glm::length(glm::vec3(group.transforms[0][0]));
+                textureStreamer.request(group.model.textureID, projectedPixels(nearest, radius, camera.Position, fovY));
+            }
+            // Sem janela espera as fences em vez de adiar: a sequência de mipmaps por frame é sempre a mesma
+            textureStreamer.update(headless.enabled);
+            if (batchAvailable)
+                for (GLuint texture : textureStreamer.improved()) sceneBatch.refreshTexture(texture);
+            if (textureStreamer.idle()) {
+                const TextureStreamStats& stream = textureStreamer.stats();
+                std::cout << "Streaming de texturas concluído no frame " << frameIndex << " (" << elapsedMs(programStart)
+                          << " ms após o início): " << stream.streamedBytes / 1024 << " KB em " << stream.chunks
+                          << " faixas, " << stream.tailBytes / 1024 << " KB de cauda na carga, " << stream.busyFrames
+                          << " frames com o anel de PBOs ocupado\n";
+            }
+        }
+
+        // Nível de detalhe pelo erro projetado: o erro de cada LOD (em unidades do modelo) vezes os pixels
+        // por unidade no ponto mais próximo do objeto; com a tecla L em "desligado" tudo volta ao LOD 0
+        {
+            PROFILE_SCOPE("lodSelection");
+            float fovY = glm::radians(camera.Zoom);
+            int fadeFrames = lodMode == 0 ? LOD_FADE_FRAMES : 0;
+            for (uint32_t i : visibleObjects) {
+                const Model& model = models[i];
+                int selected = 0;
+                if (lodMode != 2 && model.sphere.radius > 0.0f) {
+                    float scale = worldSpheres[i].radius / model.sphere.radius;
+                    float pixels = pixelsPerUnit(worldSpheres[i].center, worldSpheres[i].radius, camera.Position, fovY) * scale;
+                    selected = selectLod(model.lods, objectLods[i].current, pixels);
+                }
+                updateLod(objectLods[i], selected, fadeFrames);
+            }
 
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(modelMatrix));
-            glUniformMatrix3fv(normalLoc, 1, GL_FALSE, glm::value_ptr(normalMatrix));
+            // Cópias: a ordem do buffer só muda quando alguma cópia troca de nível
+            for (size_t g = 0; g < instanceGroups.size(); ++g) {
+                InstanceGroup& group = instanceGroups[g];
+                if (!groupVisible[g] || group.model.lods.size() < 2) continue;
+                const Model& model = group.model;
+                bool changed = false;
+                for (size_t k = 0; k < group.transforms.size(); ++k) {
+                    const glm::mat4& transform = group.transforms[k];
+                    int selected = 0;
+                    if (lodMode != 2) {
+                        float scale = glm::length(glm::vec3(transform[0]));
+                        glm::vec3 center = glm::vec3(transform * glm::vec4(model.sphere.center, 1.0f));
+                        float pixels = pixelsPerUnit(center, model.sphere.radius * scale, camera.Position, fovY) * scale;
+                        selected = selectLod(model.lods, group.copyLods[k].current, pixels);
+                    }
+                    changed |= selected != group.copyLods[k].current;
+                    updateLod(group.copyLods[k], selected, 0);
+                }
+                if (!changed) continue;
+                std::fill(group.lodFirst.begin(), group.lodFirst.end(), 0);
+                for (const LodState& lod : group.copyLods) ++group.lodFirst[lod.current + 1];
+                for (size_t l = 1; l < group.lodFirst.size(); ++l) group.lodFirst[l] += group.lodFirst[l - 1];
+                std::vector<size_t> fill(group.lodFirst.begin(), group.lodFirst.end() - 1);
+                for (size_t k = 0; k < group.transforms.size(); ++k)
+                    group.lodOrder[fill[group.copyLods[k].current]++] = group.transforms[k];
+                group.buffer.update(group.lodOrder);
+            }
+        }
 
-            glUniform3fv(glGetUniformLocation(shaderID, "ka"), 1, glm::value_ptr(model.ka));
-            glUniform3fv(glGetUniformLocation(shaderID, "kd"), 1, glm::value_ptr(model.kd));
-            glUniform3fv(glGetUniformLocation(shaderID, "ks"), 1, glm::value_ptr(model.ks));
-            glUniform1f(glGetUniformLocation(shaderID, "shininess"), model.shininess);
+        // Fila de desenho: objetos visíveis e grupos instanciados ordenados pelo estado que precisam e,
+        // dentro do mesmo estado, da frente para trás (distância ao ponto mais próximo do volume)
+        if (!batchedScene) {
+            PROFILE_SCOPE("renderQueue");
+            renderQueue.clear();
+            float depthScale = 1.0f / (cameraFar - cameraNear);
+            for (uint32_t i : visibleObjects) {
+                float distance = glm::length(worldSpheres[i].center - camera.Position) - worldSpheres[i].radius;
+                renderQueue.push(models[i].sortKey | RenderQueue::depthKey((distance - cameraNear) * depthScale), i);
+            }
+            for (size_t g = 0; g < instanceGroups.size(); ++g) {
+                const InstanceGroup& group = instanceGroups[g];
+                if (!groupVisible[g]) continue;
+                glm::vec3 nearest = glm::clamp(camera.Position, group.worldBounds.min, group.worldBounds.max);
+                float distance = glm::length(nearest - camera.Position);
+                renderQueue.push(group.model.sortKey | RenderQueue::depthKey((distance - cameraNear) * depthScale), (uint32_t)(models.size() + g));
+            }
+            if (sortedDraws) renderQueue.sort();
+        }
 
+        // Renderiza a fila: o cache de estado só chama o GL quando textura, VAO, material ou a variante
+        // instanciada mudam de um draw para o seguinte (o streaming de texturas acima mexe nos binds)
+        {
+            PROFILE_GPU_SCOPE("draw objects");
+            glState.invalidate();
             glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_2D, model.textureID);
-            glBindVertexArray(model.VAO);
+            for (const RenderQueue::Item& item : renderQueue.items()) {
+                if (batchedScene) break;
+                bool instanced = item.index >= models.size();
+                InstanceGroup* group = instanced ? &instanceGroups[item.index - models.size()] : nullptr;
+                const Model& model = instanced ? group->model : models[item.index];
+
+                if (glState.set(GLStateCache::Instancing, instanced ? 1 : 0)) glUniform1i(useInstancingLoc, instanced ? 1 : 0);
+                sendMaterial(model.materialIndex, model.ka, model.kd, model.ks, model.shininess);
+                glState.bindTexture(model.textureID);
+                if (glState.bindVertexArray(model.VAO)) {
+                    glUniform3fv(positionOffsetLoc, 1, glm::value_ptr(model.positionOffset));
+                    glUniform3fv(positionScaleLoc, 1, glm::value_ptr(model.positionScale));
+                }
+
+                // Grupos instanciados: uma chamada por nível de detalhe usado pelas cópias
+                if (instanced) {
+                    if (model.lods.size() < 2) {
+                        glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)model.indexCount, model.indexType, nullptr, (GLsizei)group->buffer.count());
+                        statsTriangles += model.indexCount / 3 * group->buffer.count();
+                        continue;
+                    }
+                    for (size_t l = 0; l + 1 < group->lodFirst.size(); ++l) {
+                        size_t copies = group->lodFirst[l + 1] - group->lodFirst[l];
+                        if (copies == 0) continue;
+                        group->buffer.setFirstInstance(group->lodFirst[l]);
+                        drawLod(model, (int)l, (GLsizei)copies);
+                        statsTriangles += model.lods[l].indexCount / 3 * copies;
+                    }
+                    continue;
+                }
+
+                uint32_t i = item.index;
+                glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(sceneGraph.world(i)));
+                glUniformMatrix3fv(normalLoc, 1, GL_FALSE, glm::value_ptr(sceneGraph.normal(i)));
+
+                // Durante o cross-fade os dois níveis dividem os pixels pelo pontilhado
+                const LodState& lod = objectLods[i];
+                if (lod.previous >= 0) {
+                    glUniform1f(lodFadeLoc, lod.fade);
+                    drawLod(model, lod.current);
+                    glUniform1f(lodFadeLoc, -lod.fade);
+                    drawLod(model, lod.previous);
+                    glUniform1f(lodFadeLoc, 0.0f);
+                    statsTriangles += model.lods[lod.previous].indexCount / 3;
+                } else {
+                    drawLod(model, lod.current);
+                }
+                statsTriangles += model.lods[lod.current].indexCount / 3;
+
+                // Destaca objeto selecionado com wireframe vermelho; o próximo draw volta ao próprio
+                // material pelo cache de estado
+                if ((int)i == highlightedObject) {
+                    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+                    glLineWidth(2.0f);
+                    sendMaterial(highlightMaterial, glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(0.0f), 1.0f);
+                    drawLod(model, lod.current);
+                    glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+                }
+            }
+            if (glState.set(GLStateCache::Instancing, 0)) glUniform1i(useInstancingLoc, 0);
+            statsStateChanges += glState.issued();
+            statsStateSkipped += glState.skipped();
+            glState.resetCounters();
+        }
 
-            glDrawArrays(GL_TRIANGLES, 0, model.vertexCount);
+        // Cena inteira em uma única chamada; o destaque redesenha só o comando do objeto selecionado
+        if (batchedScene) {
+            PROFILE_GPU_SCOPE("draw batch");
+            batchShader.use();
+            glUniformMatrix4fv(batchViewLoc, 1, GL_FALSE, glm::value_ptr(view));
+            glUniformMatrix4fv(batchProjLoc, 1, GL_FALSE, glm::value_ptr(projection));
+            glUniform3fv(batchViewPosLoc, 1, glm::value_ptr(camera.Position));
+            sceneBatch.draw();
 
-            // Destaca objeto selecionado com wireframe vermelho 
-            if (i == highlightedObject) {
+            if (highlightedObject >= 0 && highlightedObject < (int)models.size()) {
                 glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
                 glLineWidth(2.0f);
-                glUniform3fv(glGetUniformLocation(shaderID, "ka"), 1, glm::value_ptr(glm::vec3(1.0f, 0.0f, 0.0f)));
-                glUniform3fv(glGetUniformLocation(shaderID, "kd"), 1, glm::value_ptr(glm::vec3(1.0f, 0.0f, 0.0f)));
-                glUniform3fv(glGetUniformLocation(shaderID, "ks"), 1, glm::value_ptr(glm::vec3(0.0f)));
-                glUniform1f(glGetUniformLocation(shaderID, "shininess"), 1.0f);
-                glDrawArrays(GL_TRIANGLES, 0, model.vertexCount);
+                glUniform1i(batchOverrideLoc, highlightMaterial);
+                sceneBatch.drawCommand(highlightedObject);
+                glUniform1i(batchOverrideLoc, -1);
                 glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-
-                // Restaurar material original
-                glUniform3fv(glGetUniformLocation(shaderID, "ka"), 1, glm::value_ptr(model.ka));
-                glUniform3fv(glGetUniformLocation(shaderID, "kd"), 1, glm::value_ptr(model.kd));
-                glUniform3fv(glGetUniformLocation(shaderID, "ks"), 1, glm::value_ptr(model.ks));
-                glUniform1f(glGetUniformLocation(shaderID, "shininess"), model.shininess);
             }
-        }   
+            shader.use();
+        }
+
+        statsSubmitMs += elapsedMs(submitStart);
+        if (++statsFrames == statsInterval) {
+            std::cout << renderPathName(statsPath)
+                      << "frame " << statsFrameMs / std::max(statsIntervals, 1) << " ms, submissão "
+                      << statsSubmitMs / statsFrames << " ms (média de " << statsFrames << " frames), "
+                      << cullStats.visible << " objetos visíveis, " << cullStats.culled << " descartados"
+                      << (frustumCulling ? "" : " (culling desligado)");
+            if (!batchedScene)
+                std::cout << ", " << statsTriangles / statsFrames / 1000 << " mil triângulos por frame, "
+                          << statsStateSkipped / statsFrames << " trocas de estado evitadas por frame ("
+                          << statsStateChanges / statsFrames << " feitas" << (sortedDraws ? "" : ", fila sem ordenação") << ")";
+            std::cout << ", " << (double)statsTransforms / statsFrames << " matrizes refeitas por frame";
+            if (!pointLights.empty())
+                std::cout << ", " << statsClusterLights / statsFrames << " de " << pointLights.size() << " luzes no frustum ("
+                          << statsClusterEntries / statsFrames << " entradas nos clusters, " << statsClusterMs / statsFrames << " ms)";
+            std::cout << "\n";
+            statsFrames = statsIntervals = 0;
+            statsFrameMs = statsSubmitMs = statsClusterMs = 0.0;
+            statsTriangles = statsTransforms = statsStateChanges = statsStateSkipped = 0;
+            statsClusterLights = statsClusterEntries = 0;
+        }
 
         glBindVertexArray(0);
-        glfwSwapBuffers(window);
+        if (headless.enabled) {
+            frameTimings.endFrame();
+            if (!headless.outputDir.empty()) {
+                PROFILE_SCOPE("writePng");
+                char name[32];
+                std::snprintf(name, sizeof(name), "frame_%04d.png", frameIndex);
+                std::string framePath = (std::filesystem::path(headless.outputDir) / name).string();
+                if (!offscreen.writePng(framePath)) std::cerr << "Erro ao gravar " << framePath << "\n";
+            }
+        } else {
+            PROFILE_SCOPE("swap");
+            glfwSwapBuffers(window);
+        }
+        if (frameIndex == 0)
+            std::cout << "Primeiro frame: " << elapsedMs(programStart) << " ms após o início\n";
+        ++frameIndex;
+
+        PROFILE_FRAME();
+        if (traceToggleRequested) {
+            traceToggleRequested = false;
+            if (PROFILE_RECORDING())
+                PROFILE_END_SESSION();
+            else if (PROFILER_ENABLED)
+                PROFILE_BEGIN_SESSION(traceSessionPath(headless.tracePrefix, ++traceSession));
+            else
+                std::cout << "Profiler indisponível neste build (Release)\n";
+        }
+    }
 
+    if (headless.enabled) {
+        frameTimings.finish();
+        frameTimings.report(std::cout);
+        if (!headless.timingsPath.empty() && !frameTimings.writeCsv(headless.timingsPath))
+            std::cerr << "Erro ao gravar " << headless.timingsPath << "\n";
+        frameTimings.release();
+        offscreen.release();
     }
 
-    glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBO);
+    simulation.stop();
+    PROFILE_END_SESSION();
+    PROFILE_RELEASE();
+    sceneBatch.release();
+    lightBuffer.release();
+    materials.release();
+    textureStreamer.release();
+    instanceGroups.clear();
     glfwTerminate();
     return 0;
 }
 
-// Carrega um modelo .obj com TinyObjLoader, extrai vértices, normais, texturas, materiais e cria VAO/VBO
-Model loadModel(const std::string& objPath) {
-    tinyobj::attrib_t attrib;
-    std::vector<tinyobj::shape_t> shapes;
-    std::vector<tinyobj::material_t> materials;
-    std::string warn, err;
-
-    std::filesystem::path baseDir = std::filesystem::path(objPath).parent_path();
-    bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, objPath.c_str(), baseDir.string().c_str());
-
-    if (!ret) throw std::runtime_error(err);
-
-    std::vector<Vertex> vertices;
-
-    for (const auto& shape : shapes) {
-        for (const auto& idx : shape.mesh.indices) {
-            Vertex v;
-            v.pos = {
-                attrib.vertices[3 * idx.vertex_index + 0],
-                attrib.vertices[3 * idx.vertex_index + 1],
-                attrib.vertices[3 * idx.vertex_index + 2]
-            };
-            v.color = { 1.0f, 1.0f, 1.0f };
-            v.tex = (idx.texcoord_index >= 0) ?
-                glm::vec2(
-                    attrib.texcoords[2 * idx.texcoord_index + 0],
-                    attrib.texcoords[2 * idx.texcoord_index + 1]
-                ) : glm::vec2(0.0f);
-
-            v.normal = (idx.normal_index >= 0) ?
-                glm::vec3(
-                    attrib.normals[3 * idx.normal_index + 0],
-                    attrib.normals[3 * idx.normal_index + 1],
-                    attrib.normals[3 * idx.normal_index + 2]
-                ) : glm::vec3(0.0f, 0.0f, 1.0f);
-            vertices.push_back(v);
-        }
-    }
-
-    vertexCount = vertices.size();
-
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tex));
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-    glEnableVertexAttribArray(3);
-    glBindVertexArray(0);
-
-    if (!materials.empty()) {
-        auto& mat = materials[0];
-        ka = glm::make_vec3(mat.ambient);
-        kd = glm::make_vec3(mat.diffuse);
-        ks = glm::make_vec3(mat.specular);
+// Envia para a GPU um modelo já processado pelas threads de carregamento (malha, textura e material)
+Model uploadModel(PendingAsset& asset) {
+    PROFILE_SCOPE("uploadModel");
+    if (!asset.error.empty()) throw std::runtime_error(asset.error);
+
+    // Volumes envolventes calculados uma vez, antes de liberar os vértices da CPU
+    const Vertex* vertices = asset.cache ? asset.cache->vertices() : asset.mesh.vertices.data();
+    size_t count = asset.cache ? asset.cache->vertexCount() : asset.mesh.vertices.size();
+    AABB bounds;
+    BoundingSphere sphere;
+    if (count > 0) {
+        bounds = computeBounds(&vertices->pos, count, sizeof(Vertex));
+        sphere = computeSphere(bounds, &vertices->pos, count, sizeof(Vertex));
+    }
+
+    // Os LODs vão no mesmo EBO, depois dos índices da malha completa; os vértices vão no formato
+    // convertido pelas threads de carregamento, quando não é o completo
+    GpuMesh gpu;
+    bool packed = asset.packed.format != VertexFormat::Full;
+    if (asset.cache) {
+        if (packed)
+            gpu = uploadPackedMesh(asset.packed, asset.cache->indices(), asset.cache->totalIndexCount(), asset.cache->indexType());
+        else
+            gpu = uploadMeshBuffers(asset.cache->vertices(), asset.cache->vertexCount(), asset.cache->indices(), asset.cache->totalIndexCount(), asset.cache->indexType());
+        gpu.indexCount = asset.cache->indexCount();
+        asset.cache.reset();
+    } else {
+        gpu = packed ? uploadPackedMesh(asset.packed, asset.mesh, asset.lods.indices) : uploadMesh(asset.mesh, asset.lods.indices);
+        asset.mesh = MeshData();
+    }
+    asset.packed.data = std::vector<uint8_t>();
+    asset.packed.mapped = nullptr;
+    const MeshMaterial& mat = asset.material;
+    if (mat.present) {
+        ka = mat.ka;
+        kd = mat.kd;
+        ks = mat.ks;
         shininess = mat.shininess;
+    }
 
-        if (!mat.diffuse_texname.empty()) {
-            std::string texPath = (baseDir / mat.diffuse_texname).string();
-            int w, h, channels;
-            stbi_set_flip_vertically_on_load(true);
-            unsigned char* data = stbi_load(texPath.c_str(), &w, &h, &channels, STBI_rgb_alpha);
-            if (data) {
-                glGenTextures(1, &textureID);
-                glBindTexture(GL_TEXTURE_2D, textureID);
-                glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-                glGenerateMipmap(GL_TEXTURE_2D);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-                glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-                stbi_image_free(data);
-            } else {
-                std::cerr << "Erro ao carregar textura: " << texPath << "\n";
-            }
-        }
+    // Texturas compartilhadas vêm do cache (que fica com o .ktx2 mapeado, ou o entrega ao streamer);
+    // modelos sem textura usam a textura branca padrão
+    GLuint textureID;
+    if (!asset.texPath.empty()) {
+        bool decoded = asset.image->texture != nullptr;
+        textureID = textureCache.acquire(asset.texPath, std::move(asset.image->texture));
+        if (!decoded && textureID == textureCache.fallback())
+            std::cerr << "Erro ao carregar textura: " << asset.texPath << "\n";
+    } else {
+        textureID = textureCache.fallback();
     }
 
     Model model;
-    model.VAO = VAO;
-    model.VBO = VBO;
+    model.VAO = gpu.VAO;
+    model.VBO = gpu.VBO;
+    model.EBO = gpu.EBO;
     model.textureID = textureID;
-    model.vertexCount = vertexCount;
+    model.vertexCount = gpu.vertexCount;
+    model.indexCount = gpu.indexCount;
+    model.indexType = gpu.indexType;
     model.ka = ka;
     model.kd = kd;
     model.ks = ks;
     model.shininess = shininess;
+    model.bounds = bounds;
+    model.sphere = sphere;
+    model.pickBvh = asset.pickBvh;
+    model.vertexFormat = gpu.format;
+    model.positionOffset = gpu.positionOffset;
+    model.positionScale = gpu.positionScale;
+    model.lods = asset.lods.levels;
+    if (model.lods.empty()) {
+        model.lods.resize(1);
+        model.lods[0].indexCount = static_cast<uint32_t>(model.indexCount);
+    }
     return model;
 }
 
-// Lê um arquivo .txt de configuração e carrega objetos, câmera e luz
-void loadSceneConfig(const std::string& path) {
-    std::ifstream file(path);
-    if (!file.is_open()) {
-        std::cerr << "Erro ao abrir arquivo de configuração: " << path << "\n";
-        return;
+std::string modelPath(const std::string& name) {
+    return std::string("../assets/Modelos3d/") + name;
+}
+
+std::string trajectoryPath(const std::string& name) {
+    return std::string("../Trajectories/") + name;
+}
+
+// Espalha as cópias com posição e giro em Y aleatórios (semente fixa: a cena é sempre a mesma)
+std::vector<glm::mat4> scatterInstances(const SceneInstancesConfig& config) {
+    std::mt19937 rng(config.seed);
+    std::uniform_real_distribution<float> offsetX(-0.5f * config.width, 0.5f * config.width);
+    std::uniform_real_distribution<float> offsetZ(-0.5f * config.depth, 0.5f * config.depth);
+    std::uniform_real_distribution<float> yaw(0.0f, glm::two_pi<float>());
+    std::vector<glm::mat4> transforms;
+    transforms.reserve(config.count);
+    for (size_t i = 0; i < config.count; ++i) {
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f), config.center + glm::vec3(offsetX(rng), 0.0f, offsetZ(rng)));
+        transform = glm::rotate(transform, yaw(rng), glm::vec3(0, 1, 0));
+        transform = glm::scale(transform, glm::vec3(config.scale));
+        transforms.push_back(transform);
     }
+    return transforms;
+}
 
-    std::string line;
-    while (std::getline(file, line)) {
-        if (line.empty() || line[0] == '#') continue;
+void placeInstances(InstanceGroup& group) {
+    group.buffer.update(group.transforms);
+    group.worldBounds = AABB();
+    for (const auto& transform : group.transforms)
+        group.worldBounds.expand(transformBounds(group.model.bounds, transform));
+}
 
-        std::istringstream iss(line);
-        std::string keyword;
-        iss >> keyword;
+// Aplica a configuração sobre a cena viva. Objetos e grupos casam com os anteriores pelo .obj
+// (matchSceneModels) e ficam com a malha que já está na GPU; só os modelos novos, ou cujo .obj está em
+// changedFiles, passam pelas threads de carregamento, e os que saíram da cena são liberados.
+// Na carga inicial a cena anterior é vazia e tudo é carregado.
+SceneReload applySceneConfig(const SceneConfig& config, const std::set<std::string>& changedFiles) {
+    PROFILE_SCOPE("applySceneConfig");
+    const SceneConfig& previous = sceneConfig;
+    SceneReload reload;
+
+    std::vector<std::string> previousObjects, nextObjects, previousGroups, nextGroups;
+    for (const auto& object : previous.objects)
+        previousObjects.push_back(changedFiles.count(modelPath(object.model)) ? std::string() : object.model);
+    for (const auto& object : config.objects) nextObjects.push_back(object.model);
+    for (const auto& group : previous.instances)
+        previousGroups.push_back(changedFiles.count(modelPath(group.model)) ? std::string() : group.model);
+    for (const auto& group : config.instances) nextGroups.push_back(group.model);
+    reload.previousObject = matchSceneModels(previousObjects, nextObjects);
+    std::vector<int> groupMatch = matchSceneModels(previousGroups, nextGroups);
+
+    // Cargas na ordem do arquivo: objetos e depois grupos (o material "herdado" por modelos sem .mtl
+    // depende dessa ordem)
+    std::vector<std::string> objPaths;
+    std::vector<int> loadGroup;     // grupo instanciado de cada carga, -1 para objetos comuns
+    std::vector<size_t> loadSlot;   // posição do objeto ou do grupo na cena nova
+    for (size_t i = 0; i < config.objects.size(); ++i) {
+        if (reload.previousObject[i] >= 0) continue;
+        objPaths.push_back(modelPath(config.objects[i].model));
+        loadGroup.push_back(-1);
+        loadSlot.push_back(i);
+    }
+    for (size_t g = 0; g < config.instances.size(); ++g) {
+        if (groupMatch[g] >= 0) continue;
+        objPaths.push_back(modelPath(config.instances[g].model));
+        loadGroup.push_back((int)g);
+        loadSlot.push_back(g);
+    }
 
-        if (keyword == "camera") {
-            iss >> cameraStartPosition.x >> cameraStartPosition.y >> cameraStartPosition.z >> cameraYaw >> cameraPitch 
-            >> cameraNear >> cameraFar;
-        } else if (keyword == "light") {
-            iss >> lightPosition.x >> lightPosition.y >> lightPosition.z;
-        } else if (keyword == "object") {
-            std::string objName, trajFile;
-            glm::vec3 pos, rot;
-            float scale;
-            iss >> objName >> pos.x >> pos.y >> pos.z >> rot.x >> rot.y >> rot.z >> scale >> trajFile;
+    // Um .obj que não existe derrubaria o carregamento no meio: a cena fica como estava
+    for (const auto& path : objPaths) {
+        if (!std::filesystem::exists(path)) {
+            std::cerr << "Modelo não encontrado: " << path << " (configuração não aplicada)\n";
+            reload.failed = true;
+            return reload;
+        }
+    }
 
-            models.push_back(loadModel(std::string("../assets/Modelos3d/") += objName));
-            objectPositions.push_back(pos);
-            objectRotations.push_back(rot);
-            objectScales.push_back(scale);
-            loadTrajectoriesFromTxt(std::string("../Trajectories/") += trajFile);
+    // Malha e referência à textura de um modelo que sai da GPU
+    auto releaseModel = [](const Model& model) {
+        glDeleteVertexArrays(1, &model.VAO);
+        glDeleteBuffers(1, &model.VBO);
+        glDeleteBuffers(1, &model.EBO);
+        textureCache.release(model.textureID);
+    };
+
+    // Malhas reaproveitadas; os grupos que continuam só saem da cena atual depois que a carga deu certo
+    std::vector<Model> nextModels(config.objects.size());
+    std::vector<InstanceGroup> nextInstanceGroups(config.instances.size());
+    std::vector<bool> objectKept(models.size(), false), groupKept(instanceGroups.size(), false);
+    for (size_t i = 0; i < config.objects.size(); ++i) {
+        int j = reload.previousObject[i];
+        if (j < 0) continue;
+        nextModels[i] = models[j];
+        objectKept[j] = true;
+        reload.modelsChanged |= j != (int)i;
+        ++reload.reused;
+    }
+    for (size_t g = 0; g < config.instances.size(); ++g)
+        if (groupMatch[g] < 0) nextInstanceGroups[g].transforms = scatterInstances(config.instances[g]);
+
+    // Um .obj malformado ou salvo pela metade também não aplica a configuração: o que já foi enviado à
+    // GPU nesta carga é liberado e a cena fica como estava
+    if (!objPaths.empty()) {
+        try {
+            loadSceneModels(objPaths, loadGroup, loadSlot, nextModels, nextInstanceGroups);
+        } catch (const std::exception& e) {
+            std::cerr << e.what() << " (configuração não aplicada)\n";
+            for (size_t k = 0; k < objPaths.size(); ++k) {
+                const Model& model = loadGroup[k] < 0 ? nextModels[loadSlot[k]] : nextInstanceGroups[loadSlot[k]].model;
+                if (model.VAO != 0) releaseModel(model);
+            }
+            reload.failed = true;
+            return reload;
+        }
+    }
+    reload.loaded = objPaths.size();
+
+    // Grupos com outra linha "instances" só refazem as transformações
+    for (size_t g = 0; g < config.instances.size(); ++g) {
+        int j = groupMatch[g];
+        if (j < 0) continue;
+        nextInstanceGroups[g] = std::move(instanceGroups[j]);
+        groupKept[j] = true;
+        reload.modelsChanged |= j != (int)g;
+        ++reload.reused;
+        if (!(previous.instances[j] == config.instances[g])) {
+            nextInstanceGroups[g].transforms = scatterInstances(config.instances[g]);
+            placeInstances(nextInstanceGroups[g]);
+            reload.modelsChanged = true;
         }
     }
 
-    file.close();
+    // Só depois da carga: uma textura compartilhada com um modelo novo não sai da GPU e volta
+    for (size_t j = 0; j < models.size(); ++j) {
+        if (objectKept[j]) continue;
+        releaseModel(models[j]);
+        ++reload.released;
+    }
+    for (size_t j = 0; j < instanceGroups.size(); ++j) {
+        if (groupKept[j]) continue;
+        releaseModel(instanceGroups[j].model);
+        ++reload.released;
+    }
+    reload.modelsChanged |= reload.loaded > 0 || reload.released > 0;
+    models = std::move(nextModels);
+    instanceGroups = std::move(nextInstanceGroups);
+
+    // Transformações, hierarquia e trajetórias vêm da configuração. A rotação e a escala editadas pelo
+    // teclado sobrevivem enquanto a linha do objeto não as muda; o mover continua de onde estava se a
+    // posição inicial e o caminho são os mesmos. O grafo é refeito inteiro (todos os nós sujos).
+    size_t count = config.objects.size();
+    SceneGraph graph;
+    std::vector<glm::vec3> positions(count);
+    std::vector<TrajectoryPath> paths(count);
+    reload.previousMover.assign(count, -1);
+    for (size_t i = 0; i < count; ++i) {
+        const SceneObjectConfig& object = config.objects[i];
+        if (object.parent >= (int)i)
+            std::cerr << "Objeto " << i << ": pai " << object.parent << " precisa vir antes na configuração (ignorado)\n";
+        uint32_t node = graph.add(object.parent >= 0 && object.parent < (int)i ? (uint32_t)object.parent : SceneGraph::NO_PARENT);
+        positions[i] = object.position;
+        graph.setTranslation(node, object.position);
+        graph.setRotation(node, object.rotation);
+        graph.setScale(node, object.scale);
+        if (!object.trajectory.empty()) paths[i] = loadTrajectoriesFromTxt(trajectoryPath(object.trajectory), i);
+
+        int j = reload.previousObject[i];
+        if (j < 0) continue;
+        const SceneObjectConfig& before = previous.objects[j];
+        if (before.rotation == object.rotation) graph.setRotation(node, sceneGraph.rotation((uint32_t)j));
+        if (before.scale == object.scale) graph.setScale(node, sceneGraph.scale((uint32_t)j));
+        if (before.position == object.position && objectPaths[j] == paths[i]) reload.previousMover[i] = j;
+    }
+    sceneGraph = std::move(graph);
+    objectPositions = std::move(positions);
+    objectPaths = std::move(paths);
+
+    reload.cameraChanged = !previous.sameCamera(config);
+    cameraStartPosition = config.cameraPosition;
+    cameraYaw = config.cameraYaw;
+    cameraPitch = config.cameraPitch;
+    cameraNear = config.cameraNear;
+    cameraFar = config.cameraFar;
+    lightPosition = config.light;
+    pointLights.clear();
+    for (const SceneLightConfig& light : scenePointLights(config))
+        pointLights.push_back({ glm::vec4(light.position, light.radius), glm::vec4(light.color, 0.0f) });
+    simulationRate = config.simulationRate > 0.0 ? config.simulationRate : Simulation::DEFAULT_RATE;
+
+    sceneConfig = config;
+    return reload;
+}
+
+// Processa os modelos em paralelo; o upload acontece aqui, na thread do OpenGL, na ordem das cargas.
+// Cada modelo vai para targetModels[loadSlot] ou, nos grupos, para targetGroups[loadGroup].
+void loadSceneModels(const std::vector<std::string>& objPaths, const std::vector<int>& loadGroup, const std::vector<size_t>& loadSlot,
+                     std::vector<Model>& targetModels, std::vector<InstanceGroup>& targetGroups) {
+    PROFILE_SCOPE("loadSceneModels");
+    auto start = std::chrono::steady_clock::now();
+    std::vector<PendingAsset> arrived(objPaths.size());
+    std::vector<bool> isReady(objPaths.size(), false);
+    std::vector<double> uploadMs(objPaths.size(), 0.0);
+    std::vector<double> parseMs(objPaths.size(), 0.0), lodMs(objPaths.size(), 0.0), decodeMs(objPaths.size(), 0.0), bvhMs(objPaths.size(), 0.0);
+    std::vector<size_t> lodLevels(objPaths.size(), 1);
+    std::vector<size_t> vertexCounts(objPaths.size(), 0);
+    std::vector<double> packMs(objPaths.size(), 0.0);
+    std::vector<VertexPackError> packErrors(objPaths.size());
+    std::vector<MeshOptReport> optimizeReports(objPaths.size());
+    std::vector<double> optimizeMs(objPaths.size(), 0.0);
+    size_t nextUpload = 0;
+
+    // Só os objetos selecionáveis precisam da BVH de triângulos; os grupos instanciados não
+    std::vector<bool> pickable(objPaths.size());
+    for (size_t i = 0; i < objPaths.size(); ++i) pickable[i] = loadGroup[i] < 0;
+    AssetLoader loader(objPaths, pickable, vertexFormat);
+    PendingAsset asset;
+    while (loader.next(asset)) {
+        size_t index = asset.index;
+        parseMs[index] = asset.parseMs;
+        lodMs[index] = asset.lodMs;
+        optimizeMs[index] = asset.optimizeMs;
+        optimizeReports[index] = asset.optimize;
+        lodLevels[index] = std::max<size_t>(asset.lods.levels.size(), 1);
+        vertexCounts[index] = asset.packed.count;
+        packMs[index] = asset.packMs;
+        packErrors[index] = asset.packed.error;
+        decodeMs[index] = asset.decodeMs;
+        bvhMs[index] = asset.bvhMs;
+        arrived[index] = std::move(asset);
+        isReady[index] = true;
+
+        while (nextUpload < objPaths.size() && isReady[nextUpload]) {
+            auto uploadStart = std::chrono::steady_clock::now();
+            Model model = uploadModel(arrived[nextUpload]);
+            if (loadGroup[nextUpload] < 0) {
+                targetModels[loadSlot[nextUpload]] = model;
+            } else {
+                InstanceGroup& group = targetGroups[loadSlot[nextUpload]];
+                group.model = model;
+                group.buffer.attach(model.VAO);
+                placeInstances(group);
+            }
+            uploadMs[nextUpload] = elapsedMs(uploadStart);
+            arrived[nextUpload] = PendingAsset();
+            ++nextUpload;
+        }
+    }
+
+    // Relatório de tempos por modelo
+    std::cout << "Carregamento da cena (" << loader.threadCount() << " threads):\n";
+    for (size_t i = 0; i < objPaths.size(); ++i) {
+        std::cout << "  " << std::filesystem::path(objPaths[i]).filename().string()
+                  << ": parse " << parseMs[i] << " ms, ordem " << optimizeMs[i] << " ms, LODs " << lodMs[i] << " ms (" << lodLevels[i] << " níveis), vértices "
+                  << packMs[i] << " ms, BVH " << bvhMs[i] << " ms, textura " << decodeMs[i]
+                  << " ms, upload " << uploadMs[i] << " ms\n";
+    }
+    std::cout << "  total: " << elapsedMs(start) << " ms\n";
+
+    // Cache de vértices: ACMR/ATVR do LOD 0 (antes e depois quando a ordem foi gerada agora)
+    std::cout << "Cache de vértices (FIFO de " << VERTEX_CACHE_SIZE << "):\n";
+    for (size_t i = 0; i < objPaths.size(); ++i) {
+        const MeshOptReport& report = optimizeReports[i];
+        std::cout << "  " << std::filesystem::path(objPaths[i]).filename().string() << ": ACMR ";
+        if (report.optimized) std::cout << report.before.acmr << " -> ";
+        std::cout << report.after.acmr << ", ATVR ";
+        if (report.optimized) std::cout << report.before.atvr << " -> ";
+        std::cout << report.after.atvr << (report.optimized ? "" : " (do .meshbin)") << "\n";
+    }
+
+    // Formato dos vértices: memória na GPU e precisão perdida em cada malha
+    size_t totalVertices = 0;
+    for (size_t count : vertexCounts) totalVertices += count;
+    std::cout << "Vértices: formato " << vertexFormatName(vertexFormat) << ", " << totalVertices * vertexStride(vertexFormat) / 1024
+              << " KB na GPU (" << totalVertices * sizeof(Vertex) / 1024 << " KB no formato completo)\n";
+    if (vertexFormat != VertexFormat::Full) {
+        for (size_t i = 0; i < objPaths.size(); ++i) {
+            const VertexPackError& error = packErrors[i];
+            std::cout << "  " << std::filesystem::path(objPaths[i]).filename().string() << ": erro máximo de posição "
+                      << error.position << " (" << error.positionRelative * 100.0f << "% da diagonal), normal "
+                      << error.normalDegrees << "°, uv " << error.tex << "\n";
+        }
+    }
+    if (!targetGroups.empty()) {
+        size_t copies = 0;
+        for (const auto& group : targetGroups) copies += group.transforms.size();
+        std::cout << "Instâncias: " << copies << " cópias em " << targetGroups.size() << " chamadas de desenho\n";
+    }
+    std::cout << "Texturas: " << textureCache.hits() << " hits, " << textureCache.misses() << " misses, "
+              << textureCache.textureCount() << " na GPU, " << textureCache.bytesResident() / 1024 << " KB";
+    if (!textureStreamer.idle())
+        std::cout << " (" << textureStreamer.pendingCount() << " com mipmaps em streaming, "
+                  << textureStreamer.stats().tailBytes / 1024 << " KB já enviados)";
+    std::cout << "\n";
 }
 
 // Trata eventos de teclado, incluindo transformação de objetos selecionados
@@ -462,9 +1382,48 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     // Alterna pausa da animação com barra de espaço
     if (key == GLFW_KEY_SPACE && action == GLFW_PRESS) {
         isPaused = !isPaused;
+        simulation.setPaused(isPaused);
         std::cout << (isPaused ? "Animação pausada.\n" : "Animação retomada.\n");
     }
 
+    // Alterna entre o UBO de materiais e o envio antigo por nome (comparação de tempo de frame)
+    if (key == GLFW_KEY_M && action == GLFW_PRESS) {
+        legacyUniforms = !legacyUniforms;
+        std::cout << (legacyUniforms ? "Materiais: uniformes por nome.\n" : "Materiais: UBO indexado.\n");
+    }
+
+    // Encerra a sessão do profiler (grava o trace) ou inicia uma nova
+    if (key == GLFW_KEY_P && action == GLFW_PRESS)
+        traceToggleRequested = true;
+
+    // Liga/desliga o frustum culling
+    if (key == GLFW_KEY_F && action == GLFW_PRESS) {
+        frustumCulling = !frustumCulling;
+        std::cout << (frustumCulling ? "Frustum culling ligado.\n" : "Frustum culling desligado.\n");
+    }
+
+    // Fila de desenho ordenada por estado ou na ordem em que os objetos saem do culling
+    if (key == GLFW_KEY_O && action == GLFW_PRESS) {
+        sortedDraws = !sortedDraws;
+        std::cout << (sortedDraws ? "Fila de desenho ordenada por estado.\n" : "Fila de desenho sem ordenação.\n");
+    }
+
+    // Alterna entre o desenho por objeto e a cena em lote (multi-draw indireto)
+    if (key == GLFW_KEY_B && action == GLFW_PRESS) {
+        if (!batchAvailable) {
+            std::cout << "Multi-draw indireto indisponível neste driver.\n";
+        } else {
+            batchedScene = !batchedScene;
+            std::cout << (batchedScene ? "Cena em lote: um glMultiDrawElementsIndirect.\n" : "Cena por objeto.\n");
+        }
+    }
+
+    // Troca de nível de detalhe: com cross-fade, direta ou desligada
+    if (key == GLFW_KEY_L && action == GLFW_PRESS) {
+        lodMode = (lodMode + 1) % 3;
+        std::cout << "LOD: " << lodModeNames[lodMode] << ".\n";
+    }
+
     // Imprime posição e orientação da câmera
     if (key == GLFW_KEY_C && action == GLFW_PRESS) {
     glm::vec3 pos = camera.Position;
@@ -473,24 +1432,29 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     }
    
     // Transformações de objeto selecionado
-    if (selectedObject != -1) {
+    if (selectedObject < sceneGraph.size()) {
         float step = 0.05f;
         float angleStep = glm::radians(5.0f);
         float scaleStep = 0.05f;
 
         // Rotação
+        uint32_t node = (uint32_t)selectedObject;
+        glm::vec3 rotation = sceneGraph.rotation(node);
         if (glfwGetKey(window, GLFW_KEY_X) == GLFW_PRESS)
-            objectRotations[selectedObject].x += angleStep;
+            rotation.x += angleStep;
         if (glfwGetKey(window, GLFW_KEY_Y) == GLFW_PRESS)
-            objectRotations[selectedObject].y += angleStep;
+            rotation.y += angleStep;
         if (glfwGetKey(window, GLFW_KEY_Z) == GLFW_PRESS)
-            objectRotations[selectedObject].z += angleStep;
+            rotation.z += angleStep;
+        sceneGraph.setRotation(node, rotation);
 
         // Escala
+        float objectScale = sceneGraph.scale(node);
         if (glfwGetKey(window, GLFW_KEY_LEFT_BRACKET) == GLFW_PRESS)
-            objectScales[selectedObject] -= scaleStep;
+            objectScale -= scaleStep;
         if (glfwGetKey(window, GLFW_KEY_RIGHT_BRACKET) == GLFW_PRESS)
-            objectScales[selectedObject] += scaleStep;
+            objectScale += scaleStep;
+        sceneGraph.setScale(node, objectScale);
         }
 
 }
@@ -516,21 +1480,37 @@ void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods) {
     if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
         glm::mat4 view = camera.GetViewMatrix();
-        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)WIDTH / HEIGHT, 0.1f, 100.0f);
-        glm::vec3 rayDir = calculateRayDirection(projection, view);
+        glm::mat4 projection = glm::perspective(glm::radians(camera.Zoom), (float)WIDTH / HEIGHT, cameraNear, cameraFar);
+
+        // Com o cursor capturado a mira é o centro da tela; com o cursor livre, a posição dele
+        glm::vec2 ndc(0.0f);
+        if (glfwGetInputMode(window, GLFW_CURSOR) != GLFW_CURSOR_DISABLED) {
+            double xpos, ypos;
+            int width, height;
+            glfwGetCursorPos(window, &xpos, &ypos);
+            glfwGetWindowSize(window, &width, &height);
+            if (width > 0 && height > 0)
+                ndc = glm::vec2(2.0f * (float)xpos / width - 1.0f, 1.0f - 2.0f * (float)ypos / height);
+        }
+        glm::vec3 rayDir = calculateRayDirection(projection, view, ndc);
         glm::vec3 rayOrigin = camera.Position;
 
-        int hit = intersectedObjectIndex(rayOrigin, rayDir);
+        auto pickStart = std::chrono::steady_clock::now();
+        RayHit rayHit;
+        int hit = intersectedObjectIndex(rayOrigin, rayDir, rayHit);
+        double pickMs = elapsedMs(pickStart);
         if (hit != -1) {
-    if (selectedObject == hit) {
-        selectedObject = -1;
-        highlightedObject = -1;
-    } else {
-        selectedObject = hit;
-        highlightedObject = hit;
-        std::cout << "Objeto " << hit << " selecionado com o mouse.\n";
-    }
-}
+            if (selectedObject == (size_t)hit) {
+                selectedObject = -1;
+                highlightedObject = -1;
+            } else {
+                selectedObject = hit;
+                highlightedObject = hit;
+                std::cout << "Objeto " << hit << " selecionado com o mouse (triângulo " << rayHit.triangle
+                          << ", distância " << rayHit.t << ", baricêntricas " << rayHit.u << " " << rayHit.v
+                          << ", " << pickMs << " ms).\n";
+            }
+        }
     }
 }
 
@@ -539,90 +1519,41 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset) {
     camera.ProcessMouseScroll(yoffset);
 }
 
-// Lê um arquivo de trajetória com uma lista de pontos de controle para cada objeto
-void loadTrajectoriesFromTxt(const std::string& path) {
-    std::ifstream file(path);
-    if (!file.is_open()) {
+// Lê um arquivo de trajetória (seções "# Objeto N") e devolve o caminho do objeto
+TrajectoryPath loadTrajectoriesFromTxt(const std::string& path, size_t objectIndex) {
+    bool ok = false;
+    std::vector<TrajectoryPath> sections = loadTrajectoryFile(path, ok);
+    if (!ok) {
         std::cerr << "Erro ao abrir " << path << " para leitura.\n";
-        return;
+        return {};
     }
 
-    std::string line;
-    size_t currentObject = 0;
-    trajectories.clear();
-    trajectories.resize(4); 
-
-    while (std::getline(file, line)) {
-        if (line.empty() || line[0] == '#') continue;
-        float x, y, z;
-        if (sscanf(line.c_str(), "%f %f %f", &x, &y, &z) == 3) {
-            trajectories[currentObject].controlPoints.emplace_back(x, y, z);
-        }
-    }
-    file.close();
-
     std::cout << "Trajetórias carregadas de " << path << "\n";
+    return objectIndex < sections.size() ? sections[objectIndex] : TrajectoryPath();
 }
 
-// Calcula a direção de um raio projetado da tela para o mundo 3D
-glm::vec3 calculateRayDirection(const glm::mat4& projection, const glm::mat4& view) {
-    glm::vec2 ndc = glm::vec2(0.0f); 
-    glm::vec4 clipCoords = glm::vec4(ndc, -1.0f, 1.0f);
-    glm::vec4 eyeCoords = glm::inverse(projection) * clipCoords;
-    eyeCoords = glm::vec4(eyeCoords.x, eyeCoords.y, -1.0f, 0.0f);
-    glm::vec3 worldRay = glm::normalize(glm::vec3(glm::inverse(view) * eyeCoords));
-    return worldRay;
+// Calcula a direção de um raio projetado da tela para o mundo 3D: desprojeta o ponto (ndc)
+// nos planos near e far com a mesma projeção usada no desenho
+glm::vec3 calculateRayDirection(const glm::mat4& projection, const glm::mat4& view, const glm::vec2& ndc) {
+    glm::mat4 inverseViewProjection = glm::inverse(projection * view);
+    glm::vec4 nearPoint = inverseViewProjection * glm::vec4(ndc, -1.0f, 1.0f);
+    glm::vec4 farPoint = inverseViewProjection * glm::vec4(ndc, 1.0f, 1.0f);
+    return glm::normalize(glm::vec3(farPoint) / farPoint.w - glm::vec3(nearPoint) / nearPoint.w);
 }
 
-// Verifica qual bounding box (AABB) foi intersectada por um raio
-int intersectedObjectIndex(const glm::vec3& rayOrigin, const glm::vec3& rayDir) {
-    for (size_t i = 0; i < trajectories.size(); ++i) {
-        glm::vec3 center = trajectories[i].currentPos + position;
-        float halfSize = scale * 0.5f;
-
-        glm::vec3 minBox = center - glm::vec3(halfSize);
-        glm::vec3 maxBox = center + glm::vec3(halfSize);
-
-        // AABB ray-box intersection 
-        float tmin = (minBox.x - rayOrigin.x) / rayDir.x;
-        float tmax = (maxBox.x - rayOrigin.x) / rayDir.x;
-        if (tmin > tmax) std::swap(tmin, tmax);
-
-        float tymin = (minBox.y - rayOrigin.y) / rayDir.y;
-        float tymax = (maxBox.y - rayOrigin.y) / rayDir.y;
-        if (tymin > tymax) std::swap(tymin, tymax);
-
-        if ((tmin > tymax) || (tymin > tmax)) continue;
-
-        tmin = std::max(tmin, tymin);
-        tmax = std::min(tmax, tymax);
-
-        float tzmin = (minBox.z - rayOrigin.z) / rayDir.z;
-        float tzmax = (maxBox.z - rayOrigin.z) / rayDir.z;
-        if (tzmin > tzmax) std::swap(tzmin, tzmax);
-
-        if ((tmin > tzmax) || (tzmin > tmax)) continue;
-
-        return (int)i;
+// Objeto cujo triângulo mais próximo é atingido pelo raio (-1 se nenhum).
+// O raio vai para o espaço de objeto de cada modelo sem renormalizar a direção, então a distância t
+// de cada BVH fica na mesma escala do raio de mundo e o acerto mais próximo entre objetos é direto.
+int intersectedObjectIndex(const glm::vec3& rayOrigin, const glm::vec3& rayDir, RayHit& hit) {
+    int nearest = -1;
+    hit = RayHit();
+    for (size_t i = 0; i < models.size() && i < sceneGraph.size(); ++i) {
+        if (!models[i].pickBvh) continue;
+        glm::mat4 toObject = glm::inverse(sceneGraph.world((uint32_t)i));
+        glm::vec3 origin = glm::vec3(toObject * glm::vec4(rayOrigin, 1.0f));
+        glm::vec3 dir = glm::vec3(toObject * glm::vec4(rayDir, 0.0f));
+        if (models[i].pickBvh->intersect(origin, dir, hit))
+            nearest = (int)i;
     }
-    return -1;
+    return nearest;
 }
-
-int setupShader() {
-    GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(vertexShader, 1, &vertexShaderSource, NULL);
-    glCompileShader(vertexShader);
-
-    GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(fragmentShader, 1, &fragmentShaderSource, NULL);
-    glCompileShader(fragmentShader);
-
-    GLuint shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, vertexShader);
-    glAttachShader(shaderProgram, fragmentShader);
-    glLinkProgram(shaderProgram);
-
-    glDeleteShader(vertexShader);
-    glDeleteShader(fragmentShader);
-    return shaderProgram;
-}
\ No newline at end of file
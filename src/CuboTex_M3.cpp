@@ -3,6 +3,8 @@
 #include "stb_image.h"
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "tiny_obj_loader.h"
+#include "mesh.h"
+#include "instancing.h"
 
 // ==== INCLUDES PADRÕES ====
 #include <iostream>
@@ -15,15 +17,10 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-// ==== STRUCT PARA ARMAZENAR UM VÉRTICE ====
-struct Vertex {
-    glm::vec3 pos, color;
-    glm::vec2 tex;
-};
-
 struct Model {
-    GLuint VAO, VBO, textureID;
-    size_t vertexCount;
+    GLuint VAO, VBO, EBO, textureID;
+    size_t vertexCount, indexCount;
+    GLenum indexType;
     glm::vec3 ka, kd, ks;
     float shininess;
 };
@@ -32,7 +29,7 @@ struct Model {
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
 int setupShader();
 Model loadModel(const std::string& path);
-void draw(GLuint shaderID, GLint modelLoc, float angle, const std::vector<glm::vec3>& cubePositions, const Model& model);
+void draw(float angle, const std::vector<glm::vec3>& positions, const Model& model, InstanceBuffer& instances);
 
 // ==== CONSTANTES GLOBAIS ====
 const GLuint WIDTH = 1000, HEIGHT = 1000;
@@ -52,14 +49,13 @@ const GLchar* vertexShaderSource = R"(
     layout(location = 0) in vec3 position;
     layout(location = 1) in vec3 color;
     layout(location = 2) in vec2 texCoord;
+    layout(location = 4) in mat4 instanceModel;  // matriz modelo de cada cópia (divisor 1)
 
     out vec4 finalColor;
     out vec2 TexCoord;
 
-    uniform mat4 model;
-
     void main() {
-        gl_Position = model * vec4(position, 1.0);
+        gl_Position = instanceModel * vec4(position, 1.0);
         finalColor = vec4(color, 1.0);
         TexCoord = texCoord;
     }
@@ -91,53 +87,12 @@ Model loadModel(const std::string& objPath) {
     bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, objPath.c_str(), baseDir.string().c_str());
     if (!ret) throw std::runtime_error(err);
 
-    std::vector<Vertex> vertices;
-
-    // Itera sobre os índices do modelo
-    for (const auto& shape : shapes) {
-        for (const auto& idx : shape.mesh.indices) {
-            Vertex v;
-            v.pos = {
-                attrib.vertices[3 * idx.vertex_index + 0],
-                attrib.vertices[3 * idx.vertex_index + 1],
-                attrib.vertices[3 * idx.vertex_index + 2]
-            };
-            v.color = { 1.0f, 1.0f, 1.0f }; 
-
-            if (idx.texcoord_index >= 0) {
-                v.tex = {
-                    attrib.texcoords[2 * idx.texcoord_index + 0],
-                    attrib.texcoords[2 * idx.texcoord_index + 1]
-                };
-            } else {
-                v.tex = { 0.0f, 0.0f }; 
-            }
-
-            vertices.push_back(v);
-        }
-    }
-
-    vertexCount = vertices.size();
-
-    // Criação de VAO e VBO
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
-
-    // Layout dos atributos
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0); // posição
-    glEnableVertexAttribArray(0);
-
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color)); // cor
-    glEnableVertexAttribArray(1);
-
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tex)); // textura
-    glEnableVertexAttribArray(2);
-
-    glBindVertexArray(0);
+    // Deduplica vértices compartilhados e envia VBO/EBO indexados
+    MeshData mesh = buildIndexedMesh(attrib, shapes);
+    GpuMesh gpu = uploadMesh(mesh);
+    VAO = gpu.VAO;
+    VBO = gpu.VBO;
+    vertexCount = gpu.vertexCount;
 
     // Carrega textura associada (se houver)
     if (!materials.empty() && !materials[0].diffuse_texname.empty()) {
@@ -166,8 +121,11 @@ Model loadModel(const std::string& objPath) {
     Model model;
     model.VAO = VAO;
     model.VBO = VBO;
+    model.EBO = gpu.EBO;
     model.textureID = textureID;
     model.vertexCount = vertexCount;
+    model.indexCount = gpu.indexCount;
+    model.indexType = gpu.indexType;
     model.ka = ka;
     model.kd = kd;
     model.ks = ks;
@@ -193,7 +151,11 @@ int main() {
 
     // Vincula textura ao slot 0
     glUniform1i(glGetUniformLocation(shaderID, "texture1"), 0);
-    GLint modelLoc = glGetUniformLocation(shaderID, "model");
+
+    // Um VBO de instâncias por malha: todas as cópias saem em uma única chamada de desenho
+    InstanceBuffer cubeInstances, pkInstances;
+    cubeInstances.attach(cubeModel.VAO, false);
+    pkInstances.attach(pkModel.VAO, false);
 
     // Posições na cena
     std::vector<glm::vec3> cubePositions = {
@@ -215,8 +177,8 @@ int main() {
         float angle = (float)glfwGetTime();
         glActiveTexture(GL_TEXTURE0);
         
-        draw(shaderID, modelLoc, angle, cubePositions, cubeModel);
-        draw(shaderID, modelLoc, angle, pkPositions, pkModel);
+        draw(angle, cubePositions, cubeModel, cubeInstances);
+        draw(angle, pkPositions, pkModel, pkInstances);
 
         glfwSwapBuffers(window);
     }
@@ -224,6 +186,8 @@ int main() {
     // Liberação de recursos
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
+    cubeInstances.release();
+    pkInstances.release();
     glfwTerminate();
     return 0;
 }
@@ -264,23 +228,27 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 }
 
 // === FUNÇÃO DE DESENHO COM TRANSFORMAÇÃO ===
-void draw(GLuint shaderID, GLint modelLoc, float angle, const std::vector<glm::vec3>& positions, const Model& model) {
-    glBindTexture(GL_TEXTURE_2D, model.textureID);
-    glBindVertexArray(model.VAO);
+void draw(float angle, const std::vector<glm::vec3>& positions, const Model& model, InstanceBuffer& instances) {
+    std::vector<glm::mat4> modelMats;
+    modelMats.reserve(positions.size());
 
     for (const auto& basePos : positions) {
-        glm::mat4 model = glm::mat4(1.0f);
-        model = glm::scale(model, glm::vec3(scale));
+        glm::mat4 modelMat = glm::mat4(1.0f);
+        modelMat = glm::scale(modelMat, glm::vec3(scale));
 
-        if (rotateX) model = glm::rotate(glm::mat4(1.0f), angle, glm::vec3(1, 0, 0)) * model;
-        if (rotateY) model = glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0, 1, 0)) * model;
-        if (rotateZ) model = glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0, 0, 1)) * model;
+        if (rotateX) modelMat = glm::rotate(glm::mat4(1.0f), angle, glm::vec3(1, 0, 0)) * modelMat;
+        if (rotateY) modelMat = glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0, 1, 0)) * modelMat;
+        if (rotateZ) modelMat = glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0, 0, 1)) * modelMat;
 
-        model = glm::translate(model, basePos + position);
-        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-        glDrawArrays(GL_TRIANGLES, 0, vertexCount);
+        modelMat = glm::translate(modelMat, basePos + position);
+        modelMats.push_back(modelMat);
     }
 
+    // Uma única chamada desenha todas as cópias
+    instances.update(modelMats);
+    glBindTexture(GL_TEXTURE_2D, model.textureID);
+    glBindVertexArray(model.VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)model.indexCount, model.indexType, nullptr, (GLsizei)instances.count());
     glBindVertexArray(0);
 }
 
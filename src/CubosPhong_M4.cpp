@@ -3,6 +3,8 @@
 #include "stb_image.h"
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "tiny_obj_loader.h"
+#include "mesh.h"
+#include "instancing.h"
 
 // ==== INCLUDES PADRÕES ====
 #include <iostream>
@@ -15,15 +17,10 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-// ==== STRUCT PARA ARMAZENAR UM VÉRTICE ====
-struct Vertex {
-    glm::vec3 pos, color, normal;
-    glm::vec2 tex;
-};
-
 struct Model {
-    GLuint VAO, VBO, textureID;
-    size_t vertexCount;
+    GLuint VAO, VBO, EBO, textureID;
+    size_t vertexCount, indexCount;
+    GLenum indexType;
     glm::vec3 ka, kd, ks;
     float shininess;
 };
@@ -32,7 +29,7 @@ struct Model {
 void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
 int setupShader();
 Model loadModel(const std::string& path);
-void draw(GLuint shaderID, GLint modelLoc, GLint normalLoc, float angle, const std::vector<glm::vec3>& cubePositions, const Model& model);
+void draw(GLuint shaderID, float angle, const std::vector<glm::vec3>& positions, const Model& model, InstanceBuffer& instances);
 
 // ==== CONSTANTES GLOBAIS ====
 const GLuint WIDTH = 1000, HEIGHT = 1000;
@@ -53,21 +50,20 @@ layout(location = 0) in vec3 position;
 layout(location = 1) in vec3 color;
 layout(location = 2) in vec2 texCoord;
 layout(location = 3) in vec3 normal;
+layout(location = 4) in mat4 instanceModel;   // matriz modelo de cada cópia (divisor 1)
+layout(location = 8) in mat3 instanceNormal;  // matriz normal correspondente
 
 out vec3 FragPos;
 out vec3 Normal;
 out vec4 finalColor;
 out vec2 TexCoord;
 
-uniform mat4 model;
-uniform mat3 normalMatrix;
-
 void main() {
-    FragPos = vec3(model * vec4(position, 1.0));
-    Normal = normalize(normalMatrix * normal);
+    FragPos = vec3(instanceModel * vec4(position, 1.0));
+    Normal = normalize(instanceNormal * normal);
     TexCoord = texCoord;
     finalColor = vec4(color, 1.0);
-    gl_Position = model * vec4(position, 1.0);
+    gl_Position = instanceModel * vec4(position, 1.0);
 }
 )";
 
@@ -116,51 +112,12 @@ Model loadModel(const std::string& objPath) {
     bool ret = tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, objPath.c_str(), baseDir.string().c_str());
     if (!ret) throw std::runtime_error(err);
 
-    std::vector<Vertex> vertices;
-
-    // Itera sobre os índices do modelo
-    for (const auto& shape : shapes) {
-        for (const auto& idx : shape.mesh.indices) {
-            Vertex v;
-            v.pos = {
-                attrib.vertices[3 * idx.vertex_index + 0],
-                attrib.vertices[3 * idx.vertex_index + 1],
-                attrib.vertices[3 * idx.vertex_index + 2]
-            };
-            v.color = { 1.0f, 1.0f, 1.0f };
-            v.tex = (idx.texcoord_index >= 0) ?
-                glm::vec2(
-                    attrib.texcoords[2 * idx.texcoord_index + 0],
-                    attrib.texcoords[2 * idx.texcoord_index + 1]
-                ) : glm::vec2(0.0f);
-
-            v.normal = (idx.normal_index >= 0) ?
-                glm::vec3(
-                    attrib.normals[3 * idx.normal_index + 0],
-                    attrib.normals[3 * idx.normal_index + 1],
-                    attrib.normals[3 * idx.normal_index + 2]
-                ) : glm::vec3(0.0f, 0.0f, 1.0f);
-            vertices.push_back(v);
-        }
-    }
-
-    vertexCount = vertices.size();
-
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tex));
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-    glEnableVertexAttribArray(3);
-    glBindVertexArray(0);
+    // Deduplica vértices compartilhados e envia VBO/EBO indexados
+    MeshData mesh = buildIndexedMesh(attrib, shapes);
+    GpuMesh gpu = uploadMesh(mesh);
+    VAO = gpu.VAO;
+    VBO = gpu.VBO;
+    vertexCount = gpu.vertexCount;
 
     // Carrega textura associada (se houver)
     if (!materials.empty()) {
@@ -194,8 +151,11 @@ Model loadModel(const std::string& objPath) {
     Model model;
     model.VAO = VAO;
     model.VBO = VBO;
+    model.EBO = gpu.EBO;
     model.textureID = textureID;
     model.vertexCount = vertexCount;
+    model.indexCount = gpu.indexCount;
+    model.indexType = gpu.indexType;
     model.ka = ka;
     model.kd = kd;
     model.ks = ks;
@@ -218,8 +178,11 @@ int main() {
     glEnable(GL_DEPTH_TEST);
     glUseProgram(shaderID);
     glUniform1i(glGetUniformLocation(shaderID, "texture1"), 0);
-    GLint modelLoc = glGetUniformLocation(shaderID, "model");
-    GLint normalLoc = glGetUniformLocation(shaderID, "normalMatrix");
+
+    // Um VBO de instâncias por malha: todas as cópias saem em uma única chamada de desenho
+    InstanceBuffer cubeInstances, pkInstances;
+    cubeInstances.attach(cubeModel.VAO);
+    pkInstances.attach(pkModel.VAO);
 
     glUniform3f(glGetUniformLocation(shaderID, "lightPos"), 5.0f, 5.0f, 5.0f);
     glUniform3f(glGetUniformLocation(shaderID, "viewPos"), 0.0f, 0.0f, 10.0f);
@@ -243,14 +206,16 @@ int main() {
         float angle = (float)glfwGetTime();
         glActiveTexture(GL_TEXTURE0);
         
-        draw(shaderID, modelLoc, normalLoc, angle, cubePositions, cubeModel);
-        draw(shaderID, modelLoc, normalLoc, angle, pkPositions, pkModel);
+        draw(shaderID, angle, cubePositions, cubeModel, cubeInstances);
+        draw(shaderID, angle, pkPositions, pkModel, pkInstances);
 
         glfwSwapBuffers(window);
     }
 
     glDeleteVertexArrays(1, &VAO);
     glDeleteBuffers(1, &VBO);
+    cubeInstances.release();
+    pkInstances.release();
     glfwTerminate();
     return 0;
 }
@@ -291,9 +256,9 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
 }
 
 // === FUNÇÃO DE DESENHO COM TRANSFORMAÇÃO ===
-void draw(GLuint shaderID, GLint modelLoc, GLint normalLoc, float angle, const std::vector<glm::vec3>& positions, const Model& model) {
-    glBindTexture(GL_TEXTURE_2D, model.textureID);
-    glBindVertexArray(model.VAO);
+void draw(GLuint shaderID, float angle, const std::vector<glm::vec3>& positions, const Model& model, InstanceBuffer& instances) {
+    std::vector<glm::mat4> modelMats;
+    modelMats.reserve(positions.size());
 
     for (const auto& basePos : positions) {
         glm::mat4 modelMat = glm::mat4(1.0f);
@@ -304,18 +269,19 @@ void draw(GLuint shaderID, GLint modelLoc, GLint normalLoc, float angle, const s
         if (rotateZ) modelMat = glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0, 0, 1)) * modelMat;
 
         modelMat = glm::translate(modelMat, basePos + position);
-        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(modelMat)));
-        glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(modelMat));
-        glUniformMatrix3fv(normalLoc, 1, GL_FALSE, glm::value_ptr(normalMatrix));
-
-        glUniform3fv(glGetUniformLocation(shaderID, "ka"), 1, glm::value_ptr(model.ka));
-        glUniform3fv(glGetUniformLocation(shaderID, "kd"), 1, glm::value_ptr(model.kd));
-        glUniform3fv(glGetUniformLocation(shaderID, "ks"), 1, glm::value_ptr(model.ks));
-        glUniform1f(glGetUniformLocation(shaderID, "shininess"), model.shininess);
-
-        glDrawArrays(GL_TRIANGLES, 0, model.vertexCount);
+        modelMats.push_back(modelMat);
     }
 
+    // Matrizes (e normais) de todas as cópias no VBO de instâncias; material enviado uma vez por malha
+    instances.update(modelMats);
+    glUniform3fv(glGetUniformLocation(shaderID, "ka"), 1, glm::value_ptr(model.ka));
+    glUniform3fv(glGetUniformLocation(shaderID, "kd"), 1, glm::value_ptr(model.kd));
+    glUniform3fv(glGetUniformLocation(shaderID, "ks"), 1, glm::value_ptr(model.ks));
+    glUniform1f(glGetUniformLocation(shaderID, "shininess"), model.shininess);
+
+    glBindTexture(GL_TEXTURE_2D, model.textureID);
+    glBindVertexArray(model.VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, (GLsizei)model.indexCount, model.indexType, nullptr, (GLsizei)instances.count());
     glBindVertexArray(0);
 }
 
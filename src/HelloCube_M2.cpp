@@ -9,6 +9,7 @@
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include "instancing.h"
 
 // ==== CONSTANTES GLOBAIS ====
 const GLuint WIDTH = 1000, HEIGHT = 1000;
@@ -26,13 +27,12 @@ const GLchar* vertexShaderSource = R"glsl(
     #version 450
     layout (location = 0) in vec3 position;
     layout (location = 1) in vec3 color;
-
-    uniform mat4 model;
+    layout (location = 4) in mat4 instanceModel;  // matriz modelo de cada cubo (divisor 1)
 
     out vec4 finalColor;
 
     void main() {
-        gl_Position = model * vec4(position, 1.0);
+        gl_Position = instanceModel * vec4(position, 1.0);
         finalColor = vec4(color, 1.0);
     }
 )glsl";
@@ -63,8 +63,6 @@ int main() {
     glEnable(GL_DEPTH_TEST);
     glUseProgram(shaderID);
 
-    GLint modelLoc = glGetUniformLocation(shaderID, "model");
-
     // Posições iniciais dos cubos
     std::vector<glm::vec3> cubePositions = {
         glm::vec3(0.0f),
@@ -73,6 +71,11 @@ int main() {
         glm::vec3(0.0f, 2.0f, 0.0f)
     };
 
+    // Matrizes de todos os cubos em um VBO de instâncias (sem iluminação: só a matriz modelo)
+    InstanceBuffer instances;
+    instances.attach(VAO, false);
+    std::vector<glm::mat4> instanceModels(cubePositions.size());
+
     // Loop principal
     while (!glfwWindowShouldClose(window)) {
         glfwPollEvents();
@@ -81,9 +84,8 @@ int main() {
 
         float angle = (GLfloat)glfwGetTime();
 
-        glBindVertexArray(VAO);
-
-        for (auto basePos : cubePositions) {
+        for (size_t i = 0; i < cubePositions.size(); ++i) {
+            glm::vec3 basePos = cubePositions[i];
             glm::mat4 model = glm::mat4(1.0f);
 
             // Escala
@@ -97,19 +99,20 @@ int main() {
             // Translação
             model = glm::translate(model, basePos + position);
 
-            // Envia matriz para shader
-            glUniformMatrix4fv(modelLoc, 1, GL_FALSE, glm::value_ptr(model));
-
-            // Desenha cubo 
-            glDrawArrays(GL_TRIANGLES, 0, 36);
+            instanceModels[i] = model;
         }
 
+        // Envia as matrizes e desenha todos os cubos de uma vez
+        instances.update(instanceModels);
+        glBindVertexArray(VAO);
+        glDrawArraysInstanced(GL_TRIANGLES, 0, 36, (GLsizei)instances.count());
         glBindVertexArray(0);
         glfwSwapBuffers(window);
     }
 
     // Liberação de recursos
     glDeleteVertexArrays(1, &VAO);
+    instances.release();
     glfwTerminate();
     return 0;
 }
@@ -200,6 +203,8 @@ int setupGeometry() {
 
     // Geração e configuração de buffers
     GLuint VBO, VAO;
+    glGenVertexArrays(1, &VAO);
+    glBindVertexArray(VAO);
     glGenBuffers(1, &VBO);
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
     glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
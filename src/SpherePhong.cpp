@@ -27,6 +27,9 @@ using namespace std;
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb_image.h>
 
+// Texturas comprimidas (.ktx2)
+#include "texturecache.h"
+
 using namespace glm;
 
 #include <cmath>
@@ -350,42 +353,19 @@ int setupGeometry()
 
 GLuint loadTexture(string filePath, int &width, int &height)
 {
-	GLuint texID; // id da textura a ser carregada
-
-	// Gera o identificador da textura na memória
-	glGenTextures(1, &texID);
-	glBindTexture(GL_TEXTURE_2D, texID);
-
-	// Ajuste dos parâmetros de wrapping e filtering
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-	// Carregamento da imagem usando a função stbi_load da biblioteca stb_image
-	int nrChannels;
-
-	unsigned char *data = stbi_load(filePath.c_str(), &width, &height, &nrChannels, 0);
-
-	if (data)
-	{
-		if (nrChannels == 3) // jpg, bmp
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, data);
-		}
-		else // assume que é 4 canais png
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		}
-		glGenerateMipmap(GL_TEXTURE_2D);
-	}
-	else
+	// Textura pré-processada: o .ktx2 ao lado da imagem (gerado aqui na primeira execução ou pelo texbake)
+	// já traz a cadeia de mipmaps comprimida em BC1/BC3/BC7, enviada com glCompressedTexImage2D
+	TextureAsset texture;
+	if (!loadTextureAsset(filePath, false, texture))
 	{
 		std::cout << "Failed to load texture " << filePath << std::endl;
+		width = height = 0;
+		return 0;
 	}
+	width = texture.width();
+	height = texture.height();
 
-	stbi_image_free(data);
+	GLuint texID = createTexture(texture.view);
 
 	glBindTexture(GL_TEXTURE_2D, 0);
 
@@ -5,7 +5,10 @@
 #include "stb_image.h"
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "tiny_obj_loader.h"
+#include "mesh.h"
+#include "filewatch.h"
 
+#include <algorithm>
 #include <iostream>
 #include <vector>
 #include <string>
@@ -16,14 +19,10 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
-struct Vertex {
-    glm::vec3 pos, color, normal;
-    glm::vec2 tex;
-};
-
 struct Model {
-    GLuint VAO, VBO, textureID;
-    size_t vertexCount;
+    GLuint VAO, VBO, EBO, textureID;
+    size_t vertexCount, indexCount;
+    GLenum indexType;
     glm::vec3 ka, kd, ks;
     float shininess;
 };
@@ -67,6 +66,8 @@ bool firstMouse = true;
 float fov = 45.0f;
 bool isPaused = false;
 std::vector<Trajectory> trajectories;
+std::string trajectoryFile = "../Trajectories/trajectories.txt";   // argv[1] escolhe outro arquivo
+FileWatcher trajectoryWatcher;   // recarrega o arquivo quando ele é salvo por fora (editor, Cena_Castle)
 size_t selectedObject = 0;
 int highlightedObject = -1; 
 
@@ -130,7 +131,8 @@ void main() {
 
 
 
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 1) trajectoryFile = argv[1];
     glfwInit();
     GLFWwindow* window = glfwCreateWindow(WIDTH, HEIGHT, "Textured Cube - Track", nullptr, nullptr);
     glfwMakeContextCurrent(window);
@@ -177,13 +179,16 @@ int main() {
     }
 
 
-    loadTrajectoriesFromTxt("../Trajectories/trajectories.txt");
+    loadTrajectoriesFromTxt(trajectoryFile);
+    trajectoryWatcher.watch(trajectoryFile);
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
     while (!glfwWindowShouldClose(window)) {
         glfwPollEvents();
+        if (!trajectoryWatcher.changes().empty())
+            loadTrajectoriesFromTxt(trajectoryFile);
         float currentFrame = glfwGetTime();
         deltaTime = currentFrame - lastFrame;
         lastFrame = currentFrame;
@@ -250,7 +255,7 @@ int main() {
             glBindTexture(GL_TEXTURE_2D, model.textureID);
             glBindVertexArray(model.VAO);
 
-            glDrawArrays(GL_TRIANGLES, 0, model.vertexCount);
+            glDrawElements(GL_TRIANGLES, (GLsizei)model.indexCount, model.indexType, nullptr);
 
             // Highlight 
             if (i == highlightedObject) {
@@ -260,7 +265,7 @@ int main() {
                 glUniform3fv(glGetUniformLocation(shaderID, "kd"), 1, glm::value_ptr(glm::vec3(1.0f, 0.0f, 0.0f)));
                 glUniform3fv(glGetUniformLocation(shaderID, "ks"), 1, glm::value_ptr(glm::vec3(0.0f)));
                 glUniform1f(glGetUniformLocation(shaderID, "shininess"), 1.0f);
-                glDrawArrays(GL_TRIANGLES, 0, model.vertexCount);
+                glDrawElements(GL_TRIANGLES, (GLsizei)model.indexCount, model.indexType, nullptr);
                 glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
 
                 // Restaurar material original
@@ -294,50 +299,12 @@ Model loadModel(const std::string& objPath) {
 
     if (!ret) throw std::runtime_error(err);
 
-    std::vector<Vertex> vertices;
-
-    for (const auto& shape : shapes) {
-        for (const auto& idx : shape.mesh.indices) {
-            Vertex v;
-            v.pos = {
-                attrib.vertices[3 * idx.vertex_index + 0],
-                attrib.vertices[3 * idx.vertex_index + 1],
-                attrib.vertices[3 * idx.vertex_index + 2]
-            };
-            v.color = { 1.0f, 1.0f, 1.0f };
-            v.tex = (idx.texcoord_index >= 0) ?
-                glm::vec2(
-                    attrib.texcoords[2 * idx.texcoord_index + 0],
-                    attrib.texcoords[2 * idx.texcoord_index + 1]
-                ) : glm::vec2(0.0f);
-
-            v.normal = (idx.normal_index >= 0) ?
-                glm::vec3(
-                    attrib.normals[3 * idx.normal_index + 0],
-                    attrib.normals[3 * idx.normal_index + 1],
-                    attrib.normals[3 * idx.normal_index + 2]
-                ) : glm::vec3(0.0f, 0.0f, 1.0f);
-            vertices.push_back(v);
-        }
-    }
-
-    vertexCount = vertices.size();
-
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glBindVertexArray(VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * vertices.size(), vertices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, pos));
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, color));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tex));
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-    glEnableVertexAttribArray(3);
-    glBindVertexArray(0);
+    // Deduplica vértices compartilhados e envia VBO/EBO indexados
+    MeshData mesh = buildIndexedMesh(attrib, shapes);
+    GpuMesh gpu = uploadMesh(mesh);
+    VAO = gpu.VAO;
+    VBO = gpu.VBO;
+    vertexCount = gpu.vertexCount;
 
     if (!materials.empty()) {
         auto& mat = materials[0];
@@ -370,8 +337,11 @@ Model loadModel(const std::string& objPath) {
     Model model;
     model.VAO = VAO;
     model.VBO = VBO;
+    model.EBO = gpu.EBO;
     model.textureID = textureID;
     model.vertexCount = vertexCount;
+    model.indexCount = gpu.indexCount;
+    model.indexType = gpu.indexType;
     model.ka = ka;
     model.kd = kd;
     model.ks = ks;
@@ -404,10 +374,13 @@ void key_callback(GLFWwindow* window, int key, int scancode, int action, int mod
     }
 
     if (key == GLFW_KEY_L && action == GLFW_PRESS)
-    loadTrajectoriesFromTxt("../Trajectories/trajectories.txt");
+    loadTrajectoriesFromTxt(trajectoryFile);
 
-    if (key == GLFW_KEY_P && action == GLFW_PRESS)
-    saveTrajectoriesToTxt("../Trajectories/trajectories.txt");
+    // A gravação dispara o observador; descarta o aviso para não recarregar o que acabou de salvar
+    if (key == GLFW_KEY_P && action == GLFW_PRESS) {
+        saveTrajectoriesToTxt(trajectoryFile);
+        trajectoryWatcher.changes();
+    }
 }
 
 void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
@@ -460,23 +433,30 @@ void loadTrajectoriesFromTxt(const std::string& path) {
 
     std::string line;
     size_t currentObject = 0;
-    trajectories.clear();
-    trajectories.resize(4); 
+    std::vector<std::vector<glm::vec3>> points(std::max<size_t>(trajectories.size(), 4));
 
     while (std::getline(file, line)) {
         if (line.empty()) continue;
         if (line[0] == '#') {
             sscanf(line.c_str(), "# Objeto %zu", &currentObject);
-            if (currentObject >= trajectories.size())
-                trajectories.resize(currentObject + 1);
+            if (currentObject >= points.size())
+                points.resize(currentObject + 1);
         } else {
             float x, y, z;
             if (sscanf(line.c_str(), "%f %f %f", &x, &y, &z) == 3) {
-                trajectories[currentObject].controlPoints.emplace_back(x, y, z);
+                points[currentObject].emplace_back(x, y, z);
             }
         }
     }
 
+    // Só os pontos mudam: cada objeto continua de onde está, indo para o alvo de mesmo índice
+    trajectories.resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        Trajectory& traj = trajectories[i];
+        traj.controlPoints = std::move(points[i]);
+        if (traj.currentIndex >= traj.controlPoints.size()) traj.currentIndex = 0;
+    }
+
     std::cout << "Trajetórias carregadas de " << path << "\n";
 }
 
@@ -0,0 +1,128 @@
+// === cullbench: mede o frustum culling (força bruta x BVH) em uma cena sintética ===
+// Uso: cullbench [objetos=10000] [frames=300] [fração que se move=0.25]
+// Não abre janela nem usa OpenGL: só a GLM e os mesmos bounds.h/bvh.h do Cena_Castle.
+
+#include "bounds.h"
+#include "bvh.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    size_t objectCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 10000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 300;
+    float movingFraction = argc > 3 ? (float)std::atof(argv[3]) : 0.25f;
+    if (objectCount == 0 || frames <= 0) {
+        std::cerr << "Uso: cullbench [objetos] [frames] [fração que se move]\n";
+        return 1;
+    }
+
+    // Objetos espalhados em um terreno de 1000 x 1000, com tamanhos entre 0.5 e 4
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> spread(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> height(0.0f, 20.0f);
+    std::uniform_real_distribution<float> size(0.5f, 4.0f);
+    std::uniform_real_distribution<float> step(-0.5f, 0.5f);
+
+    AABB unitBox;
+    unitBox.min = glm::vec3(-0.5f);
+    unitBox.max = glm::vec3(0.5f);
+    BoundingSphere unitSphere;
+    unitSphere.radius = std::sqrt(0.75f);
+
+    std::vector<glm::vec3> positions(objectCount);
+    std::vector<float> scales(objectCount);
+    for (size_t i = 0; i < objectCount; ++i) {
+        positions[i] = glm::vec3(spread(rng), height(rng), spread(rng));
+        scales[i] = size(rng);
+    }
+    size_t movingCount = (size_t)(movingFraction * objectCount);
+
+    std::vector<AABB> worldBounds(objectCount);
+    std::vector<BoundingSphere> worldSpheres(objectCount);
+    auto updateBounds = [&]() {
+        for (size_t i = 0; i < objectCount; ++i) {
+            glm::mat4 model = glm::translate(glm::mat4(1.0f), positions[i]);
+            model = glm::scale(model, glm::vec3(scales[i]));
+            worldBounds[i] = transformBounds(unitBox, model);
+            worldSpheres[i] = transformSphere(unitSphere, model);
+        }
+    };
+    updateBounds();
+
+    glm::mat4 projection = glm::perspective(glm::radians(45.0f), 16.0f / 9.0f, 0.1f, 300.0f);
+
+    ObjectBVH refitted, rebuilt;
+    auto start = std::chrono::steady_clock::now();
+    refitted.build(worldBounds);
+    double buildMs = elapsedMs(start);
+
+    double bruteMs = 0.0, refitMs = 0.0, refitCullMs = 0.0, rebuildMs = 0.0, rebuildCullMs = 0.0;
+    size_t visibleTotal = 0, nodesVisited = 0, mismatches = 0;
+    std::vector<uint32_t> bruteVisible, bvhVisible, rebuiltVisible;
+    bruteVisible.reserve(objectCount);
+
+    for (int frame = 0; frame < frames; ++frame) {
+        // Parte dos objetos anda um pouco (como as trajetórias da cena)
+        for (size_t i = 0; i < movingCount; ++i)
+            positions[i] += glm::vec3(step(rng), 0.0f, step(rng));
+        updateBounds();
+
+        // Câmera girando no centro do terreno
+        float angle = glm::two_pi<float>() * frame / frames;
+        glm::vec3 eye(0.0f, 10.0f, 0.0f);
+        glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(std::cos(angle), -0.1f, std::sin(angle)), glm::vec3(0.0f, 1.0f, 0.0f));
+        Frustum frustum = Frustum::fromMatrix(projection * view);
+
+        start = std::chrono::steady_clock::now();
+        bruteVisible.clear();
+        for (uint32_t i = 0; i < objectCount; ++i) {
+            if (frustum.intersects(worldSpheres[i]) && frustum.intersects(worldBounds[i])) bruteVisible.push_back(i);
+        }
+        bruteMs += elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        refitted.update(worldBounds);
+        refitMs += elapsedMs(start);
+        CullStats stats;
+        start = std::chrono::steady_clock::now();
+        refitted.cull(frustum, worldBounds, &worldSpheres, bvhVisible, stats);
+        refitCullMs += elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        rebuilt.build(worldBounds);
+        rebuildMs += elapsedMs(start);
+        CullStats rebuiltStats;
+        start = std::chrono::steady_clock::now();
+        rebuilt.cull(frustum, worldBounds, &worldSpheres, rebuiltVisible, rebuiltStats);
+        rebuildCullMs += elapsedMs(start);
+
+        if (bvhVisible.size() != bruteVisible.size() || rebuiltVisible.size() != bruteVisible.size()) ++mismatches;
+        visibleTotal += stats.visible;
+        nodesVisited += stats.nodesVisited;
+    }
+
+    std::cout << "Cena sintética: " << objectCount << " objetos, " << movingCount << " em movimento, " << frames << " frames\n";
+    std::cout << "  build inicial da BVH: " << buildMs << " ms (" << refitted.nodeCount() << " nós)\n";
+    std::cout << "  visíveis por frame: " << visibleTotal / frames << " (descartados: " << objectCount - visibleTotal / frames
+              << "), nós visitados: " << nodesVisited / frames << "\n";
+    std::cout << "  força bruta:           " << bruteMs / frames << " ms/frame\n";
+    std::cout << "  BVH refit + culling:   " << refitMs / frames << " + " << refitCullMs / frames << " ms/frame ("
+              << refitted.rebuildCount() - 1 << " reconstruções automáticas)\n";
+    std::cout << "  BVH rebuild + culling: " << rebuildMs / frames << " + " << rebuildCullMs / frames << " ms/frame\n";
+    if (mismatches) {
+        std::cerr << "ERRO: a BVH divergiu da força bruta em " << mismatches << " frames\n";
+        return 1;
+    }
+    return 0;
+}
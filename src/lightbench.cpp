@@ -0,0 +1,106 @@
+// === lightbench: atribuição de luzes pontuais aos clusters do frustum (1 thread x pool), sem janela ===
+// Uso: lightbench [frames=200]
+// Para 100, 1000 e 4000 luzes (tochas espalhadas em um pátio de 200 x 200, raio de 4 a 12), mede o tempo
+// por frame da atribuição com a câmera girando no centro, e confere o resultado: para pontos sorteados
+// no frustum, toda luz cuja esfera contém o ponto tem que estar na lista do cluster dele, e as listas
+// com uma thread e com o pool têm que ser iguais.
+// Sai com código 1 se alguma luz faltar ou se as duas versões divergirem.
+
+#include "lightclusters.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 200;
+    if (frames <= 0) {
+        std::cerr << "Uso: lightbench [frames]\n";
+        return 1;
+    }
+
+    const float fovY = glm::radians(45.0f), aspect = 1920.0f / 1080.0f, zNear = 0.1f, zFar = 100.0f;
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    bool failed = false;
+
+    LightClusters single(1), pooled;
+    single.setProjection(fovY, aspect, zNear, zFar);
+    pooled.setProjection(fovY, aspect, zNear, zFar);
+
+    for (size_t lightCount : { (size_t)100, (size_t)1000, (size_t)4000 }) {
+        std::vector<PointLight> lights(lightCount);
+        for (PointLight& light : lights) {
+            glm::vec3 position((unit(rng) - 0.5f) * 200.0f, unit(rng) * 10.0f, (unit(rng) - 0.5f) * 200.0f);
+            light.positionRadius = glm::vec4(position, 4.0f + 8.0f * unit(rng));
+            light.color = glm::vec4(1.0f, 0.6f, 0.3f, 0.0f);
+        }
+
+        auto viewAt = [&](int f) {
+            float yaw = 6.2831853f * f / frames;
+            glm::vec3 eye(0.0f, 2.0f, 0.0f);
+            return glm::lookAt(eye, eye + glm::vec3(std::cos(yaw), -0.1f, std::sin(yaw)), glm::vec3(0.0f, 1.0f, 0.0f));
+        };
+
+        double ms[2] = {};
+        size_t entries = 0, visible = 0, most = 0;
+        LightClusters* versions[2] = { &single, &pooled };
+        for (int v = 0; v < 2; ++v) {
+            auto start = std::chrono::steady_clock::now();
+            for (int f = 0; f < frames; ++f) versions[v]->assign(lights, viewAt(f));
+            ms[v] = elapsedMs(start) / frames;
+        }
+
+        // Conferência em alguns frames: listas iguais nas duas versões e nenhuma luz faltando
+        size_t missing = 0, checked = 0;
+        bool different = false;
+        for (int f = 0; f < frames; f += std::max(1, frames / 8)) {
+            glm::mat4 view = viewAt(f);
+            single.assign(lights, view);
+            pooled.assign(lights, view);
+            different |= single.clusterRanges() != pooled.clusterRanges() || single.indices() != pooled.indices();
+            entries = pooled.indices().size();
+            visible = pooled.visibleLights();
+            most = std::max(most, pooled.maxLightsPerCluster());
+
+            for (int k = 0; k < 20000; ++k) {
+                // Ponto sorteado no frustum, em espaço de visão
+                float d = zNear + (zFar - zNear) * unit(rng) * unit(rng);
+                glm::vec3 p((unit(rng) * 2.0f - 1.0f) * d * std::tan(0.5f * fovY) * aspect,
+                            (unit(rng) * 2.0f - 1.0f) * d * std::tan(0.5f * fovY), -d);
+                int cluster = pooled.clusterOf(p);
+                if (cluster < 0) continue;
+                glm::uvec2 range = pooled.clusterRanges()[cluster];
+                const uint32_t* first = pooled.indices().data() + range.x;
+                for (uint32_t i = 0; i < lights.size(); ++i) {
+                    glm::vec3 center = glm::vec3(view * glm::vec4(glm::vec3(lights[i].positionRadius), 1.0f));
+                    glm::vec3 delta = p - center;
+                    if (glm::dot(delta, delta) > lights[i].positionRadius.w * lights[i].positionRadius.w) continue;
+                    ++checked;
+                    if (std::find(first, first + range.y, i) == first + range.y) ++missing;
+                }
+            }
+        }
+
+        std::cout << lightCount << " luzes (" << visible << " no frustum, " << entries << " entradas, até " << most
+                  << " por cluster): 1 thread " << ms[0] << " ms/frame, " << pooled.threadCount() << " threads " << ms[1]
+                  << " ms/frame; " << checked << " pares ponto-luz conferidos, " << missing << " faltando\n";
+        if (missing > 0 || different) {
+            std::cerr << "ERRO: " << (different ? "as listas com 1 thread e com o pool divergiram" : "luzes faltando nos clusters") << "\n";
+            failed = true;
+        }
+    }
+
+    if (failed) return 1;
+    return 0;
+}
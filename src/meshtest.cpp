@@ -0,0 +1,155 @@
+// === meshtest: confere a malha indexada (buildIndexedMesh) contra o caminho expandido antigo ===
+// Uso: meshtest [arquivo.obj ...]
+// Para cada .obj (sem arquivo, alguns casos embutidos: cubo com normal por face, grade suave, grade
+// facetada, cantos sem uv/normal, índices negativos e quadriláteros) lê com o TinyObjLoader e monta a
+// malha dos dois jeitos: a expandida, um Vertex por canto de triângulo como o loadModel fazia antes, e a
+// indexada. Confere que:
+//   - há um índice por canto e vertices[indices[k]] é exatamente o canto k da expandida;
+//   - o número de vértices únicos é o de triplas (v, n, t) distintas;
+//   - nenhum vértice da indexada sobra sem ser usado.
+// Não usa janela nem OpenGL; sai com código 1 se algum caso falhar.
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+#include "mesh.h"
+
+#include <cstring>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+struct ObjCase {
+    std::string name;
+    std::string source;
+};
+
+static std::string cubeObj() {
+    return "v -1 -1 -1\nv 1 -1 -1\nv 1 1 -1\nv -1 1 -1\nv -1 -1 1\nv 1 -1 1\nv 1 1 1\nv -1 1 1\n"
+           "vt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\n"
+           "vn 0 0 -1\nvn 0 0 1\nvn -1 0 0\nvn 1 0 0\nvn 0 -1 0\nvn 0 1 0\n"
+           "f 1/1/1 4/4/1 3/3/1\nf 1/1/1 3/3/1 2/2/1\n"
+           "f 5/1/2 6/2/2 7/3/2\nf 5/1/2 7/3/2 8/4/2\n"
+           "f 1/1/3 5/2/3 8/3/3\nf 1/1/3 8/3/3 4/4/3\n"
+           "f 2/1/4 3/4/4 7/3/4\nf 2/1/4 7/3/4 6/2/4\n"
+           "f 1/1/5 2/2/5 6/3/5\nf 1/1/5 6/3/5 5/4/5\n"
+           "f 4/1/6 8/4/6 7/3/6\nf 4/1/6 7/3/6 3/2/6\n";
+}
+
+// Grade side x side; com normal por face cada triângulo tem a sua normal e nenhum canto se repete
+static std::string gridObj(int side, bool faceNormals) {
+    std::ostringstream obj;
+    for (int y = 0; y < side; ++y)
+        for (int x = 0; x < side; ++x)
+            obj << "v " << x << " " << (x * y) % 3 << " " << y << "\nvt " << x / float(side) << " " << y / float(side) << "\n";
+    if (!faceNormals) obj << "vn 0 1 0\n";
+    int normal = 0;
+    for (int y = 0; y + 1 < side; ++y) {
+        for (int x = 0; x + 1 < side; ++x) {
+            int a = y * side + x + 1, b = a + 1, c = a + side, d = c + 1;
+            int tri[2][3] = { { a, b, d }, { a, d, c } };
+            for (auto& t : tri) {
+                if (faceNormals) obj << "vn 0 1 " << (++normal % 5) * 0.1f << "\n";
+                int n = faceNormals ? normal : 1;
+                obj << "f " << t[0] << "/" << t[0] << "/" << n << " " << t[1] << "/" << t[1] << "/" << n << " " << t[2] << "/" << t[2] << "/" << n << "\n";
+            }
+        }
+    }
+    return obj.str();
+}
+
+static bool checkMesh(const std::string& name, const tinyobj::attrib_t& attrib, const std::vector<tinyobj::shape_t>& shapes) {
+    // Caminho antigo: um vértice por canto, na ordem dos shapes
+    std::vector<Vertex> expanded;
+    std::set<std::tuple<int, int, int>> triples;
+    for (const auto& shape : shapes) {
+        for (const auto& idx : shape.mesh.indices) {
+            expanded.push_back(makeVertex(attrib, idx));
+            triples.insert(std::make_tuple(idx.vertex_index, idx.normal_index, idx.texcoord_index));
+        }
+    }
+
+    MeshData mesh = buildIndexedMesh(attrib, shapes);
+    std::string why;
+    if (mesh.indices.size() != expanded.size()) {
+        why = std::to_string(mesh.indices.size()) + " índices para " + std::to_string(expanded.size()) + " cantos";
+    } else if (mesh.vertices.size() != triples.size()) {
+        why = std::to_string(mesh.vertices.size()) + " vértices únicos para " + std::to_string(triples.size()) + " triplas distintas";
+    } else {
+        std::vector<bool> used(mesh.vertices.size(), false);
+        for (size_t k = 0; k < expanded.size() && why.empty(); ++k) {
+            uint32_t index = mesh.indices[k];
+            if (index >= mesh.vertices.size()) {
+                why = "índice " + std::to_string(index) + " fora da malha no canto " + std::to_string(k);
+                break;
+            }
+            used[index] = true;
+            // Mesmo makeVertex nos dois caminhos: os bytes têm que ser idênticos
+            if (std::memcmp(&mesh.vertices[index], &expanded[k], sizeof(Vertex)) != 0)
+                why = "canto " + std::to_string(k) + " (triângulo " + std::to_string(k / 3) + ") difere do caminho expandido";
+        }
+        for (size_t i = 0; i < used.size() && why.empty(); ++i)
+            if (!used[i]) why = "vértice " + std::to_string(i) + " não é usado por nenhum triângulo";
+    }
+
+    if (!why.empty()) {
+        std::cerr << "ERRO: " << name << ": " << why << "\n";
+        return false;
+    }
+    std::cout << name << ": " << expanded.size() / 3 << " triângulos, " << expanded.size() << " cantos -> "
+              << mesh.vertices.size() << " vértices únicos\n";
+    return true;
+}
+
+int main(int argc, char** argv) {
+    bool failed = false;
+
+    if (argc > 1) {
+        for (int i = 1; i < argc; ++i) {
+            tinyobj::attrib_t attrib;
+            std::vector<tinyobj::shape_t> shapes;
+            std::vector<tinyobj::material_t> materials;
+            std::string warn, err;
+            std::string baseDir = std::filesystem::path(argv[i]).parent_path().string();
+            if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, argv[i], baseDir.empty() ? nullptr : baseDir.c_str())) {
+                std::cerr << "ERRO: " << argv[i] << ": " << err << "\n";
+                failed = true;
+                continue;
+            }
+            failed |= !checkMesh(argv[i], attrib, shapes);
+        }
+        return failed ? 1 : 0;
+    }
+
+    const std::vector<ObjCase> cases = {
+        { "cubo (normal por face)", cubeObj() },
+        { "grade suave 32x32", gridObj(32, false) },
+        { "grade facetada 32x32", gridObj(32, true) },
+        { "sem uv nem normal", "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf 1 2 3\nf 1 3 4\nf 3 2 1\n" },
+        { "uv sem normal e normal sem uv", "v 0 0 0\nv 1 0 0\nv 1 1 0\nvt 0 0\nvt 1 1\nvn 0 0 1\n"
+                                           "f 1/1 2/2 3/1\nf 1//1 2//1 3//1\nf 1/1 2/2 3/1\n" },
+        { "índices negativos", "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 1 1\n"
+                               "f -4/-3 -3/-2 -2/-1\nf 1/1 3/3 4/1\n" },
+        { "quadriláteros e dois shapes", "o A\nv 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvn 0 0 1\nf 1//1 2//1 3//1 4//1\n"
+                                         "o B\nv 0 0 1\nv 1 0 1\nv 1 1 1\nf 5//1 6//1 7//1\nf 1//1 2//1 6//1 5//1\n" },
+    };
+
+    for (const ObjCase& c : cases) {
+        tinyobj::attrib_t attrib;
+        std::vector<tinyobj::shape_t> shapes;
+        std::vector<tinyobj::material_t> materials;
+        std::string warn, err;
+        std::istringstream stream(c.source);
+        if (!tinyobj::LoadObj(&attrib, &shapes, &materials, &warn, &err, &stream)) {
+            std::cerr << "ERRO: " << c.name << ": " << err << "\n";
+            failed = true;
+            continue;
+        }
+        failed |= !checkMesh(c.name, attrib, shapes);
+    }
+
+    if (failed) return 1;
+    return 0;
+}
@@ -0,0 +1,206 @@
+// === objbench: vazão (MB/s) do ObjParser contra o TinyObjLoader ===
+// Uso: objbench [arquivo.obj ...] [--threads N] [--mb N]
+//   arquivo.obj  modelos a medir (sem arquivo, gera uma malha de scan sintética em objbench_sintetico.obj e
+//                uma grade com normal por face em objbench_facetado.obj)
+//   --threads N  threads do ObjParser (padrão: todos os núcleos)
+//   --mb N       tamanho aproximado da malha sintética em MB (padrão: 64)
+// Para cada arquivo confere se as duas leituras dão a mesma malha e o mesmo material; sai com código 1
+// se alguma divergir.
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+#include "mesh.h"
+#include "objparser.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Grade ondulada com ruído, como a superfície de um scan: v/vt/vn, quase tudo triângulo, uma faixa de
+// quadriláteros, um trecho com índices negativos e um .mtl com opções no map_Kd
+static bool writeSyntheticObj(const std::string& objPath, size_t targetBytes) {
+    std::string mtlPath = std::filesystem::path(objPath).replace_extension(".mtl").string();
+    FILE* mtl = std::fopen(mtlPath.c_str(), "w");
+    if (!mtl) return false;
+    std::fprintf(mtl, "# material de teste\nnewmtl Scan\nKa 0.1 0.1 0.1\nKs 0.5 0.5 0.5\nNs 48\n"
+                      "map_Kd -s 1 1 1 -bm 0.5 scan albedo.png\n\nnewmtl Outro\nKd 1 0 0\n");
+    std::fclose(mtl);
+
+    FILE* file = std::fopen(objPath.c_str(), "w");
+    if (!file) return false;
+    // ~150 bytes por vértice da grade (v + vt + vn + 2 faces)
+    size_t side = std::max<size_t>(8, static_cast<size_t>(std::sqrt(static_cast<double>(targetBytes) / 150.0)));
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> noise(-0.002f, 0.002f);
+    std::fprintf(file, "# malha sintética %zux%zu\nmtllib %s\no Scan\n", side, side,
+                 std::filesystem::path(mtlPath).filename().string().c_str());
+    for (size_t y = 0; y < side; ++y) {
+        for (size_t x = 0; x < side; ++x) {
+            float u = static_cast<float>(x) / (side - 1), v = static_cast<float>(y) / (side - 1);
+            float h = 0.05f * std::sin(u * 12.0f) * std::cos(v * 9.0f) + noise(rng);
+            std::fprintf(file, "v %.6f %.6f %.6f\nvt %.6f %.6f\n", u * 2.0f - 1.0f, h, v * 2.0f - 1.0f, u, v);
+            glm::vec3 n = glm::normalize(glm::vec3(-0.6f * std::cos(u * 12.0f) * std::cos(v * 9.0f), 1.0f,
+                                                   0.45f * std::sin(u * 12.0f) * std::sin(v * 9.0f)));
+            std::fprintf(file, "vn %.4f %.4f %.4f\n", n.x, n.y, n.z);
+        }
+    }
+    std::fprintf(file, "usemtl Scan\ns 1\n");
+    for (size_t y = 0; y + 1 < side; ++y) {
+        for (size_t x = 0; x + 1 < side; ++x) {
+            size_t a = y * side + x + 1, b = a + 1, c = a + side, d = c + 1;
+            if (y % 16 == 3) {
+                std::fprintf(file, "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n", a, a, a, b, b, b, d, d, d, c, c, c);
+            } else {
+                std::fprintf(file, "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n", a, a, a, b, b, b, d, d, d);
+                std::fprintf(file, "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n", a, a, a, d, d, d, c, c, c);
+            }
+        }
+    }
+    // Tampa com índices relativos (os últimos quatro vértices) e um canto só com posição e normal
+    std::fprintf(file, "g Tampa\nv 0 1 0\nv 1 1 0\nv 1 1 1\nv 0 1 1\nf -4 -3 -2 -1 # quad relativo\n");
+    std::fprintf(file, "f -4//1 -2//1 -1//1\n");
+    std::fclose(file);
+    return true;
+}
+
+// Grade com normal por face (sombreamento chapado): cada canto v/vt/vn é único por triângulo, então há
+// quase seis vezes mais vértices que posições, bem além da estimativa inicial da tabela de cantos
+static bool writeFlatObj(const std::string& objPath, size_t side) {
+    FILE* file = std::fopen(objPath.c_str(), "w");
+    if (!file) return false;
+    std::fprintf(file, "# grade facetada %zux%zu\no Facetado\n", side, side);
+    for (size_t y = 0; y < side; ++y) {
+        for (size_t x = 0; x < side; ++x) {
+            float u = static_cast<float>(x) / (side - 1), v = static_cast<float>(y) / (side - 1);
+            std::fprintf(file, "v %.6f %.6f %.6f\nvt %.6f %.6f\n", u * 2.0f - 1.0f, 0.1f * std::sin(u * 7.0f + v * 5.0f), v * 2.0f - 1.0f, u, v);
+        }
+    }
+    size_t normal = 0;
+    for (size_t y = 0; y + 1 < side; ++y) {
+        for (size_t x = 0; x + 1 < side; ++x) {
+            size_t a = y * side + x + 1, b = a + 1, c = a + side, d = c + 1;
+            for (int t = 0; t < 2; ++t) {
+                float tilt = 0.01f * static_cast<float>((x * 7 + y * 3 + t) % 13);
+                std::fprintf(file, "vn %.4f 1 %.4f\n", tilt, -tilt);
+                ++normal;
+                size_t second = t == 0 ? b : d, third = t == 0 ? d : c;
+                std::fprintf(file, "f %zu/%zu/%zu %zu/%zu/%zu %zu/%zu/%zu\n", a, a, normal, second, second, normal, third, third, normal);
+            }
+        }
+    }
+    std::fclose(file);
+    return true;
+}
+
+// Mesma malha: mesma ordem de vértices e índices, atributos iguais a menos de arredondamento de leitura
+static bool sameMesh(const MeshData& a, const MeshData& b, const MeshMaterial& ma, const MeshMaterial& mb, std::string& why) {
+    if (a.vertices.size() != b.vertices.size() || a.indices.size() != b.indices.size()) {
+        why = std::to_string(a.vertices.size()) + "/" + std::to_string(a.indices.size()) + " vértices/índices contra " +
+              std::to_string(b.vertices.size()) + "/" + std::to_string(b.indices.size());
+        return false;
+    }
+    if (a.indices != b.indices) {
+        why = "ordem dos índices diferente";
+        return false;
+    }
+    float maxDiff = 0.0f;
+    for (size_t i = 0; i < a.vertices.size(); ++i) {
+        const Vertex& va = a.vertices[i];
+        const Vertex& vb = b.vertices[i];
+        maxDiff = std::max({ maxDiff, glm::length(va.pos - vb.pos), glm::length(va.tex - vb.tex), glm::length(va.normal - vb.normal),
+                             glm::length(va.color - vb.color) });
+    }
+    if (maxDiff > 1e-6f) {
+        why = "atributos diferem em até " + std::to_string(maxDiff);
+        return false;
+    }
+    if (ma.present != mb.present || ma.ka != mb.ka || ma.kd != mb.kd || ma.ks != mb.ks || ma.shininess != mb.shininess ||
+        ma.diffuseTexname != mb.diffuseTexname) {
+        why = "material diferente ('" + ma.diffuseTexname + "' contra '" + mb.diffuseTexname + "')";
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    std::vector<std::string> files;
+    unsigned threads = 0;
+    size_t megabytes = 64;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        else if (arg == "--mb" && i + 1 < argc) megabytes = std::strtoul(argv[++i], nullptr, 10);
+        else files.push_back(arg);
+    }
+
+    if (files.empty()) {
+        files.push_back("objbench_sintetico.obj");
+        auto start = std::chrono::steady_clock::now();
+        if (!writeSyntheticObj(files[0], megabytes << 20)) {
+            std::cerr << "Não foi possível gravar " << files[0] << "\n";
+            return 1;
+        }
+        std::cout << "Malha sintética gerada em " << elapsedMs(start) << " ms: " << files[0] << "\n";
+
+        files.push_back("objbench_facetado.obj");
+        if (!writeFlatObj(files[1], 150)) {
+            std::cerr << "Não foi possível gravar " << files[1] << "\n";
+            return 1;
+        }
+    }
+
+    bool failed = false;
+    for (const std::string& path : files) {
+        MeshData reference, fast;
+        MeshMaterial referenceMaterial, fastMaterial;
+        std::string err;
+
+        auto start = std::chrono::steady_clock::now();
+        if (!loadObjMeshTinyObj(path, reference, referenceMaterial, err)) {
+            std::cerr << "[erro] TinyObjLoader: " << path << ": " << err << "\n";
+            failed = true;
+            continue;
+        }
+        double tinyMs = elapsedMs(start);
+
+        ObjParseStats stats;
+        start = std::chrono::steady_clock::now();
+        if (!loadObjMeshFast(path, fast, fastMaterial, err, &stats, threads)) {
+            std::cerr << "[erro] ObjParser: " << err << "\n";
+            failed = true;
+            continue;
+        }
+        double fastMs = elapsedMs(start);
+
+        double mb = stats.bytes / (1024.0 * 1024.0);
+        std::cout << path << ": " << mb << " MB, " << stats.positions << " posições, " << stats.faces << " faces, "
+                  << fast.vertices.size() << " vértices únicos\n";
+        std::cout << "  TinyObjLoader: " << tinyMs << " ms (" << mb / (tinyMs / 1000.0) << " MB/s)\n";
+        std::cout << "  ObjParser (" << stats.threads << " threads): " << fastMs << " ms (" << mb / (fastMs / 1000.0)
+                  << " MB/s, " << tinyMs / fastMs << "x) = leitura " << stats.parseMs << " + junção " << stats.mergeMs
+                  << " + índices " << stats.indexMs << " ms\n";
+
+        std::string why;
+        if (stats.largePolygons) {
+            // Polígonos com mais de 4 vértices: o TinyObjLoader usa ear clipping e o loadObjMesh volta a ele
+            std::cout << "  " << stats.largePolygons << " polígonos com mais de 4 vértices: loadObjMesh usa o TinyObjLoader\n";
+        } else if (!sameMesh(fast, reference, fastMaterial, referenceMaterial, why)) {
+            std::cerr << "ERRO: " << path << ": ObjParser difere do TinyObjLoader: " << why << "\n";
+            failed = true;
+        }
+    }
+
+    if (failed) return 1;
+    return 0;
+}
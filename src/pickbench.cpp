@@ -0,0 +1,115 @@
+// === pickbench: mede o ray picking com a BVH de triângulos (SAH) ===
+// Uso: pickbench [modelo.obj] [raios=10000]
+// Sem modelo, usa uma esfera sintética com ~1 milhão de triângulos.
+// Não abre janela nem usa OpenGL: só a GLM e o mesmo meshbvh.h do Cena_Castle.
+
+#define TINYOBJLOADER_IMPLEMENTATION
+#include "tiny_obj_loader.h"
+#include "mesh.h"
+#include "objparser.h"
+#include "meshbvh.h"
+
+#include <glm/gtc/constants.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Esfera UV de raio 1 com stacks x slices quadriláteros (2 triângulos cada)
+static void buildSphere(MeshData& mesh, uint32_t stacks, uint32_t slices) {
+    for (uint32_t i = 0; i <= stacks; ++i) {
+        float phi = glm::pi<float>() * i / stacks;
+        for (uint32_t j = 0; j <= slices; ++j) {
+            float theta = glm::two_pi<float>() * j / slices;
+            Vertex v{};
+            v.pos = glm::vec3(std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta));
+            v.normal = v.pos;
+            mesh.vertices.push_back(v);
+        }
+    }
+    for (uint32_t i = 0; i < stacks; ++i) {
+        for (uint32_t j = 0; j < slices; ++j) {
+            uint32_t a = i * (slices + 1) + j, b = a + slices + 1;
+            mesh.indices.insert(mesh.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    std::string objPath = argc > 1 ? argv[1] : "";
+    int rays = argc > 2 ? std::atoi(argv[2]) : 10000;
+    if (rays <= 0) {
+        std::cerr << "Uso: pickbench [modelo.obj] [raios]\n";
+        return 1;
+    }
+
+    MeshData mesh;
+    if (objPath.empty() || objPath == "-") {
+        buildSphere(mesh, 500, 1000);
+        objPath = "esfera sintética";
+    } else {
+        MeshMaterial material;
+        std::string error;
+        if (!loadObjMesh(objPath, mesh, material, error)) {
+            std::cerr << (error.empty() ? "Erro ao carregar " + objPath : error) << "\n";
+            return 1;
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    MeshBVH bvh;
+    bvh.build(&mesh.vertices[0].pos, sizeof(Vertex), mesh.indices.data(), sizeof(uint32_t), mesh.indices.size());
+    double buildMs = elapsedMs(start);
+
+    // Raios de fora da malha mirando pontos aleatórios dentro da caixa (como cliques na tela)
+    AABB box = bvh.bounds();
+    glm::vec3 center = box.center(), half = box.halfExtent();
+    float radius = glm::length(half) * 3.0f;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+    std::vector<glm::vec3> origins(rays), directions(rays);
+    for (int i = 0; i < rays; ++i) {
+        glm::vec3 eye = glm::normalize(glm::vec3(unit(rng), unit(rng), unit(rng)) + glm::vec3(1e-3f));
+        origins[i] = center + eye * radius;
+        glm::vec3 target = center + glm::vec3(unit(rng), unit(rng), unit(rng)) * half;
+        directions[i] = glm::normalize(target - origins[i]);
+    }
+
+    size_t hits = 0;
+    start = std::chrono::steady_clock::now();
+    std::vector<RayHit> results(rays);
+    for (int i = 0; i < rays; ++i) {
+        if (bvh.intersect(origins[i], directions[i], results[i])) ++hits;
+    }
+    double bvhMs = elapsedMs(start);
+
+    // Confere uma amostra contra a força bruta (mesmo triângulo ou mesma distância)
+    int checked = std::min(rays, 100), mismatches = 0;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < checked; ++i) {
+        RayHit reference;
+        bvh.intersectBruteForce(origins[i], directions[i], reference);
+        bool same = reference.triangle == results[i].triangle ||
+                    (reference.valid() && results[i].valid() && std::abs(reference.t - results[i].t) <= 1e-5f * reference.t);
+        if (!same) ++mismatches;
+    }
+    double bruteMs = elapsedMs(start);
+
+    std::cout << objPath << ": " << bvh.triangleCount() << " triângulos\n";
+    std::cout << "  build SAH: " << buildMs << " ms (" << bvh.nodeCount() << " nós, "
+              << bvh.memoryBytes() / (1024.0 * 1024.0) << " MiB)\n";
+    std::cout << "  BVH:         " << bvhMs * 1000.0 / rays << " us/raio (" << hits << " de " << rays << " acertaram)\n";
+    std::cout << "  força bruta: " << bruteMs * 1000.0 / checked << " us/raio (amostra de " << checked << ")\n";
+    if (mismatches) {
+        std::cerr << "ERRO: a BVH divergiu da força bruta em " << mismatches << " raios\n";
+        return 1;
+    }
+    return 0;
+}
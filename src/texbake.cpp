@@ -0,0 +1,149 @@
+// === texbake: pré-processa as texturas em .ktx2 comprimido (BC1/BC3/BC7 ou RGBA8) com todos os mipmaps ===
+// Uso: texbake [pasta ou imagem ...] [--format auto|bc1|bc3|bc7|rgba8] [--flip] [--force]
+//   sem caminhos  ../assets/tex (como os exercícios carregam) e ../assets/Modelos3D invertida (como o Cena_Castle)
+//   --format      auto (padrão): BC1 se a imagem é opaca, BC3 se tem alfa
+//   --flip        grava com as linhas de baixo para cima (stbi_set_flip_vertically_on_load)
+//   --force       regrava mesmo quando o cache já está atualizado
+// Só usa a CPU: roda em máquinas sem GPU. O cache gerado é o mesmo que os programas gravam na primeira carga.
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#include "texturebake.h"
+
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool isImage(const std::filesystem::path& path) {
+    std::string ext = path.extension().string();
+    for (char& c : ext) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return ext == ".png" || ext == ".jpg" || ext == ".jpeg" || ext == ".tga" || ext == ".bmp";
+}
+
+// PSNR (dB) do nível 0 descomprimido contra a imagem original
+static double psnr(const unsigned char* original, const BakedTexture& baked) {
+    std::vector<uint8_t> decoded;
+    if (!decompressLevel(baked.view().levels[0], baked.format, decoded)) return 0.0;
+    double sum = 0.0;
+    for (size_t i = 0; i < decoded.size(); ++i) {
+        double d = static_cast<double>(decoded[i]) - original[i];
+        sum += d * d;
+    }
+    double mse = sum / decoded.size();
+    return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+}
+
+struct Input {
+    std::filesystem::path path;
+    bool flipped;
+};
+
+int main(int argc, char** argv) {
+    std::vector<std::string> paths;
+    bool autoFormat = true, flip = false, force = false;
+    TextureFormat format = TextureFormat::BC1;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--flip") flip = true;
+        else if (arg == "--force") force = true;
+        else if (arg == "--format" && i + 1 < argc) {
+            std::string name = argv[++i];
+            autoFormat = name == "auto";
+            if (!autoFormat && !parseTextureFormat(name, format)) {
+                std::cerr << "Formato desconhecido: " << name << " (auto, bc1, bc3, bc7 ou rgba8)\n";
+                return 1;
+            }
+        } else {
+            paths.push_back(arg);
+        }
+    }
+
+    std::vector<Input> inputs;
+    auto addPath = [&](const std::filesystem::path& path, bool flipped) {
+        std::error_code ec;
+        if (std::filesystem::is_directory(path, ec)) {
+            for (const auto& entry : std::filesystem::directory_iterator(path))
+                if (entry.is_regular_file() && isImage(entry.path())) inputs.push_back({ entry.path(), flipped });
+        } else if (std::filesystem::is_regular_file(path, ec)) {
+            inputs.push_back({ path, flipped });
+        } else {
+            std::cerr << "Não encontrado: " << path.string() << "\n";
+        }
+    };
+    if (paths.empty()) {
+        addPath("../assets/tex", flip);
+        addPath("../assets/Modelos3D", true);
+    }
+    for (const std::string& path : paths) addPath(path, flip);
+    if (inputs.empty()) {
+        std::cerr << "Nenhuma imagem para processar\n";
+        return 1;
+    }
+
+    int baked = 0, skipped = 0, failed = 0;
+    size_t totalRgba = 0, totalBaked = 0;
+    for (const Input& input : inputs) {
+        std::string image = input.path.string();
+        std::string cachePath = bakedTexturePath(image);
+        std::string name = input.path.filename().string();
+
+        if (!force) {
+            Ktx2File existing;
+            if (existing.open(cachePath, image, input.flipped) && (autoFormat || existing.format() == format)) {
+                std::cout << "[ok]   " << name << " (cache atualizado, " << textureFormatName(existing.format()) << ")\n";
+                ++skipped;
+                continue;
+            }
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        stbi_set_flip_vertically_on_load(input.flipped);
+        int width, height, channels;
+        unsigned char* pixels = stbi_load(image.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+        if (!pixels) {
+            std::cerr << "[erro] " << name << ": não foi possível decodificar\n";
+            ++failed;
+            continue;
+        }
+        double decodeMs = elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        TextureFormat chosen = autoFormat ? chooseTextureFormat(pixels, static_cast<size_t>(width) * height) : format;
+        BakedTexture texture = bakeTexture(pixels, static_cast<uint32_t>(width), static_cast<uint32_t>(height), chosen, input.flipped);
+        double bakeMs = elapsedMs(start);
+        double quality = psnr(pixels, texture);
+        stbi_image_free(pixels);
+
+        if (!writeKtx2(cachePath, image, texture)) {
+            std::cerr << "[erro] não foi possível gravar " << cachePath << "\n";
+            ++failed;
+            continue;
+        }
+
+        // Memória de vídeo: RGBA8 com glGenerateMipmap contra a cadeia comprimida
+        size_t rgbaBytes = 0, bakedBytes = 0;
+        for (const TextureLevelView& level : texture.view().levels) {
+            rgbaBytes += textureLevelBytes(TextureFormat::RGBA8, level.width, level.height);
+            bakedBytes += level.size;
+        }
+        totalRgba += rgbaBytes;
+        totalBaked += bakedBytes;
+        std::cout << "[bake] " << name << ": " << width << "x" << height << " " << textureFormatName(chosen) << ", "
+                  << texture.levels.size() << " níveis, " << bakedBytes / 1024 << " KB (RGBA8: " << rgbaBytes / 1024 << " KB, "
+                  << static_cast<double>(rgbaBytes) / bakedBytes << "x), PSNR " << quality << " dB, decodificação "
+                  << decodeMs << " ms, compressão " << bakeMs << " ms\n";
+        ++baked;
+    }
+
+    std::cout << baked << " gerados, " << skipped << " atualizados, " << failed << " com erro";
+    if (totalBaked) std::cout << "; memória de vídeo " << totalRgba / 1024 << " KB -> " << totalBaked / 1024 << " KB";
+    std::cout << "\n";
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,193 @@
+// === trajbench: compara o sistema de trajetórias SoA (escalar, SSE, AVX) com o laço original ===
+// Uso: trajbench [movers=50000] [frames=600] [arquivo de trajetórias]
+// Sem arquivo, cada mover recebe um caminho aleatório de 4 a 8 pontos. Com arquivo (ex.:
+// ../Trajectories/trajectories2.txt), os movers percorrem as seções dele, começando em pontos diferentes.
+// Depois mede os caminhos curvos (Catmull-Rom e Bézier por comprimento de arco): tempo por frame e
+// quanto o deslocamento de cada frame se afasta de velocidade x dt.
+// Sai com código 1 se algum kernel divergir do laço original ou se a velocidade nas curvas não for constante.
+
+#include "trajectories.h"
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Laço original do Cena_Castle (array de structs), mantido como referência
+struct Trajectory {
+    std::vector<glm::vec3> controlPoints;
+    size_t currentIndex = 0;
+    float moveSpeed = 10.0f;
+    glm::vec3 currentPos = glm::vec3(0.0f);
+};
+
+static void updateOriginal(std::vector<Trajectory>& trajectories, float animationDelta) {
+    for (auto& traj : trajectories) {
+        if (traj.controlPoints.empty()) continue;
+        glm::vec3 target = traj.controlPoints[traj.currentIndex];
+        glm::vec3 direction = glm::normalize(target - traj.currentPos);
+        float distance = glm::distance(target, traj.currentPos);
+        float step = traj.moveSpeed * animationDelta;
+
+        if (step >= distance) {
+            traj.currentPos = target;
+            traj.currentIndex = (traj.currentIndex + 1) % traj.controlPoints.size();
+        } else {
+            traj.currentPos += direction * step;
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t moverCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    int frames = argc > 2 ? std::atoi(argv[2]) : 600;
+    if (moverCount == 0 || frames <= 0) {
+        std::cerr << "Uso: trajbench [movers] [frames] [arquivo de trajetórias]\n";
+        return 1;
+    }
+
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> speed(2.0f, 20.0f);
+    std::uniform_int_distribution<int> length(4, 8);
+
+    std::vector<std::vector<glm::vec3>> sections;
+    std::vector<TrajectoryPath> curveSections;
+    if (argc > 3) {
+        bool ok = false;
+        for (const TrajectoryPath& path : loadTrajectoryFile(argv[3], ok)) {
+            if (path.points.empty()) continue;
+            SplineCurve curve;
+            if (path.type == CurveType::Linear) sections.push_back(path.points);
+            else if (curve.build(path.points, path.type)) curveSections.push_back(path);
+            else std::cerr << "Curva com " << path.points.size() << " pontos ignorada\n";
+        }
+        if (!ok || (sections.empty() && curveSections.empty())) {
+            std::cerr << "Arquivo sem trajetórias: " << argv[3] << "\n";
+            return 1;
+        }
+    }
+
+    // Mesmos movers nas quatro versões; 1 em cada 16 fica parado (objeto sem trajetória)
+    std::vector<Trajectory> original(moverCount);
+    TrajectorySystem soa[3];
+    for (size_t i = 0; i < moverCount; ++i) {
+        Trajectory& traj = original[i];
+        glm::vec3 start(coord(rng), coord(rng), coord(rng));
+        if (i % 16 != 15) {
+            if (sections.empty()) {
+                int n = length(rng);
+                for (int k = 0; k < n; ++k) traj.controlPoints.emplace_back(coord(rng), coord(rng), coord(rng));
+            } else {
+                traj.controlPoints = sections[i % sections.size()];
+            }
+            traj.moveSpeed = speed(rng);
+        }
+        traj.currentPos = start;
+        for (auto& system : soa) system.add(start, traj.controlPoints, traj.moveSpeed);
+    }
+
+    const float dt = 1.0f / 60.0f;
+    const TrajectorySystem::Kernel kernels[3] = { TrajectorySystem::Kernel::Scalar, TrajectorySystem::Kernel::SSE, TrajectorySystem::Kernel::AVX };
+    TrajectorySystem::Kernel best = TrajectorySystem::bestKernel();
+    int kernelCount = best == TrajectorySystem::Kernel::AVX ? 3 : best == TrajectorySystem::Kernel::SSE ? 2 : 1;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f) updateOriginal(original, dt);
+    double originalMs = elapsedMs(start);
+
+    double kernelMs[3] = {};
+    for (int k = 0; k < kernelCount; ++k) {
+        start = std::chrono::steady_clock::now();
+        for (int f = 0; f < frames; ++f) soa[k].update(dt, kernels[k]);
+        kernelMs[k] = elapsedMs(start);
+    }
+
+    // Divergência: distância até a posição do laço original ao fim da simulação
+    bool failed = false;
+    std::cout << moverCount << " movers, " << frames << " frames (dt = 1/60 s)\n";
+    std::cout << "  laço original (AoS): " << originalMs / frames << " ms/frame\n";
+    for (int k = 0; k < kernelCount; ++k) {
+        float maxError = 0.0f;
+        size_t diverged = 0;
+        for (size_t i = 0; i < moverCount; ++i) {
+            float error = glm::length(soa[k].position(i) - original[i].currentPos);
+            maxError = std::max(maxError, error);
+            if (error > 1e-2f || soa[k].currentIndex(i) != original[i].currentIndex) ++diverged;
+        }
+        std::cout << "  SoA " << TrajectorySystem::kernelName(kernels[k]) << ": " << kernelMs[k] / frames << " ms/frame ("
+                  << originalMs / kernelMs[k] << "x), erro máximo " << maxError << ", divergentes " << diverged << "\n";
+        // O escalar faz as mesmas contas do original e tem que bater sempre. Nos SIMD (passo² e rsqrt)
+        // o arredondamento pode adiantar ou atrasar uma chegada em um frame; mais que 0,1% é erro
+        size_t allowed = kernels[k] == TrajectorySystem::Kernel::Scalar ? 0 : moverCount / 1000;
+        if (diverged > allowed) {
+            std::cerr << "ERRO: o kernel " << TrajectorySystem::kernelName(kernels[k]) << " divergiu do laço original\n";
+            failed = true;
+        }
+    }
+
+    // Curvas: metade Catmull-Rom (4 a 8 pontos), metade Bézier (2 ou 3 segmentos), ou as do arquivo
+    TrajectorySystem curves;
+    std::vector<SplineCurve> references(moverCount);
+    std::vector<float> curveSpeeds(moverCount);
+    for (size_t i = 0; i < moverCount; ++i) {
+        TrajectoryPath path;
+        if (!curveSections.empty()) {
+            path = curveSections[i % curveSections.size()];
+        } else {
+            path.type = i % 2 ? CurveType::Bezier : CurveType::CatmullRom;
+            int n = path.type == CurveType::Bezier ? 3 * (2 + i / 2 % 2) : length(rng);
+            for (int k = 0; k < n; ++k) path.points.emplace_back(coord(rng), coord(rng), coord(rng));
+        }
+        curveSpeeds[i] = speed(rng);
+        curves.add(glm::vec3(0.0f), path, curveSpeeds[i]);
+        references[i].build(path.points, path.type);
+    }
+
+    start = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f) curves.update(dt);
+    double curveMs = elapsedMs(start);
+
+    // Deriva: a posição depois de todos os frames tem que ser a da curva na distância velocidade x tempo
+    float maxDrift = 0.0f;
+    double elapsed = 0.0;
+    for (int f = 0; f < frames; ++f) elapsed += dt;
+    for (size_t i = 0; i < moverCount; ++i) {
+        float distance = (float)std::fmod(curveSpeeds[i] * elapsed, (double)references[i].length());
+        maxDrift = std::max(maxDrift, glm::length(curves.position(i) - references[i].sample(distance)));
+    }
+
+    // Velocidade constante: o arco entre s e s + um passo de frame (medido com 16 subdivisões) tem que
+    // ter o comprimento do passo. Perto de cúspides o erro sobe; mais de 1% no percentil 99 é tabela errada.
+    std::vector<float> deviations;
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    for (size_t i = 0; i < std::min<size_t>(moverCount, 2000); ++i) {
+        const SplineCurve& curve = references[i];
+        float step = curveSpeeds[i] * dt;
+        for (int k = 0; k < 20; ++k) {
+            float s = unit(rng) * curve.length(), arc = 0.0f;
+            for (int j = 0; j < 16; ++j) arc += glm::length(curve.sample(s + step * (j + 1) / 16) - curve.sample(s + step * j / 16));
+            deviations.push_back(std::abs(arc - step) / step);
+        }
+    }
+    std::sort(deviations.begin(), deviations.end());
+    float p99 = deviations[deviations.size() * 99 / 100];
+    std::cout << "  curvas (" << curves.curveCount() << " por comprimento de arco): " << curveMs / frames
+              << " ms/frame, deriva " << maxDrift << ", desvio da velocidade p99 " << p99 * 100.0f << "%, máx "
+              << deviations.back() * 100.0f << "%\n";
+    if (maxDrift > 1e-3f || p99 > 0.01f) {
+        std::cerr << "ERRO: as curvas não andam com velocidade constante\n";
+        failed = true;
+    }
+
+    if (failed) return 1;
+    return 0;
+}
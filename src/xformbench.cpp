@@ -0,0 +1,169 @@
+// === xformbench: compara as matrizes modelo/normal em lote (escalar, SSE, AVX2) com o caminho glm ===
+// Uso: xformbench [frames=100]
+// Para 1k, 10k e 100k objetos com rotação e posição aleatórias, mede o caminho original do Cena_Castle
+// (translate, três rotate, scale e transpose(inverse(mat3)) por objeto) e cada kernel do TransformBatch,
+// com escala uniforme e com escala por eixo. Depois confere o SceneGraph (com hierarquia e com só parte
+// dos nós sujos) contra a mesma composição em glm.
+// Sai com código 1 se alguma matriz se afastar da do glm.
+
+#include "scenegraph.h"
+#include "transformbatch.h"
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Caminho original, objeto a objeto
+static void composeGlm(const glm::vec3& translation, const glm::vec3& rotation, const glm::vec3& scale, glm::mat4& model, glm::mat3& normal) {
+    model = glm::translate(glm::mat4(1.0f), translation);
+    model = glm::rotate(model, rotation.x, glm::vec3(1, 0, 0));
+    model = glm::rotate(model, rotation.y, glm::vec3(0, 1, 0));
+    model = glm::rotate(model, rotation.z, glm::vec3(0, 0, 1));
+    model = glm::scale(model, scale);
+    normal = glm::transpose(glm::inverse(glm::mat3(model)));
+}
+
+// Erro relativo ao maior elemento da coluna, para não punir escalas grandes
+static float matrixError(const glm::mat4& a, const glm::mat4& b) {
+    float error = 0.0f;
+    for (int c = 0; c < 4; ++c) {
+        float magnitude = std::max(1.0f, glm::length(b[c]));
+        for (int r = 0; r < 4; ++r) error = std::max(error, std::abs(a[c][r] - b[c][r]) / magnitude);
+    }
+    return error;
+}
+
+static float matrixError(const glm::mat3& a, const glm::mat3& b) {
+    return matrixError(glm::mat4(a), glm::mat4(b));
+}
+
+int main(int argc, char** argv) {
+    int frames = argc > 1 ? std::atoi(argv[1]) : 100;
+    if (frames <= 0) {
+        std::cerr << "Uso: xformbench [frames]\n";
+        return 1;
+    }
+
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> coord(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> angle(-20.0f, 20.0f);
+    std::uniform_real_distribution<float> scale(0.1f, 8.0f);
+
+    const TransformBatch::Kernel kernels[3] = { TransformBatch::Kernel::Scalar, TransformBatch::Kernel::SSE, TransformBatch::Kernel::AVX2 };
+    TransformBatch::Kernel best = TransformBatch::bestKernel();
+    int kernelCount = best == TransformBatch::Kernel::AVX2 ? 3 : best == TransformBatch::Kernel::SSE ? 2 : 1;
+    const float tolerance = 1e-4f;
+    bool failed = false;
+
+    for (size_t count : { (size_t)1000, (size_t)10000, (size_t)100000 }) {
+        for (bool uniform : { true, false }) {
+            std::vector<glm::vec3> translations(count), rotations(count), scales(count);
+            TransformBatch batch;
+            for (size_t i = 0; i < count; ++i) {
+                translations[i] = glm::vec3(coord(rng), coord(rng), coord(rng));
+                rotations[i] = glm::vec3(angle(rng), angle(rng), angle(rng));
+                float s = scale(rng);
+                scales[i] = uniform ? glm::vec3(s) : glm::vec3(s, scale(rng), scale(rng));
+                batch.push_back(translations[i], rotations[i], scales[i]);
+            }
+
+            std::vector<glm::mat4> glmModels(count);
+            std::vector<glm::mat3> glmNormals(count);
+            auto start = std::chrono::steady_clock::now();
+            for (int f = 0; f < frames; ++f)
+                for (size_t i = 0; i < count; ++i) composeGlm(translations[i], rotations[i], scales[i], glmModels[i], glmNormals[i]);
+            double glmMs = elapsedMs(start) / frames;
+
+            std::cout << count << " objetos, escala " << (uniform ? "uniforme" : "por eixo") << " (" << frames << " frames)\n";
+            std::cout << "  glm (objeto a objeto): " << glmMs << " ms/frame\n";
+            for (int k = 0; k < kernelCount; ++k) {
+                std::vector<glm::mat4> models(count);
+                std::vector<glm::mat3> normals(count);
+                start = std::chrono::steady_clock::now();
+                for (int f = 0; f < frames; ++f) batch.compose(0, count, models.data(), normals.data(), kernels[k]);
+                double ms = elapsedMs(start) / frames;
+
+                float modelError = 0.0f, normalError = 0.0f;
+                for (size_t i = 0; i < count; ++i) {
+                    modelError = std::max(modelError, matrixError(models[i], glmModels[i]));
+                    normalError = std::max(normalError, matrixError(normals[i], glmNormals[i]));
+                }
+                std::cout << "  lote " << TransformBatch::kernelName(kernels[k]) << ": " << ms << " ms/frame (" << glmMs / ms
+                          << "x), erro máximo modelo " << modelError << ", normal " << normalError << "\n";
+                if (modelError > tolerance || normalError > tolerance) {
+                    std::cerr << "ERRO: o kernel " << TransformBatch::kernelName(kernels[k]) << " divergiu do glm\n";
+                    failed = true;
+                }
+            }
+
+            // Intervalo que não começa nem termina em bloco: cauda escalar e último objeto sem estouro
+            size_t first = 3, partial = count - 8;
+            std::vector<glm::mat4> models(partial + 1, glm::mat4(-7.0f));
+            std::vector<glm::mat3> normals(partial + 1, glm::mat3(-7.0f));
+            batch.compose(first, partial, models.data(), normals.data());
+            float partialError = 0.0f;
+            for (size_t k = 0; k < partial; ++k) {
+                partialError = std::max(partialError, matrixError(models[k], glmModels[first + k]));
+                partialError = std::max(partialError, matrixError(normals[k], glmNormals[first + k]));
+            }
+            if (partialError > tolerance || models[partial] != glm::mat4(-7.0f) || normals[partial] != glm::mat3(-7.0f)) {
+                std::cerr << "ERRO: compose de um intervalo parcial escreveu errado ou fora do intervalo\n";
+                failed = true;
+            }
+        }
+    }
+
+    // SceneGraph: cada nó com 1/4 de chance de ser filho de um anterior; mundo = pai x local em glm
+    size_t nodeCount = 20000;
+    SceneGraph graph;
+    std::vector<uint32_t> parents(nodeCount);
+    std::vector<glm::vec3> translations(nodeCount), rotations(nodeCount);
+    std::vector<float> scales(nodeCount);
+    for (size_t i = 0; i < nodeCount; ++i) {
+        parents[i] = i > 0 && rng() % 4 == 0 ? (uint32_t)(rng() % i) : SceneGraph::NO_PARENT;
+        graph.add(parents[i]);
+    }
+    float graphError = 0.0f;
+    for (int pass = 0; pass < 3; ++pass) {
+        // Primeira passada: todos os nós; depois só alguns, para o caminho de coleta dos sujos
+        for (size_t i = 0; i < nodeCount; ++i) {
+            if (pass > 0 && rng() % 50 != 0) continue;
+            translations[i] = glm::vec3(coord(rng), coord(rng), coord(rng)) * 0.01f;
+            rotations[i] = glm::vec3(angle(rng), angle(rng), angle(rng));
+            scales[i] = std::uniform_real_distribution<float>(0.5f, 2.0f)(rng);
+            graph.setTranslation((uint32_t)i, translations[i]);
+            graph.setRotation((uint32_t)i, rotations[i]);
+            graph.setScale((uint32_t)i, scales[i]);
+        }
+        graph.update();
+
+        std::vector<glm::mat4> worlds(nodeCount);
+        for (size_t i = 0; i < nodeCount; ++i) {
+            glm::mat4 local;
+            glm::mat3 unused;
+            composeGlm(translations[i], rotations[i], glm::vec3(scales[i]), local, unused);
+            worlds[i] = parents[i] == SceneGraph::NO_PARENT ? local : worlds[parents[i]] * local;
+            graphError = std::max(graphError, matrixError(graph.world((uint32_t)i), worlds[i]));
+            graphError = std::max(graphError, matrixError(graph.normal((uint32_t)i), glm::transpose(glm::inverse(glm::mat3(worlds[i])))));
+        }
+    }
+    std::cout << "SceneGraph (" << nodeCount << " nós com hierarquia): erro máximo " << graphError << "\n";
+    if (graphError > 1e-3f) {
+        std::cerr << "ERRO: o grafo de cena divergiu da composição em glm\n";
+        failed = true;
+    }
+
+    if (failed) return 1;
+    return 0;
+}